@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+#include "AllocationCounter.h"
+#include "Trace.h"
+
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+BenchmarkResult runBenchmark(const BenchmarkScene& scene, const std::string& param, const BenchmarkSettings& settings)
+{
+	BenchmarkResult result;
+	result.scene = scene.name;
+	result.param = param.empty() ? scene.defaultParam : param;
+
+	physics::PhysicsScene physicsScene(settings.timeStep);
+	physicsScene.setWorkerCount(settings.workers);
+	scene.build(&physicsScene, result.param);
+
+	for (size_t i = 0; i < settings.warmupSteps; ++i) {
+		physicsScene.update(settings.timeStep);
+	}
+	if (scene.start != nullptr) {
+		scene.start(&physicsScene);
+	}
+	physicsScene.getBroadphase()->resetStats();
+
+	typedef std::chrono::steady_clock Clock;
+	size_t allocationsBefore = getAllocationCount();
+	Clock::time_point start = Clock::now();
+	{
+		PHYSICS_TRACE_SCOPE(scene.name, "Benchmark");
+		for (size_t i = 0; i < settings.steps; ++i) {
+			physicsScene.update(settings.timeStep);
+		}
+	}
+	Clock::time_point end = Clock::now();
+	result.allocations = getAllocationCount() - allocationsBefore;
+
+	result.bodies = physicsScene.getBodyStore().size();
+	result.steps = settings.steps;
+	result.seconds = std::chrono::duration<double>(end - start).count();
+	result.stepsPerSecond = result.seconds > 0 ? result.steps / result.seconds : 0;
+	result.nsPerBody = result.steps > 0 && result.bodies > 0 ? result.seconds * 1e9 / (result.steps * result.bodies) : 0;
+	result.pairsPerStep = result.steps > 0 ? (double)physicsScene.getBroadphaseStats().totalCandidatePairs / result.steps : 0;
+	result.allocationsPerStep = result.steps > 0 ? (double)result.allocations / result.steps : 0;
+	return result;
+}
+
+static const char* const k_header = "scene,param,bodies,steps,seconds,steps_per_sec,ns_per_body,pairs_per_step,allocations,allocations_per_step";
+
+void writeResults(std::ostream& stream, const std::vector<BenchmarkResult>& results)
+{
+	stream << k_header << '\n';
+	for (const BenchmarkResult& result : results) {
+		stream << result.scene << ',' << result.param << ',' << result.bodies << ',' << result.steps << ','
+			<< result.seconds << ',' << result.stepsPerSecond << ',' << result.nsPerBody << ','
+			<< result.pairsPerStep << ',' << result.allocations << ',' << result.allocationsPerStep << '\n';
+	}
+}
+
+std::vector<BenchmarkResult> readResults(std::istream& stream)
+{
+	std::string line;
+	if (!std::getline(stream, line) || line != k_header) {
+		throw std::invalid_argument("Results don't start with expected header");
+	}
+	std::vector<BenchmarkResult> results;
+	while (std::getline(stream, line)) {
+		if (line.empty()) {
+			continue;
+		}
+		std::istringstream fields(line);
+		BenchmarkResult result;
+		char comma[8] = {};
+		std::getline(fields, result.scene, ',');
+		std::getline(fields, result.param, ',');
+		fields >> result.bodies >> comma[0] >> result.steps >> comma[1] >> result.seconds >> comma[2]
+			>> result.stepsPerSecond >> comma[3] >> result.nsPerBody >> comma[4] >> result.pairsPerStep >> comma[5]
+			>> result.allocations >> comma[6] >> result.allocationsPerStep;
+		if (!fields || std::string(comma) != ",,,,,,,") {
+			throw std::invalid_argument("Malformed result line \"" + line + "\"");
+		}
+		results.push_back(result);
+	}
+	return results;
+}
+
+std::vector<BenchmarkRegression> findRegressions(const std::vector<BenchmarkResult>& baseline,
+	const std::vector<BenchmarkResult>& results, double threshold)
+{
+	std::vector<BenchmarkRegression> regressions;
+	for (const BenchmarkResult& result : results) {
+		for (const BenchmarkResult& base : baseline) {
+			if (base.scene != result.scene || base.param != result.param) {
+				continue;
+			}
+			if (result.stepsPerSecond < base.stepsPerSecond * (1 - threshold)) {
+				regressions.push_back({ result.scene, result.param, "steps_per_sec", base.stepsPerSecond, result.stepsPerSecond });
+			}
+			if (result.allocationsPerStep > base.allocationsPerStep * (1 + threshold)) {
+				regressions.push_back({ result.scene, result.param, "allocations_per_step", base.allocationsPerStep, result.allocationsPerStep });
+			}
+			break;
+		}
+	}
+	return regressions;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "BenchmarkScenes.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Measurements from stepping one scene
+struct BenchmarkResult {
+	std::string scene;
+	std::string param;
+	size_t bodies;				// Rigid bodies in scene after warmup
+	size_t steps;				// Steps timed
+	double seconds;				// Time taken by timed steps
+	double stepsPerSecond;
+	double nsPerBody;			// Time per step divided among bodies
+	double pairsPerStep;		// Broadphase candidate pairs per step
+	size_t allocations;			// Calls to operator new during timed steps
+	double allocationsPerStep;
+};
+
+struct BenchmarkSettings {
+	BenchmarkSettings() : warmupSteps(60), steps(600), workers(0), timeStep(0.01f) {}
+
+	size_t warmupSteps;			// Steps run before timing, letting scene settle and pools fill
+	size_t steps;
+	size_t workers;				// Worker threads for scene's job system
+	float timeStep;
+};
+
+// A result which got worse than its baseline by more than the threshold
+struct BenchmarkRegression {
+	std::string scene;
+	std::string param;
+	std::string measure;
+	double baseline;
+	double value;
+};
+
+// Builds scene with given parameter, or its default if empty, then steps it and measures it
+BenchmarkResult runBenchmark(const BenchmarkScene& scene, const std::string& param, const BenchmarkSettings& settings);
+
+// Writes results as CSV, one line per result after a header
+void writeResults(std::ostream& stream, const std::vector<BenchmarkResult>& results);
+
+// Reads results written by writeResults, throwing std::invalid_argument if they are malformed
+std::vector<BenchmarkResult> readResults(std::istream& stream);
+
+// Compares results against baseline results of same scene and parameter
+// Steps per second falling or allocations per step rising by more than threshold, as a fraction, is a regression
+// Results without a baseline are ignored
+std::vector<BenchmarkRegression> findRegressions(const std::vector<BenchmarkResult>& baseline,
+	const std::vector<BenchmarkResult>& results, double threshold);
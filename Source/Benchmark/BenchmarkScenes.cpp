@@ -0,0 +1,310 @@
+#include "BenchmarkScenes.h"
+
+#include "Sphere.h"
+#include "Box.h"
+#include "Plane.h"
+#include "Spring.h"
+#include "SoftBody.h"
+#include "Rope.h"
+#include "IFixedUpdater.h"
+#include "Joint.h"
+
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+using namespace physics;
+
+// Reads parameter holding a single positive count
+static size_t parseCount(const std::string& param)
+{
+	std::istringstream stream(param);
+	size_t count = 0;
+	if (!(stream >> count) || !stream.eof() || count == 0) {
+		throw std::invalid_argument("Expected a positive count, not \"" + param + "\"");
+	}
+	return count;
+}
+
+// Reads parameter of form RxC
+static void parseGrid(const std::string& param, size_t& rows, size_t& cols)
+{
+	std::istringstream stream(param);
+	char separator = 0;
+	if (!(stream >> rows >> separator >> cols) || !stream.eof() || separator != 'x' || rows == 0 || cols == 0) {
+		throw std::invalid_argument("Expected rows and columns as RxC, not \"" + param + "\"");
+	}
+}
+
+static void requireNoParam(const std::string& param)
+{
+	if (!param.empty()) {
+		throw std::invalid_argument("Scene takes no parameter");
+	}
+}
+
+// N spheres bouncing around a box, starting on a grid with random velocities
+static void buildSpheres(PhysicsScene* scene, const std::string& param)
+{
+	size_t count = parseCount(param);
+	size_t cols = (size_t)std::ceil(std::sqrt((float)count));
+	const float spacing = 3.f;
+	float halfWidth = 0.5f * spacing * (cols + 1);
+	scene->addActor(new Plane({ 0,1 }, halfWidth, 0.9f));
+	scene->addActor(new Plane({ 0,-1 }, halfWidth, 0.9f));
+	scene->addActor(new Plane({ 1,0 }, halfWidth, 0.9f));
+	scene->addActor(new Plane({ -1,0 }, halfWidth, 0.9f));
+
+	// Fixed seed, so every run steps the same scene
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> speed(-10.f, 10.f);
+	std::vector<PhysicsObjectPtr> spheres;
+	for (size_t i = 0; i < count; ++i) {
+		glm::vec2 position = { (i % cols) * spacing, (i / cols) * spacing };
+		position -= glm::vec2(halfWidth - spacing);
+		glm::vec2 velocity = { speed(random), speed(random) };
+		spheres.push_back(scene->getPools().spheres.create(position, 1.f, velocity, 0.f, 1.f, 0.9f, 0.1f));
+	}
+	scene->addActors(spheres);
+}
+
+// N boxes in stacks of ten, settling on the ground
+static void buildBoxStacks(PhysicsScene* scene, const std::string& param)
+{
+	const size_t stackHeight = 10;
+	const float size = 2.f;
+	size_t count = parseCount(param);
+	scene->addActor(new Plane({ 0,1 }, 0, 0, 0.5f));
+	// Settled stacks would otherwise fall asleep during warm-up, leaving no contacts to time
+	scene->setSleepingEnabled(false);
+
+	std::vector<PhysicsObjectPtr> boxes;
+	for (size_t i = 0; i < count; ++i) {
+		glm::vec2 position = { (i / stackHeight) * 2.f * size, (i % stackHeight + 0.5f) * size };
+		boxes.push_back(scene->getPools().boxes.create(position, size, size, 0.f, glm::vec2(0, 0), 0.f, 1.f, 0.f, 0.5f));
+	}
+	scene->addActors(boxes);
+}
+
+// RxC soft body of spheres dropped on the ground
+static void buildSoftBody(PhysicsScene* scene, const std::string& param)
+{
+	size_t rows, cols;
+	parseGrid(param, rows, cols);
+	scene->addActor(new Plane({ 0,1 }, 0, 0.5f, 0.3f));
+
+	Sphere particle({ 0,0 }, 0.4f, { 0,0 }, 0, 0.2f, 0.5f, 0.3f);
+	SoftBody body({ 0,5 }, &particle, cols, rows, 1.f, 50.f, 25.f, 10.f, 0.5f, { 1,1,1,1 }, &scene->getPools());
+	body.addToScene(scene);
+}
+
+// Rope of N segments pinned at one end, swinging down from horizontal onto the ground
+static void buildRope(PhysicsScene* scene, const std::string& param)
+{
+	size_t segments = parseCount(param);
+	const float distance = 0.8f;
+	// Ground a tenth of the rope's length below the pin, so most of the rope swings into it and drags along it
+	scene->addActor(new Plane({ 0,1 }, 0.1f * distance * segments, 0.5f, 0.5f));
+
+	Sphere particle({ 0,0 }, 0.3f, { 0,0 }, 0, 0.1f, 0.5f, 0.1f);
+	Rope rope({ 0,0 }, &particle, segments, distance, 100.f, 1.f, &scene->getPools());
+	rope.getSegments().front()->setStatic(true);
+	rope.addToScene(scene);
+}
+
+// Pool table racked as in the pool game, with the cue ball added last, ready to be struck
+static void buildPoolBreak(PhysicsScene* scene, const std::string& param)
+{
+	requireNoParam(param);
+	const float tableWidth = 160;
+	const float tableHeight = 80;
+	const float railWidth = 8;
+	const float railElasticity = 1;
+	const float railFriction = 0.3f;
+	const float pocketWidth = 8;
+	const float ballRadius = 2;
+	scene->setGravity({ 0,0 });
+
+	scene->addActor(new Plane({ 1,0 }, 0.5f * tableWidth + railWidth, railElasticity, railFriction));
+	scene->addActor(new Plane({ -1,0 }, 0.5f * tableWidth + railWidth, railElasticity, railFriction));
+	scene->addActor(new Plane({ 0,1 }, 0.5f * tableHeight + railWidth, railElasticity, railFriction));
+	scene->addActor(new Plane({ 0,-1 }, 0.5f * tableHeight + railWidth, railElasticity, railFriction));
+
+	const float topRailLength = 0.5f * (tableWidth - pocketWidth - glm::root_two<float>() * pocketWidth);
+	const float sideRailLength = tableHeight - glm::root_two<float>() * pocketWidth;
+	const float topRailX = 0.5f * (topRailLength + pocketWidth);
+	Box rail({ 0,0 }, topRailLength, railWidth, 0, { 0,0 }, 0, INFINITY, railElasticity, railFriction);
+	rail.setStatic(true);
+	for (float x : { topRailX, -topRailX }) {
+		for (float y : { 0.5f * (tableHeight + railWidth), -0.5f * (tableHeight + railWidth) }) {
+			rail.setPosition({ x, y });
+			scene->addActor(rail.clone());
+		}
+	}
+	rail.setHeight(sideRailLength);
+	rail.setWidth(railWidth);
+	for (float x : { 0.5f * (tableWidth + railWidth), -0.5f * (tableWidth + railWidth) }) {
+		rail.setPosition({ x, 0 });
+		scene->addActor(rail.clone());
+	}
+
+	Box pocket({ 0,0 }, pocketWidth, pocketWidth, 0);
+	pocket.setStatic(true);
+	pocket.setTrigger(true);
+	pocket.setPosition({ 0, 0.5f * (tableHeight + pocketWidth) });
+	scene->addActor(pocket.clone());
+	pocket.setPosition({ 0, -0.5f * (tableHeight + pocketWidth) });
+	scene->addActor(pocket.clone());
+	pocket.setOrientation(glm::quarter_pi<float>());
+	pocket.setPosition({ -0.5f * tableWidth, 0.5f * tableHeight });
+	scene->addActor(pocket.clone());
+	pocket.setPosition({ 0.5f * tableWidth, -0.5f * tableHeight });
+	scene->addActor(pocket.clone());
+	pocket.setOrientation(-glm::quarter_pi<float>());
+	pocket.setPosition({ 0.5f * tableWidth, 0.5f * tableHeight });
+	scene->addActor(pocket.clone());
+	pocket.setPosition({ -0.5f * tableWidth, -0.5f * tableHeight });
+	scene->addActor(pocket.clone());
+
+	// Fifteen balls in a triangle pointing at the cue ball
+	const float sixtyDegrees = glm::third<float>() * glm::pi<float>();
+	const float spacing = ballRadius * 2.f + 0.001f;
+	glm::vec2 diagonal = { -sinf(sixtyDegrees), cosf(sixtyDegrees) };
+	glm::vec2 footPosition = { -0.25f * tableWidth, 0 };
+	for (int row = 0; row < 5; ++row) {
+		for (int place = 0; place <= row; ++place) {
+			glm::vec2 position = footPosition + row * spacing * diagonal + place * spacing * glm::vec2(0, -1);
+			scene->addActor(scene->getPools().spheres.create(position, ballRadius, glm::vec2(0, 0), 0.f, 1.6f, 1.f, 0.2f, 1.f, 0.5f));
+		}
+	}
+	std::shared_ptr<Sphere> cueBall = scene->getPools().spheres.create(glm::vec2(0.25f * tableWidth, 0), ballRadius, glm::vec2(0, 0), 0.f, 1.7f, 1.f, 0.2f, 1.7f / 1.6f, 0.5f * 1.7f / 1.6f);
+	scene->addActor(cueBall);
+}
+
+// Drives cue ball into the rack at full strength, so the break happens in the timed steps
+static void startPoolBreak(PhysicsScene* scene)
+{
+	const float cueForce = 300;
+	RigidBodyPtr cueBall = std::dynamic_pointer_cast<RigidBody>(scene->getActors().back());
+	cueBall->applyImpulse({ -cueForce, 0 });
+}
+
+// Pushes a body along with a constant force each step
+class ConstantPush : public IFixedUpdater {
+public:
+	ConstantPush(RigidBodyPtr body, glm::vec2 force) : m_body(body), m_force(force) {}
+
+	virtual void fixedUpdate(PhysicsScene*) { m_body->applyForce(m_force); }
+
+protected:
+	RigidBodyPtr m_body;
+	glm::vec2 m_force;
+};
+
+// Slug demo's course, with the slug's body and head pushed forwards through it
+static void buildSlugCourse(PhysicsScene* scene, const std::string& param)
+{
+	requireNoParam(param);
+	const size_t bodyCols = 8;
+	const size_t bodyRows = 4;
+	const float particleDistance = 2.f;
+	const float particleRadius = 1.f;
+	const float headRadius = 1.5f;
+	const float headDistance = 3.f;
+	const float tightness = 10.f;
+	const float damping = 0.1f;
+	const float elasticity = 0.8f;
+	const float friction = 0.1f;
+	const float boxElasticity = 0.5f;
+	const float boxFriction = 0.2f;
+	const glm::vec2 start = { -40,-20 };
+
+	scene->addActor(new Plane({ 0,1 }, 25));
+
+	Sphere particle({ 0,0 }, particleRadius, { 0,0 }, 0, 0.2f, elasticity, friction, 0.2f, 0.f, { 1,1,1,1 }, false);
+	SoftBody body(start, &particle, bodyCols, bodyRows, particleDistance, tightness, tightness * 0.5f, tightness * 0.2f, damping, { 1,1,1,1 }, &scene->getPools());
+	body.setSelfCollision(false);
+	glm::vec2 headPos = { particleDistance * (bodyCols - 1) + headDistance, (particleDistance * 0.5f * bodyRows) - particleRadius };
+	std::shared_ptr<Sphere> head(new Sphere(headPos + start, headRadius, { 0,0 }, 0, 0.5f, elasticity, friction, 0.5f, 0.f, { 1,1,1,1 }, false));
+	std::vector<PhysicsObjectPtr> actors;
+	body.getActors(actors);
+	actors.push_back(head);
+	for (RigidBodyPtr bodyPart : body.getParticles()[bodyCols - 1]) {
+		glm::vec2 displacement = bodyPart->getPosition() - head->getPosition();
+		glm::vec2 direction = glm::normalize(displacement);
+		float distance = glm::length(displacement);
+		SpringPtr spring(new Spring(tightness, std::max(0.f, distance - headRadius - particleRadius), damping, head, bodyPart, direction * headRadius, -direction * particleRadius));
+		spring->setCollideConnected(false);
+		actors.push_back(spring);
+	}
+	scene->addActors(actors);
+	scene->addUpdater(FixedUpdaterPtr(new ConstantPush(head, { 40,0 })));
+
+	// Walls, then rotating mangles, then slopes and roof, as laid out in the demo
+	Box wall({ -10,1 }, 20, 40, 0, { 0,0 }, 0, INFINITY, boxElasticity, boxFriction);
+	wall.setStatic(true);
+	scene->addActor(wall.clone());
+	wall.setHeight(7);
+	wall.setWidth(10);
+	wall.setPosition({ 30, -21.5f });
+	scene->addActor(wall.clone());
+	wall.setHeight(4);
+	wall.setWidth(20);
+	wall.setPosition({ 70, -23.f });
+	scene->addActor(wall.clone());
+	wall.setHeight(40);
+	wall.setPosition({ 80, 8.f });
+	scene->addActor(wall.clone());
+
+	wall.setHeight(2);
+	wall.setWidth(15);
+	wall.setStatic(false);
+	wall.setAngularVelocity(-0.8f);
+	for (glm::vec2 position : { glm::vec2(100, -25), glm::vec2(120, -15), glm::vec2(120, 5), glm::vec2(120, 25) }) {
+		wall.setPosition(position);
+		scene->addActor(wall.clone());
+	}
+	wall.setAngularVelocity(0.8f);
+	for (glm::vec2 position : { glm::vec2(100, -5), glm::vec2(100, 15), glm::vec2(100, 35) }) {
+		wall.setPosition(position);
+		scene->addActor(wall.clone());
+	}
+
+	wall.setStatic(true);
+	wall.setWidth(45);
+	wall.setOrientation(-0.5f);
+	wall.setPosition({ 50,40 });
+	scene->addActor(wall.clone());
+	wall.setPosition({ 50,53 });
+	scene->addActor(wall.clone());
+	wall.setWidth(80);
+	wall.setOrientation(0);
+	wall.setPosition({ -10,50 });
+	scene->addActor(wall.clone());
+	wall.setWidth(60.f);
+	wall.setPosition({ 0,63 });
+	scene->addActor(wall.clone());
+}
+
+const std::vector<BenchmarkScene>& getBenchmarkScenes()
+{
+	static const std::vector<BenchmarkScene> scenes = {
+		{ "spheres", "500", "N spheres bouncing in a box", buildSpheres, nullptr },
+		{ "box_stacks", "100", "N boxes in stacks of ten", buildBoxStacks, nullptr },
+		{ "soft_body", "20x20", "RxC soft body dropped on the ground", buildSoftBody, nullptr },
+		{ "rope", "200", "Rope of N segments swinging from one end onto the ground", buildRope, nullptr },
+		{ "pool_break", "", "Pool rack broken by the cue ball", buildPoolBreak, startPoolBreak },
+		{ "slug_course", "", "Slug pushed through the slug demo course", buildSlugCourse, nullptr },
+	};
+	return scenes;
+}
+
+const BenchmarkScene* findBenchmarkScene(const std::string& name)
+{
+	for (const BenchmarkScene& scene : getBenchmarkScenes()) {
+		if (name == scene.name) {
+			return &scene;
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "PhysicsScene.h"
+
+#include <string>
+
+// Canonical scene to benchmark, built at a size given by its parameter
+struct BenchmarkScene {
+	typedef void(*Builder)(physics::PhysicsScene* scene, const std::string& param);
+	typedef void(*Starter)(physics::PhysicsScene* scene);
+
+	const char* name;
+	const char* defaultParam;	// Empty for scenes with a fixed size
+	const char* description;
+	Builder build;				// Adds scene's actors, throwing std::invalid_argument for bad parameters
+	Starter start;				// Sets scene going after warm-up, so brief events land in timed steps, or nullptr
+};
+
+// Every canonical scene, in the order they are run by default
+const std::vector<BenchmarkScene>& getBenchmarkScenes();
+
+// Returns scene with given name, or nullptr if there isn't one
+const BenchmarkScene* findBenchmarkScene(const std::string& name);
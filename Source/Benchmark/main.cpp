@@ -0,0 +1,182 @@
+#include "Benchmark.h"
+#include "Trace.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Exit codes, so scripts can tell a slower build from a broken command line
+static const int k_exit_ok = 0;
+static const int k_exit_regression = 1;
+static const int k_exit_usage = 2;
+
+static void printUsage(std::ostream& stream)
+{
+	stream << "Usage: Benchmark [options]\n"
+		<< "  --scene name[=param]  Scene to run, may be repeated (default all scenes)\n"
+		<< "  --steps n             Steps to time per scene (default 600)\n"
+		<< "  --warmup n            Steps to run before timing (default 60)\n"
+		<< "  --workers n           Worker threads for each scene (default 0)\n"
+		<< "  --out path            Write results to file instead of stdout\n"
+		<< "  --baseline path       Compare results against earlier results, failing on regressions\n"
+		<< "  --threshold percent   Allowed regression against baseline (default 10)\n"
+		<< "  --trace path          Write Chrome trace of run to file\n"
+		<< "  --list                List scenes and their default parameters\n"
+		<< "Scenes:\n";
+	for (const BenchmarkScene& scene : getBenchmarkScenes()) {
+		stream << "  " << scene.name;
+		if (*scene.defaultParam) {
+			stream << "=" << scene.defaultParam;
+		}
+		stream << "  " << scene.description << "\n";
+	}
+}
+
+static size_t parseSize(const std::string& option, const std::string& value)
+{
+	size_t used = 0;
+	unsigned long result = 0;
+	try {
+		result = std::stoul(value, &used);
+	}
+	catch (const std::exception&) {
+		used = 0;
+	}
+	if (used == 0 || used != value.size()) {
+		throw std::invalid_argument(option + " expects a number, not \"" + value + "\"");
+	}
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::pair<const BenchmarkScene*, std::string>> runs;
+	BenchmarkSettings settings;
+	std::string outPath;
+	std::string baselinePath;
+	std::string tracePath;
+	double threshold = 0.1;
+
+	try {
+		for (int i = 1; i < argc; ++i) {
+			std::string option = argv[i];
+			if (option == "--help") {
+				printUsage(std::cout);
+				return k_exit_ok;
+			}
+			if (option == "--list") {
+				for (const BenchmarkScene& scene : getBenchmarkScenes()) {
+					std::cout << scene.name << "," << scene.defaultParam << "\n";
+				}
+				return k_exit_ok;
+			}
+			if (i + 1 >= argc) {
+				throw std::invalid_argument("Missing value for " + option);
+			}
+			std::string value = argv[++i];
+			if (option == "--scene") {
+				size_t split = value.find('=');
+				std::string name = value.substr(0, split);
+				const BenchmarkScene* scene = findBenchmarkScene(name);
+				if (scene == nullptr) {
+					throw std::invalid_argument("Unknown scene \"" + name + "\"");
+				}
+				runs.push_back({ scene, split == std::string::npos ? std::string() : value.substr(split + 1) });
+			}
+			else if (option == "--steps") {
+				settings.steps = parseSize(option, value);
+			}
+			else if (option == "--warmup") {
+				settings.warmupSteps = parseSize(option, value);
+			}
+			else if (option == "--workers") {
+				settings.workers = parseSize(option, value);
+			}
+			else if (option == "--threshold") {
+				threshold = parseSize(option, value) / 100.0;
+			}
+			else if (option == "--out") {
+				outPath = value;
+			}
+			else if (option == "--baseline") {
+				baselinePath = value;
+			}
+			else if (option == "--trace") {
+				tracePath = value;
+			}
+			else {
+				throw std::invalid_argument("Unknown option " + option);
+			}
+		}
+	}
+	catch (const std::invalid_argument& e) {
+		std::cerr << e.what() << "\n";
+		printUsage(std::cerr);
+		return k_exit_usage;
+	}
+
+	if (runs.empty()) {
+		for (const BenchmarkScene& scene : getBenchmarkScenes()) {
+			runs.push_back({ &scene, std::string() });
+		}
+	}
+
+	std::vector<BenchmarkResult> baseline;
+	if (!baselinePath.empty()) {
+		std::ifstream baselineFile(baselinePath);
+		if (!baselineFile) {
+			std::cerr << "Couldn't open baseline " << baselinePath << "\n";
+			return k_exit_usage;
+		}
+		try {
+			baseline = readResults(baselineFile);
+		}
+		catch (const std::invalid_argument& e) {
+			std::cerr << baselinePath << ": " << e.what() << "\n";
+			return k_exit_usage;
+		}
+	}
+
+	// Tracing costs time on every scope, so it stays off unless a trace was asked for
+	physics::Tracer::getInstance().setEnabled(!tracePath.empty());
+
+	std::vector<BenchmarkResult> results;
+	for (const auto& run : runs) {
+		try {
+			results.push_back(runBenchmark(*run.first, run.second, settings));
+		}
+		catch (const std::invalid_argument& e) {
+			std::cerr << run.first->name << ": " << e.what() << "\n";
+			return k_exit_usage;
+		}
+		const BenchmarkResult& result = results.back();
+		std::cerr << result.scene << "(" << result.param << "): " << result.stepsPerSecond << " steps/sec\n";
+	}
+
+	if (outPath.empty()) {
+		writeResults(std::cout, results);
+	}
+	else {
+		std::ofstream outFile(outPath);
+		writeResults(outFile, results);
+		if (!outFile) {
+			std::cerr << "Couldn't write results to " << outPath << "\n";
+			return k_exit_usage;
+		}
+	}
+
+	if (!tracePath.empty() && !physics::Tracer::getInstance().dumpJson(tracePath)) {
+		std::cerr << "Couldn't write trace to " << tracePath << "\n";
+	}
+
+	std::vector<BenchmarkRegression> regressions = findRegressions(baseline, results, threshold);
+	for (const BenchmarkRegression& regression : regressions) {
+		std::cerr << "Regression in " << regression.scene << "(" << regression.param << ") " << regression.measure
+			<< ": " << regression.baseline << " -> " << regression.value << "\n";
+	}
+	return regressions.empty() ? k_exit_ok : k_exit_regression;
+}
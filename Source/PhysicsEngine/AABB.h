@@ -0,0 +1,54 @@
+#pragma once
+#include "ExternalLibraries.h"
+
+#include <cmath>
+
+namespace physics {
+
+	// Axis aligned bounding box in world space
+	// Default constructed box is empty, and overlaps nothing
+	struct AABB {
+		AABB(glm::vec2 a_min = glm::vec2(INFINITY), glm::vec2 a_max = glm::vec2(-INFINITY))
+			: min(a_min), max(a_max)
+		{};
+
+		glm::vec2 min;
+		glm::vec2 max;
+
+		// Returns true if box contains no points
+		bool isEmpty() const { return min.x > max.x || min.y > max.y; }
+
+		// Returns true if box has finite extents on both axes
+		bool isBounded() const { return std::isfinite(min.x) && std::isfinite(min.y) && std::isfinite(max.x) && std::isfinite(max.y); }
+
+		// Returns true if boxes overlap or touch on both axes
+		bool overlaps(const AABB& other) const {
+			return min.x <= other.max.x && other.min.x <= max.x
+				&& min.y <= other.max.y && other.min.y <= max.y;
+		}
+
+		// Returns true if other box lies entirely within this one
+		bool contains(const AABB& other) const {
+			return min.x <= other.min.x && min.y <= other.min.y
+				&& other.max.x <= max.x && other.max.y <= max.y;
+		}
+
+		// Returns true if point lies within box
+		bool contains(glm::vec2 point) const {
+			return min.x <= point.x && min.y <= point.y
+				&& point.x <= max.x && point.y <= max.y;
+		}
+
+		// Returns length of box's boundary, used as cost of tree nodes
+		float perimeter() const { return 2 * ((max.x - min.x) + (max.y - min.y)); }
+
+		// Returns box grown by margin in all directions
+		AABB fattened(float margin) const { return AABB(min - glm::vec2(margin), max + glm::vec2(margin)); }
+
+		// Returns smallest box containing both boxes
+		static AABB combine(const AABB& a, const AABB& b) { return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max)); }
+
+		// Returns box covering all of space
+		static AABB infinite() { return AABB(glm::vec2(-INFINITY), glm::vec2(INFINITY)); }
+	};
+}
@@ -0,0 +1,276 @@
+#include "AABBTree.h"
+
+#include <cmath>
+#include <stdexcept>
+
+const float physics::AABBTree::k_def_margin = 0.1f;
+
+physics::AABBTree::AABBTree(float margin) : m_root(k_null_node), m_freeList(k_null_node), m_leafCount(0), m_margin(margin)
+{
+	if (margin < 0 || std::isnan(margin) || std::isinf(margin)) {
+		throw std::invalid_argument("Margin must be non-negative and finite");
+	}
+}
+
+int physics::AABBTree::insert(const AABB & bounds, size_t userData)
+{
+	int leaf = allocateNode();
+	m_nodes[leaf].bounds = bounds.fattened(m_margin);
+	m_nodes[leaf].userData = userData;
+	m_nodes[leaf].height = 0;
+	insertLeaf(leaf);
+	++m_leafCount;
+	return leaf;
+}
+
+void physics::AABBTree::remove(int leaf)
+{
+	removeLeaf(leaf);
+	freeNode(leaf);
+	--m_leafCount;
+}
+
+bool physics::AABBTree::move(int leaf, const AABB & bounds)
+{
+	if (m_nodes[leaf].bounds.contains(bounds)) {
+		return false;
+	}
+	removeLeaf(leaf);
+	m_nodes[leaf].bounds = bounds.fattened(m_margin);
+	insertLeaf(leaf);
+	return true;
+}
+
+void physics::AABBTree::query(const AABB & bounds, std::vector<size_t>& results)
+{
+	if (m_root == k_null_node) {
+		return;
+	}
+	m_stack.clear();
+	m_stack.push_back(m_root);
+	while (!m_stack.empty()) {
+		const Node& node = m_nodes[m_stack.back()];
+		m_stack.pop_back();
+		if (node.bounds.overlaps(bounds)) {
+			if (node.isLeaf()) {
+				results.push_back(node.userData);
+			}
+			else {
+				m_stack.push_back(node.left);
+				m_stack.push_back(node.right);
+			}
+		}
+	}
+}
+
+void physics::AABBTree::clear()
+{
+	m_nodes.clear();
+	m_root = k_null_node;
+	m_freeList = k_null_node;
+	m_leafCount = 0;
+}
+
+int physics::AABBTree::getHeight()
+{
+	return m_root == k_null_node ? 0 : m_nodes[m_root].height;
+}
+
+int physics::AABBTree::allocateNode()
+{
+	int node;
+	if (m_freeList != k_null_node) {
+		node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+	}
+	else {
+		node = (int)m_nodes.size();
+		m_nodes.push_back(Node());
+	}
+	m_nodes[node].parent = k_null_node;
+	m_nodes[node].left = k_null_node;
+	m_nodes[node].right = k_null_node;
+	m_nodes[node].height = 0;
+	m_nodes[node].userData = 0;
+	return node;
+}
+
+void physics::AABBTree::freeNode(int node)
+{
+	m_nodes[node].parent = m_freeList;
+	m_nodes[node].height = -1;
+	m_freeList = node;
+}
+
+void physics::AABBTree::insertLeaf(int leaf)
+{
+	if (m_root == k_null_node) {
+		m_root = leaf;
+		m_nodes[leaf].parent = k_null_node;
+		return;
+	}
+
+	// Descend to the sibling which least increases the total perimeter of the tree
+	AABB leafBounds = m_nodes[leaf].bounds;
+	int sibling = m_root;
+	while (!m_nodes[sibling].isLeaf()) {
+		const Node& node = m_nodes[sibling];
+		float perimeter = node.bounds.perimeter();
+		float combinedPerimeter = AABB::combine(node.bounds, leafBounds).perimeter();
+
+		// Cost of making new parent for node and leaf here
+		float cost = 2 * combinedPerimeter;
+		// Minimum cost pushed down to children
+		float inheritedCost = 2 * (combinedPerimeter - perimeter);
+
+		float childCost[2];
+		int children[2] = { node.left, node.right };
+		for (int i = 0; i < 2; ++i) {
+			const Node& child = m_nodes[children[i]];
+			float enlarged = AABB::combine(child.bounds, leafBounds).perimeter();
+			if (child.isLeaf()) {
+				childCost[i] = enlarged + inheritedCost;
+			}
+			else {
+				childCost[i] = enlarged - child.bounds.perimeter() + inheritedCost;
+			}
+		}
+
+		if (cost < childCost[0] && cost < childCost[1]) {
+			break;
+		}
+		sibling = (childCost[0] < childCost[1]) ? children[0] : children[1];
+	}
+
+	// Replace sibling with new parent of sibling and leaf
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = allocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].bounds = AABB::combine(leafBounds, m_nodes[sibling].bounds);
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
+	m_nodes[newParent].left = sibling;
+	m_nodes[newParent].right = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent == k_null_node) {
+		m_root = newParent;
+	}
+	else if (m_nodes[oldParent].left == sibling) {
+		m_nodes[oldParent].left = newParent;
+	}
+	else {
+		m_nodes[oldParent].right = newParent;
+	}
+
+	refitAncestors(m_nodes[leaf].parent);
+}
+
+void physics::AABBTree::removeLeaf(int leaf)
+{
+	if (leaf == m_root) {
+		m_root = k_null_node;
+		return;
+	}
+
+	// Sibling takes the place of leaf's parent
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = (m_nodes[parent].left == leaf) ? m_nodes[parent].right : m_nodes[parent].left;
+
+	if (grandParent == k_null_node) {
+		m_root = sibling;
+		m_nodes[sibling].parent = k_null_node;
+	}
+	else {
+		if (m_nodes[grandParent].left == parent) {
+			m_nodes[grandParent].left = sibling;
+		}
+		else {
+			m_nodes[grandParent].right = sibling;
+		}
+		m_nodes[sibling].parent = grandParent;
+		refitAncestors(grandParent);
+	}
+	freeNode(parent);
+	m_nodes[leaf].parent = k_null_node;
+}
+
+void physics::AABBTree::refitAncestors(int node)
+{
+	while (node != k_null_node) {
+		node = balance(node);
+		Node& current = m_nodes[node];
+		const Node& left = m_nodes[current.left];
+		const Node& right = m_nodes[current.right];
+		current.height = 1 + std::max(left.height, right.height);
+		current.bounds = AABB::combine(left.bounds, right.bounds);
+		node = current.parent;
+	}
+}
+
+int physics::AABBTree::balance(int a)
+{
+	Node& nodeA = m_nodes[a];
+	if (nodeA.isLeaf() || nodeA.height < 2) {
+		return a;
+	}
+
+	int b = nodeA.left;
+	int c = nodeA.right;
+	int balanceFactor = m_nodes[c].height - m_nodes[b].height;
+
+	// Whichever child is too tall is rotated up to replace a
+	int up, down;
+	if (balanceFactor > 1) {
+		up = c;
+		down = b;
+	}
+	else if (balanceFactor < -1) {
+		up = b;
+		down = c;
+	}
+	else {
+		return a;
+	}
+
+	Node& nodeUp = m_nodes[up];
+	int f = nodeUp.left;
+	int g = nodeUp.right;
+
+	// up takes a's place in the tree
+	nodeUp.left = a;
+	nodeUp.parent = nodeA.parent;
+	nodeA.parent = up;
+	if (nodeUp.parent == k_null_node) {
+		m_root = up;
+	}
+	else if (m_nodes[nodeUp.parent].left == a) {
+		m_nodes[nodeUp.parent].left = up;
+	}
+	else {
+		m_nodes[nodeUp.parent].right = up;
+	}
+
+	// Taller grandchild stays under up, shorter one moves under a
+	int keep, give;
+	if (m_nodes[f].height > m_nodes[g].height) {
+		keep = f;
+		give = g;
+	}
+	else {
+		keep = g;
+		give = f;
+	}
+	nodeUp.right = keep;
+	nodeA.left = down;
+	nodeA.right = give;
+	m_nodes[give].parent = a;
+
+	nodeA.bounds = AABB::combine(m_nodes[down].bounds, m_nodes[give].bounds);
+	nodeA.height = 1 + std::max(m_nodes[down].height, m_nodes[give].height);
+	nodeUp.bounds = AABB::combine(nodeA.bounds, m_nodes[keep].bounds);
+	nodeUp.height = 1 + std::max(nodeA.height, m_nodes[keep].height);
+
+	return up;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "AABB.h"
+
+namespace physics {
+
+	// Dynamic bounding volume hierarchy of AABBs
+	// Leaves hold fattened bounds, so objects moving a small distance don't need to be reinserted.
+	// The tree is kept balanced by rotating nodes as leaves are inserted and removed.
+	// Nodes are stored in a flat pool and referred to by index, with freed nodes reused.
+	class AABBTree {
+	public:
+		static const int k_null_node = -1;
+		static const float k_def_margin;	// Default distance leaf bounds are fattened by
+
+		AABBTree(float margin = k_def_margin);
+
+		// Inserts leaf for bounds, returning its node
+		// userData = value returned by queries which find leaf
+		int insert(const AABB& bounds, size_t userData);
+
+		// Removes leaf from tree
+		void remove(int leaf);
+
+		// Updates bounds of leaf, reinserting it only if it has left its fattened bounds
+		// returns true if leaf was reinserted
+		bool move(int leaf, const AABB& bounds);
+
+		size_t getUserData(int leaf) { return m_nodes[leaf].userData; }
+		void setUserData(int leaf, size_t userData) { m_nodes[leaf].userData = userData; }
+
+		// Returns fattened bounds stored in leaf
+		const AABB& getFatBounds(int leaf) { return m_nodes[leaf].bounds; }
+
+		// Appends user data of every leaf whose fattened bounds overlap bounds
+		void query(const AABB& bounds, std::vector<size_t>& results);
+
+		// Removes all leaves
+		void clear();
+
+		// Returns height of tree, with a single leaf having height 0
+		int getHeight();
+
+		size_t getLeafCount() { return m_leafCount; }
+
+		float getMargin() { return m_margin; }
+
+	protected:
+		struct Node {
+			AABB bounds;
+			size_t userData;
+			int parent;		// Also links free nodes
+			int left;
+			int right;
+			int height;		// Leaves have height 0, free nodes -1
+
+			bool isLeaf() const { return left == k_null_node; }
+		};
+
+		std::vector<Node> m_nodes;
+		std::vector<int> m_stack;	// Reused for traversal
+		int m_root;
+		int m_freeList;
+		size_t m_leafCount;
+		float m_margin;
+
+		int allocateNode();
+		void freeNode(int node);
+
+		void insertLeaf(int leaf);
+		void removeLeaf(int leaf);
+
+		// Rotates subtree at node if unbalanced, returning new root of subtree
+		int balance(int node);
+
+		// Recalculates bounds and heights from node up to the root, balancing on the way
+		void refitAncestors(int node);
+	};
+}
@@ -0,0 +1,110 @@
+#include "ActorRegistry.h"
+
+physics::ActorHandle physics::ActorRegistry::add(PhysicsObjectPtr actor)
+{
+	if (m_lookup.count(actor.get()) != 0) {
+		return ActorHandle();
+	}
+	uint32_t slot;
+	if (m_freeSlots.empty()) {
+		slot = (uint32_t)m_slots.size();
+		m_slots.push_back({ 0, 1 });
+	}
+	else {
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	m_slots[slot].dense = (uint32_t)m_objects.size();
+	m_objects.push_back(actor.get());
+	m_owners.push_back(actor);
+	m_denseSlots.push_back(slot);
+	m_lookup[actor.get()] = slot;
+	return ActorHandle(slot, m_slots[slot].generation);
+}
+
+bool physics::ActorRegistry::remove(ActorHandle handle)
+{
+	if (!contains(handle)) {
+		return false;
+	}
+	removeDense(handle.index);
+	return true;
+}
+
+bool physics::ActorRegistry::remove(PhysicsObject * actor)
+{
+	auto found = m_lookup.find(actor);
+	if (found == m_lookup.end()) {
+		return false;
+	}
+	removeDense(found->second);
+	return true;
+}
+
+physics::PhysicsObject * physics::ActorRegistry::get(ActorHandle handle) const
+{
+	if (handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation) {
+		return nullptr;
+	}
+	return m_objects[m_slots[handle.index].dense];
+}
+
+physics::ActorHandle physics::ActorRegistry::find(PhysicsObject * actor) const
+{
+	auto found = m_lookup.find(actor);
+	if (found == m_lookup.end()) {
+		return ActorHandle();
+	}
+	return ActorHandle(found->second, m_slots[found->second].generation);
+}
+
+void physics::ActorRegistry::clear()
+{
+	for (uint32_t slot : m_denseSlots) {
+		if (++m_slots[slot].generation == 0) {
+			m_slots[slot].generation = 1;
+		}
+		m_freeSlots.push_back(slot);
+	}
+	// Keep actors alive until registry is empty
+	std::vector<PhysicsObjectPtr> owners;
+	owners.swap(m_owners);
+	m_lookup.clear();
+	m_denseSlots.clear();
+	m_objects.clear();
+}
+
+void physics::ActorRegistry::reserve(size_t count)
+{
+	size_t total = m_objects.size() + count;
+	m_objects.reserve(total);
+	m_owners.reserve(total);
+	m_denseSlots.reserve(total);
+	if (m_freeSlots.size() < count) {
+		m_slots.reserve(m_slots.size() + count - m_freeSlots.size());
+	}
+	m_lookup.reserve(total);
+}
+
+void physics::ActorRegistry::removeDense(uint32_t slot)
+{
+	uint32_t dense = m_slots[slot].dense;
+	uint32_t last = (uint32_t)m_objects.size() - 1;
+	m_lookup.erase(m_objects[dense]);
+	// Keep removed actor alive until registry is consistent again
+	PhysicsObjectPtr removed = std::move(m_owners[dense]);
+	if (dense != last) {
+		m_objects[dense] = m_objects[last];
+		m_owners[dense] = std::move(m_owners[last]);
+		m_denseSlots[dense] = m_denseSlots[last];
+		m_slots[m_denseSlots[dense]].dense = dense;
+	}
+	m_objects.pop_back();
+	m_owners.pop_back();
+	m_denseSlots.pop_back();
+	// Generation 0 is never given out
+	if (++m_slots[slot].generation == 0) {
+		m_slots[slot].generation = 1;
+	}
+	m_freeSlots.push_back(slot);
+}
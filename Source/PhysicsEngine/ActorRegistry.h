@@ -0,0 +1,76 @@
+#pragma once
+#include "ExternalLibraries.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace physics {
+	class PhysicsObject;
+
+	typedef std::shared_ptr<PhysicsObject> PhysicsObjectPtr;
+
+	// Refers to actor in a registry. Each slot's generation changes when its actor is removed, so
+	// handles to removed actors are detected rather than reaching whatever reuses the slot
+	struct ActorHandle {
+		uint32_t index;
+		uint32_t generation;	// 0 for handles which never referred to an actor
+
+		ActorHandle() : index(0), generation(0) {}
+		ActorHandle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+		bool operator==(const ActorHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const ActorHandle& other) const { return !(*this == other); }
+	};
+
+	// Slot map holding a scene's actors
+	// Actors are kept packed in dense arrays for iteration, while handles index a sparse array of slots
+	// pointing into them. Adding, removing and looking up actors, by handle or by pointer, take constant
+	// time. Removal moves the last actor into the removed one's place, so order isn't kept.
+	class ActorRegistry {
+	public:
+		// Adds actor, returning its handle, or invalid handle if it's already in the registry
+		ActorHandle add(PhysicsObjectPtr actor);
+
+		// Removes actor, returning false if it isn't in the registry
+		bool remove(ActorHandle handle);
+		bool remove(PhysicsObject* actor);
+
+		// Returns actor, or nullptr if handle is out of date
+		PhysicsObject* get(ActorHandle handle) const;
+
+		// Returns handle of actor, or invalid handle if it isn't in the registry
+		ActorHandle find(PhysicsObject* actor) const;
+
+		bool contains(ActorHandle handle) const { return get(handle) != nullptr; }
+		bool contains(PhysicsObject* actor) const { return m_lookup.count(actor) != 0; }
+
+		// Removes every actor, leaving old handles out of date
+		void clear();
+
+		// Makes room for count more actors without reallocating
+		void reserve(size_t count);
+
+		size_t size() const { return m_objects.size(); }
+
+		// Actors packed for iteration, in the same order in both
+		const std::vector<PhysicsObject*>& getObjects() const { return m_objects; }
+		const std::vector<PhysicsObjectPtr>& getOwners() const { return m_owners; }
+
+	protected:
+		struct Slot {
+			uint32_t dense;			// Index of actor in dense arrays
+			uint32_t generation;
+		};
+
+		std::vector<Slot> m_slots;
+		std::vector<uint32_t> m_freeSlots;
+
+		std::vector<PhysicsObject*> m_objects;
+		std::vector<PhysicsObjectPtr> m_owners;
+		std::vector<uint32_t> m_denseSlots;		// Slot of each dense actor
+
+		std::unordered_map<PhysicsObject*, uint32_t> m_lookup;	// Slot of each actor
+
+		void removeDense(uint32_t slot);
+	};
+}
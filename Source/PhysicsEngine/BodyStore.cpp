@@ -0,0 +1,333 @@
+#include "BodyStore.h"
+#include "RigidBody.h"
+#include "Simd.h"
+
+size_t physics::BodyStore::add(RigidBody * body)
+{
+	std::unique_lock<std::mutex> guard = lock();
+	return addUnlocked(body);
+}
+
+size_t physics::BodyStore::addUnlocked(RigidBody * body)
+{
+	if (!freeSlots.empty()) {
+		size_t slot = freeSlots.back();
+		freeSlots.pop_back();
+		bodies[slot] = body;
+		position[slot] = { 0,0 };
+		pastPosition[slot] = { 0,0 };
+		velocity[slot] = { 0,0 };
+		force[slot] = { 0,0 };
+		orientation[slot] = 0;
+		angularVelocity[slot] = 0;
+		torque[slot] = 0;
+		localX[slot] = { 1,0 };
+		localY[slot] = { 0,1 };
+		pastX[slot] = { 1,0 };
+		pastY[slot] = { 0,1 };
+		invMass[slot] = 0;
+		invMoment[slot] = 0;
+		drag[slot] = 0;
+		angularDrag[slot] = 0;
+		flags[slot] = 0;
+		return slot;
+	}
+	bodies.push_back(body);
+	position.push_back({ 0,0 });
+	pastPosition.push_back({ 0,0 });
+	velocity.push_back({ 0,0 });
+	force.push_back({ 0,0 });
+	orientation.push_back(0);
+	angularVelocity.push_back(0);
+	torque.push_back(0);
+	localX.push_back({ 1,0 });
+	localY.push_back({ 0,1 });
+	pastX.push_back({ 1,0 });
+	pastY.push_back({ 0,1 });
+	invMass.push_back(0);
+	invMoment.push_back(0);
+	drag.push_back(0);
+	angularDrag.push_back(0);
+	flags.push_back(0);
+	return bodies.size() - 1;
+}
+
+void physics::BodyStore::reserve(size_t count)
+{
+	size_t total = bodies.size() + count;
+	bodies.reserve(total);
+	position.reserve(total);
+	pastPosition.reserve(total);
+	velocity.reserve(total);
+	force.reserve(total);
+	orientation.reserve(total);
+	angularVelocity.reserve(total);
+	torque.reserve(total);
+	localX.reserve(total);
+	localY.reserve(total);
+	pastX.reserve(total);
+	pastY.reserve(total);
+	invMass.reserve(total);
+	invMoment.reserve(total);
+	drag.reserve(total);
+	angularDrag.reserve(total);
+	flags.reserve(total);
+}
+
+size_t physics::BodyStore::moveFrom(BodyStore & other, size_t slot)
+{
+	std::unique_lock<std::mutex> guard = lock();
+	std::unique_lock<std::mutex> otherGuard;
+	if (other.mutex && other.mutex != mutex) {
+		// Locked together, so two threads moving bodies between their stores can't deadlock
+		otherGuard = std::unique_lock<std::mutex>(*other.mutex, std::defer_lock);
+		if (guard) {
+			guard.unlock();
+			std::lock(guard, otherGuard);
+		}
+		else {
+			otherGuard.lock();
+		}
+	}
+	size_t moved = addUnlocked(other.bodies[slot]);
+	copy(moved, other, slot);
+	other.removeUnlocked(slot);
+	return moved;
+}
+
+void physics::BodyStore::copy(size_t slot, const BodyStore & other, size_t otherSlot)
+{
+	position[slot] = other.position[otherSlot];
+	pastPosition[slot] = other.pastPosition[otherSlot];
+	velocity[slot] = other.velocity[otherSlot];
+	force[slot] = other.force[otherSlot];
+	orientation[slot] = other.orientation[otherSlot];
+	angularVelocity[slot] = other.angularVelocity[otherSlot];
+	torque[slot] = other.torque[otherSlot];
+	localX[slot] = other.localX[otherSlot];
+	localY[slot] = other.localY[otherSlot];
+	pastX[slot] = other.pastX[otherSlot];
+	pastY[slot] = other.pastY[otherSlot];
+	invMass[slot] = other.invMass[otherSlot];
+	invMoment[slot] = other.invMoment[otherSlot];
+	drag[slot] = other.drag[otherSlot];
+	angularDrag[slot] = other.angularDrag[otherSlot];
+	flags[slot] = other.flags[otherSlot];
+}
+
+void physics::BodyStore::remove(size_t slot)
+{
+	std::unique_lock<std::mutex> guard = lock();
+	removeUnlocked(slot);
+}
+
+void physics::BodyStore::removeUnlocked(size_t slot)
+{
+	if (mutex) {
+		// Other threads' bodies are read without locking, so they must keep their slots
+		bodies[slot] = nullptr;
+		freeSlots.push_back(slot);
+		return;
+	}
+	size_t last = bodies.size() - 1;
+	if (slot != last) {
+		bodies[slot] = bodies[last];
+		copy(slot, *this, last);
+		bodies[slot]->m_slot = slot;
+	}
+	bodies.pop_back();
+	position.pop_back();
+	pastPosition.pop_back();
+	velocity.pop_back();
+	force.pop_back();
+	orientation.pop_back();
+	angularVelocity.pop_back();
+	torque.pop_back();
+	localX.pop_back();
+	localY.pop_back();
+	pastX.pop_back();
+	pastY.pop_back();
+	invMass.pop_back();
+	invMoment.pop_back();
+	drag.pop_back();
+	angularDrag.pop_back();
+	flags.pop_back();
+}
+
+void physics::BodyStore::integrate(glm::vec2 gravity, float timeStep, size_t begin, size_t end, unsigned char skip)
+{
+#ifdef PHYSICS_SIMD
+	integrateSimd(gravity, timeStep, begin, end, skip);
+#else
+	integrateScalar(gravity, timeStep, begin, end, skip);
+#endif
+}
+
+void physics::BodyStore::integrateScalar(glm::vec2 gravity, float timeStep, size_t begin, size_t end, unsigned char skip)
+{
+	for (size_t i = begin; i < end; ++i) {
+		if (flags[i] & skip) {
+			continue;
+		}
+		// Update previous position
+		pastPosition[i] = position[i];
+		pastX[i] = localX[i];
+		pastY[i] = localY[i];
+		if ((flags[i] & (static_body | awake)) == awake) {
+			if (invMass[i] != 0) {
+				// Apply drag
+				float dragImpulse = std::min(drag[i] * timeStep * invMass[i], 1.f);
+				velocity[i] -= dragImpulse * velocity[i];
+
+				float dragTorque = std::min(angularDrag[i] * timeStep * invMoment[i], 1.f);
+				angularVelocity[i] -= dragTorque * angularVelocity[i];
+
+				// Gravity accelerates every body equally, whatever its mass
+				velocity[i] += (force[i] * invMass[i] + gravity) * timeStep;
+				angularVelocity[i] += torque[i] * invMoment[i] * timeStep;
+			}
+			position[i] += velocity[i] * timeStep;
+			// modulus 2pi
+			orientation[i] = remainderf(orientation[i] + angularVelocity[i] * timeStep, glm::two_pi<float>());
+			calculateAxes(i);
+		}
+		force[i] = { 0,0 };
+		torque[i] = 0;
+	}
+}
+
+void physics::BodyStore::integrateSimd(glm::vec2 gravity, float timeStep, size_t begin, size_t end, unsigned char skip)
+{
+#ifdef PHYSICS_SIMD
+	const __m128 dt = _mm_set1_ps(timeStep);
+	const __m128 one = _mm_set1_ps(1);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 gravityX = _mm_set1_ps(gravity.x);
+	const __m128 gravityY = _mm_set1_ps(gravity.y);
+	const __m128 twoPi = _mm_set1_ps(glm::two_pi<float>());
+	const __m128 invTwoPi = _mm_set1_ps(glm::one_over_two_pi<float>());
+
+	size_t i = begin;
+	for (; i + 4 <= end; i += 4) {
+		// Lanes are written whole, so four slots holding any to skip go through the scalar path
+		if ((flags[i] | flags[i + 1] | flags[i + 2] | flags[i + 3]) & skip) {
+			integrateScalar(gravity, timeStep, i, i + 4, skip);
+			continue;
+		}
+		// Update previous position
+		std::copy(&position[i], &position[i] + 4, &pastPosition[i]);
+		std::copy(&localX[i], &localX[i] + 4, &pastX[i]);
+		std::copy(&localY[i], &localY[i] + 4, &pastY[i]);
+
+		// Lanes of bodies that move, and that are also affected by forces
+		__m128i flag = _mm_set_epi32(flags[i + 3], flags[i + 2], flags[i + 1], flags[i]);
+		__m128 moving = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flag, _mm_set1_epi32(static_body | awake)), _mm_set1_epi32(awake)));
+		if (_mm_movemask_ps(moving) != 0) {
+			__m128 mass = _mm_loadu_ps(&invMass[i]);
+			__m128 moment = _mm_loadu_ps(&invMoment[i]);
+			__m128 dynamic = _mm_and_ps(moving, _mm_cmpneq_ps(mass, zero));
+
+			__m128 velX, velY, forceX, forceY;
+			simd::loadVec2(&velocity[i], velX, velY);
+			simd::loadVec2(&force[i], forceX, forceY);
+			__m128 angular = _mm_loadu_ps(&angularVelocity[i]);
+
+			// Apply drag
+			__m128 dragImpulse = _mm_min_ps(_mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&drag[i]), dt), mass), one);
+			__m128 newVelX = _mm_sub_ps(velX, _mm_mul_ps(dragImpulse, velX));
+			__m128 newVelY = _mm_sub_ps(velY, _mm_mul_ps(dragImpulse, velY));
+			__m128 dragTorque = _mm_min_ps(_mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&angularDrag[i]), dt), moment), one);
+			__m128 newAngular = _mm_sub_ps(angular, _mm_mul_ps(dragTorque, angular));
+
+			newVelX = _mm_add_ps(newVelX, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(forceX, mass), gravityX), dt));
+			newVelY = _mm_add_ps(newVelY, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(forceY, mass), gravityY), dt));
+			newAngular = _mm_add_ps(newAngular, _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&torque[i]), moment), dt));
+			velX = simd::select(dynamic, newVelX, velX);
+			velY = simd::select(dynamic, newVelY, velY);
+			angular = simd::select(dynamic, newAngular, angular);
+			simd::storeVec2(&velocity[i], velX, velY);
+			_mm_storeu_ps(&angularVelocity[i], angular);
+
+			__m128 posX, posY;
+			simd::loadVec2(&position[i], posX, posY);
+			posX = simd::select(moving, _mm_add_ps(posX, _mm_mul_ps(velX, dt)), posX);
+			posY = simd::select(moving, _mm_add_ps(posY, _mm_mul_ps(velY, dt)), posY);
+			simd::storeVec2(&position[i], posX, posY);
+
+			// modulus 2pi, rounding to nearest like remainderf
+			__m128 angle = _mm_loadu_ps(&orientation[i]);
+			__m128 newAngle = _mm_add_ps(angle, _mm_mul_ps(angular, dt));
+			newAngle = _mm_sub_ps(newAngle, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(newAngle, invTwoPi))), twoPi));
+			angle = simd::select(moving, newAngle, angle);
+			_mm_storeu_ps(&orientation[i], angle);
+
+			__m128 sin, cos, axisX, axisY;
+			simd::sincos(angle, sin, cos);
+			simd::loadVec2(&localX[i], axisX, axisY);
+			simd::storeVec2(&localX[i], simd::select(moving, cos, axisX), simd::select(moving, sin, axisY));
+			simd::loadVec2(&localY[i], axisX, axisY);
+			simd::storeVec2(&localY[i], simd::select(moving, _mm_sub_ps(zero, sin), axisX), simd::select(moving, cos, axisY));
+		}
+		simd::storeVec2(&force[i], zero, zero);
+		_mm_storeu_ps(&torque[i], zero);
+	}
+	// Finish slots which don't fill four lanes
+	integrateScalar(gravity, timeStep, i, end, skip);
+#else
+	integrateScalar(gravity, timeStep, begin, end, skip);
+#endif
+}
+
+bool physics::BodyStore::isSimdEnabled()
+{
+#ifdef PHYSICS_SIMD
+	return true;
+#else
+	return false;
+#endif
+}
+
+void physics::BodyStore::calculateAxes(size_t slot)
+{
+	float cos = cosf(orientation[slot]);
+	float sin = sinf(orientation[slot]);
+	localX[slot] = { cos,sin };
+	localY[slot] = { -sin,cos };
+}
+
+std::unique_lock<std::mutex> physics::BodyStore::lock()
+{
+	return mutex ? std::unique_lock<std::mutex>(*mutex) : std::unique_lock<std::mutex>();
+}
+
+namespace {
+	struct DetachedStore {
+		physics::BodyStore store;
+		std::mutex mutex;
+
+		DetachedStore() { store.mutex = &mutex; }
+	};
+
+	// Deletes thread's store when thread exits, unless bodies are left in it
+	// Those bodies can outlive the thread, or other statics, and still remove themselves
+	struct DetachedStoreOwner {
+		DetachedStore* detached;
+
+		DetachedStoreOwner() : detached(new DetachedStore()) {}
+
+		~DetachedStoreOwner()
+		{
+			std::unique_lock<std::mutex> guard(detached->mutex);
+			if (detached->store.size() == 0) {
+				guard.unlock();
+				delete detached;
+			}
+		}
+	};
+}
+
+physics::BodyStore & physics::BodyStore::detached()
+{
+	thread_local DetachedStoreOwner owner;
+	return owner.detached->store;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "ExternalLibraries.h"
+
+#include <mutex>
+
+namespace physics {
+	class RigidBody;
+
+	// State of rigidbodies stored as a structure of arrays
+	// Each body owns one slot, the same index into every array, so integration walks each array in order
+	// instead of hopping between bodies on the heap. Every scene has its own store, and bodies outside a
+	// scene are kept in the detached store of the thread which created or removed them. Slots in scene
+	// stores move when other bodies are removed, so only the owning body should keep hold of a slot index.
+	// A detached store only grows on its own thread, but bodies in it may be destroyed or added to a scene
+	// from any thread, so it leaves their slots empty rather than moving others, and locks its mutex to do so.
+	// Its owning thread may read and write its bodies without locking, so a body outside a scene must only be
+	// used by the thread whose store holds it.
+	struct BodyStore {
+		enum Flags : unsigned char {
+			static_body = 1,
+			awake = 2,
+			custom_update = 4	// Body overrides fixedUpdate, so scene steps it through that instead
+		};
+
+		std::vector<RigidBody*> bodies;	// Body owning each slot
+
+		std::vector<glm::vec2> position;
+		std::vector<glm::vec2> pastPosition;
+		std::vector<glm::vec2> velocity;
+		std::vector<glm::vec2> force;
+
+		std::vector<float> orientation;
+		std::vector<float> angularVelocity;
+		std::vector<float> torque;
+
+		std::vector<glm::vec2> localX;
+		std::vector<glm::vec2> localY;
+		std::vector<glm::vec2> pastX;
+		std::vector<glm::vec2> pastY;
+
+		std::vector<float> invMass;
+		std::vector<float> invMoment;
+		std::vector<float> drag;
+		std::vector<float> angularDrag;
+
+		std::vector<unsigned char> flags;
+
+		std::vector<size_t> freeSlots;	// Empty slots of detached store, reused before growing
+		std::mutex* mutex;				// Guards slots of detached store, or null in scene stores
+
+		BodyStore() : mutex(nullptr) {}
+
+		// Number of bodies, which is fewer than slots if a detached store has empty slots
+		size_t size() const { return bodies.size() - freeSlots.size(); }
+
+		// Makes room for count more slots without reallocating
+		void reserve(size_t count);
+
+		// Adds zeroed slot owned by body, and returns its index
+		size_t add(RigidBody* body);
+
+		// Moves slot from other store into this one, and returns its new index
+		size_t moveFrom(BodyStore& other, size_t slot);
+
+		// Copies state of slot in other store into slot of this one, keeping owner
+		void copy(size_t slot, const BodyStore& other, size_t otherSlot);
+
+		// Removes slot by moving last slot into it, and tells that slot's body its new index
+		// Detached stores leave it empty instead
+		void remove(size_t slot);
+
+		// Integrates slots [begin, end) over timeStep, then clears their force and torque
+		// Static bodies and sleeping bodies stay still, and kinematic bodies ignore forces
+		// Uses SSE2 to step four slots at once, unless built with PHYSICS_NO_SIMD
+		// Slots with any of the skip flags are left untouched
+		void integrate(glm::vec2 gravity, float timeStep, size_t begin, size_t end, unsigned char skip = 0);
+
+		// Paths integrate chooses between. Without SIMD support, integrateSimd runs the scalar path
+		void integrateScalar(glm::vec2 gravity, float timeStep, size_t begin, size_t end, unsigned char skip = 0);
+		void integrateSimd(glm::vec2 gravity, float timeStep, size_t begin, size_t end, unsigned char skip = 0);
+
+		// Whether integrate uses the SIMD path in this build
+		static bool isSimdEnabled();
+
+		// Sets local axes of slot from its orientation
+		void calculateAxes(size_t slot);
+
+		// Store holding bodies which calling thread created or removed from a scene
+		// It outlives the thread if bodies are still in it
+		static BodyStore& detached();
+
+	private:
+		// Locks mutex of detached store, or returns an empty lock for scene stores, which aren't shared
+		std::unique_lock<std::mutex> lock();
+
+		// add and remove without locking, for moveFrom which holds locks of both stores
+		size_t addUnlocked(RigidBody* body);
+		void removeUnlocked(size_t slot);
+	};
+}
@@ -1,16 +1,23 @@
 #include "Box.h"
+#include "ObjectPool.h"
 
 #include "Plane.h"
 #include "Sphere.h"
+#include "Simd.h"
+
+#include <cmath>
+#include <stdexcept>
+
+const float physics::Box::k_axis_preference = 0.95f;
 
 physics::Box::Box(glm::vec2 position, float width, float height, float orientation, glm::vec2 velocity,
 	float angularVelocity, float mass, float elasticity, float friction, float drag, float angularDrag, glm::vec4 colour) :
 	RigidBody(position,velocity,orientation,mass,elasticity,angularVelocity,friction,drag,angularDrag,colour), m_xExtent(0.5f * width), m_yExtent(0.5f * height)
 {
-	if (m_xExtent <= 0 || isnan(m_xExtent) || isinf(m_xExtent)) {
+	if (m_xExtent <= 0 || std::isnan(m_xExtent) || std::isinf(m_xExtent)) {
 		throw std::invalid_argument("Width must be positive and finite");
 	}
-	if (m_yExtent <= 0 || isnan(m_yExtent) || isinf(m_yExtent)) {
+	if (m_yExtent <= 0 || std::isnan(m_yExtent) || std::isinf(m_yExtent)) {
 		throw std::invalid_argument("Height must be positive and finite");
 	}
 	calculateMoment();
@@ -26,20 +33,20 @@ physics::PhysicsObject * physics::Box::clone()
 	return new Box(*this);
 }
 
-void physics::Box::makeGizmo(float timeRatio)
+physics::PhysicsObjectPtr physics::Box::poolClone(ObjectPools & pools)
 {
-	glm::vec2 interpPos = glm::mix(m_pastPosition, m_position, timeRatio);
-	// HACK not normalizing to save time, might need to do so if it looks bad/based on speed
-	glm::vec2 interX = glm::mix(m_pastX, m_localX , timeRatio) * m_xExtent;
-	glm::vec2 interY = glm::mix(m_pastY, m_localY, timeRatio) * m_yExtent;
-
-	glm::vec2 p1 = interpPos - interX - interY;
-	glm::vec2 p2 = interpPos + interX - interY;
-	glm::vec2 p3 = interpPos + interX + interY;
-	glm::vec2 p4 = interpPos - interX + interY;
+	return pools.boxes.create(*this);
+}
 
-	aie::Gizmos::add2DTri(p1, p2, p3, m_colour);
-	aie::Gizmos::add2DTri(p1, p3, p4, m_colour);
+bool physics::Box::extractDrawRecord(float timeRatio, DrawRecord& record)
+{
+	record.shape = draw_box;
+	record.position = glm::mix(getPastPosition(), getPosition(), timeRatio);
+	// HACK not normalizing to save time, might need to do so if it looks bad/based on speed
+	record.axisX = glm::mix(getPastX(), getLocalX(), timeRatio) * m_xExtent;
+	record.axisY = glm::mix(getPastY(), getLocalY(), timeRatio) * m_yExtent;
+	record.colour = m_colour;
+	return true;
 }
 
 bool physics::Box::isPointInside(glm::vec2 point)
@@ -48,6 +55,13 @@ bool physics::Box::isPointInside(glm::vec2 point)
 	return (abs(localPoint.x) < m_xExtent && abs(localPoint.y) < m_yExtent);
 }
 
+physics::AABB physics::Box::getAABB()
+{
+	// Furthest extent of corners along each world axis
+	glm::vec2 extent = glm::abs(getLocalX() * m_xExtent) + glm::abs(getLocalY() * m_yExtent);
+	return AABB(getPosition() - extent, getPosition() + extent);
+}
+
 physics::Collision physics::Box::checkCollision(PhysicsObject * other)
 {
 	return other->checkBoxCollision(this);
@@ -57,16 +71,16 @@ physics::Collision physics::Box::checkSphereCollision(Sphere * other)
 {
 	Collision collision(true, this, other);
 	// Start by assuming collision
-	glm::vec2 displacement = m_position - other->getPosition();
+	glm::vec2 displacement = getPosition() - other->getPosition();
 	if (displacement != glm::zero<glm::vec2>()) {
 		glm::vec2 minAxis;
 		float minOverlap = INFINITY;
 		std::array<glm::vec2, 4> corners = getCorners();
 		// Get axes to test: x, y, and circle to nearest corner
 
-		float xProjection = copysignf(m_xExtent, glm::dot(displacement, m_localX));
-		float yProjection = copysignf(m_yExtent, glm::dot(displacement, m_localY));
-		glm::vec2 minCircleToCorner = displacement - m_localX * xProjection - m_localY * yProjection;
+		float xProjection = copysignf(m_xExtent, glm::dot(displacement, getLocalX()));
+		float yProjection = copysignf(m_yExtent, glm::dot(displacement, getLocalY()));
+		glm::vec2 minCircleToCorner = displacement - getLocalX() * xProjection - getLocalY() * yProjection;
 		//float minCornerDistanceSqr = INFINITY;
 		//for (glm::vec2 corner : corners) {
 		//	glm::vec2 circleToCorner = corner - other->getPosition();
@@ -81,7 +95,7 @@ physics::Collision physics::Box::checkSphereCollision(Sphere * other)
 			// If corner in circle, axis is to center
 			minCircleToCorner = displacement;
 		}
-		glm::vec2 axes[3] = { m_localX, m_localY, glm::normalize(minCircleToCorner) };
+		glm::vec2 axes[3] = { getLocalX(), getLocalY(), glm::normalize(minCircleToCorner) };
 		// Test circle/box overlap on each axis
 		for(size_t a = 0; a < 3; ++a ) {
 			float boxMin = INFINITY;
@@ -123,13 +137,13 @@ physics::Collision physics::Box::checkSphereCollision(Sphere * other)
 		// Circle is at position
 		// Collision normal is towards shortest axis
 		if (m_xExtent < m_yExtent) {
-			collision.normal = m_localX;
-			collision.contact = m_position;
+			collision.normal = getLocalX();
+			collision.contact = getPosition();
 			collision.depth = m_xExtent + other->getRadius();
 		}
 		else {
-			collision.normal = m_localY;
-			collision.contact = m_position;
+			collision.normal = getLocalY();
+			collision.contact = getPosition();
 			collision.depth = m_yExtent + other->getRadius();
 		}
 	}
@@ -137,108 +151,124 @@ physics::Collision physics::Box::checkSphereCollision(Sphere * other)
 	return collision;
 }
 
+bool physics::Box::overlapsSphere(Sphere * other)
+{
+	// Closest point in box to sphere's centre, in box's space
+	glm::vec2 displacement = other->getPosition() - getPosition();
+	float x = glm::clamp(glm::dot(displacement, getLocalX()), -m_xExtent, m_xExtent);
+	float y = glm::clamp(glm::dot(displacement, getLocalY()), -m_yExtent, m_yExtent);
+	glm::vec2 closestToCentre = displacement - getLocalX() * x - getLocalY() * y;
+	return glm::dot(closestToCentre, closestToCentre) < other->getRadius() * other->getRadius();
+}
+
+bool physics::Box::overlapsBox(Box * other)
+{
+	float myReach[4];
+	float otherReach[4];
+	return projectOntoAxes(other, myReach, otherReach);
+}
+
 physics::Collision physics::Box::checkBoxCollision(Box * other)
 {
-	// Start by assuming collision
-	Collision collision(true, this, other);
-	std::array<glm::vec2, 4> myCorners = getCorners();
-	std::array<glm::vec2, 4> otherCorners = other->getCorners();
-	// Get axes to test
-	glm::vec2 axes[4] = { m_localX, m_localY, other->getLocalX(), other->getLocalY() };
+	Collision collision(false, this, other);
+	// How far each box reaches past the other along each axis, stopping if any axis separates them
+	float myReach[4], otherReach[4];
+	if (!projectOntoAxes(other, myReach, otherReach)) {
+		return collision;
+	}
+	collision.success = true;
+	glm::vec2 axes[4] = { getLocalX(), getLocalY(), other->getLocalX(), other->getLocalY() };
 	glm::vec2 minAxis;
+	unsigned int minFeature = 0;
 	float minOverlap = INFINITY;
-	float myDistance, otherDistance; // Distance of points from overlap along axis
 	for (size_t a = 0; a < 4; ++a) {
-		// Get min and max projections along axis
-		float myMin = INFINITY;
-		float otherMin = INFINITY;
-		float myMax = -INFINITY;
-		float otherMax = -INFINITY;
-		for (size_t i = 0; i < 4; ++i) {
-			float myProjection = glm::dot(axes[a], myCorners[i]);
-			float otherProjection = glm::dot(axes[a], otherCorners[i]);
-			myMin = std::min(myMin, myProjection);
-			myMax = std::max(myMax, myProjection);
-			otherMin = std::min(otherMin, otherProjection);
-			otherMax = std::max(otherMax, otherProjection);
-		}
-		// Check overlap
-		float overlap = std::min(myMax - otherMin, otherMax - myMin);
-		if (overlap <= 0) {
-			// If negative, collision fails
-			collision.success = false;
-			break;
-		}
-		else if (overlap < minOverlap) {
+		float overlap = std::min(myReach[a], otherReach[a]);
+		if (overlap < minOverlap * k_axis_preference) {
 			// If new minimum, set as axis of collision
 			minOverlap = overlap;
-			if (myMax - otherMin < otherMax - myMin) {
+			if (myReach[a] < otherReach[a]) {
 				minAxis = -axes[a];
-				myDistance = -myMax;
-				otherDistance = -otherMin;
+				minFeature = 2 * (unsigned int)a + 1;
 			}
 			else {
 				minAxis = axes[a];
-				myDistance = myMin;
-				otherDistance = otherMax;
+				minFeature = 2 * (unsigned int)a;
 			}
 		}
 	}
-	if (collision.success) {
-		collision.normal = minAxis;
-		collision.depth = minOverlap;
-		// Find best edges involved in collision
-		Edge myEdge = findBestEdge(-minAxis);
-		Edge otherEdge = other->findBestEdge(minAxis);
-		// Clip each edge's endpoints to within the other
-		otherEdge.clip(myEdge.direction, glm::dot(myEdge.direction, myEdge.start));
-		otherEdge.clip(-myEdge.direction, glm::dot(-myEdge.direction, myEdge.end));
-		myEdge.clip(otherEdge.direction, glm::dot(otherEdge.direction, otherEdge.start));
-		myEdge.clip(-otherEdge.direction, glm::dot(-otherEdge.direction, otherEdge.end));
-		//  check for intersection to determine if triangle or quad manifold
-		glm::vec2 intersection;
-		bool linesIntersect = myEdge.checkIntersection(otherEdge, intersection);
-		if (linesIntersect) {
-			// Figure out which other two points define manifold
-			float otherAlignment = glm::dot(otherEdge.direction, collision.normal);
-			float myAlignment = glm::dot(myEdge.direction, collision.normal);
-			glm::vec2 myPoint, otherPoint;
-			// Check which edge is less perpendicular to collision normal
-			if (abs(otherAlignment) > abs(myAlignment)) {
-				if (otherAlignment > 0) {
-					// End of other is closest to me
-					otherPoint = otherEdge.end;
-					myPoint = myEdge.start;	// Known through winding
-				}
-				else {
-					// Start of other is closest to me
-					otherPoint = otherEdge.start;
-					myPoint = myEdge.end; // Known through winding
-				}
+	collision.normal = minAxis;
+	collision.depth = minOverlap;
+	// Separating axis identifies which faces are in contact
+	collision.feature = minFeature;
+	// Find best edges involved in collision
+	Edge myEdge = findBestEdge(-minAxis);
+	Edge otherEdge = other->findBestEdge(minAxis);
+	// Edge of box whose axis separates them least is the reference, the other edge is incident on it
+	bool myReference = minFeature < 4;
+	Edge reference = myReference ? myEdge : otherEdge;
+	Edge incident = myReference ? otherEdge : myEdge;
+	// Clip each edge's endpoints to within the other
+	otherEdge.clip(myEdge.direction, glm::dot(myEdge.direction, myEdge.start));
+	otherEdge.clip(-myEdge.direction, glm::dot(-myEdge.direction, myEdge.end));
+	myEdge.clip(otherEdge.direction, glm::dot(otherEdge.direction, otherEdge.start));
+	myEdge.clip(-otherEdge.direction, glm::dot(-otherEdge.direction, otherEdge.end));
+	//  check for intersection to determine if triangle or quad manifold
+	glm::vec2 intersection;
+	bool linesIntersect = myEdge.checkIntersection(otherEdge, intersection);
+	if (linesIntersect) {
+		// Figure out which other two points define manifold
+		float otherAlignment = glm::dot(otherEdge.direction, collision.normal);
+		float myAlignment = glm::dot(myEdge.direction, collision.normal);
+		glm::vec2 myPoint, otherPoint;
+		// Check which edge is less perpendicular to collision normal
+		if (abs(otherAlignment) > abs(myAlignment)) {
+			if (otherAlignment > 0) {
+				// End of other is closest to me
+				otherPoint = otherEdge.end;
+				myPoint = myEdge.start;	// Known through winding
 			}
 			else {
-				// Since normal points to this, opposite of above case
-				if (myAlignment > 0) {
-					// My start is further behind edge
-					myPoint = myEdge.start;
-					otherPoint = otherEdge.end;
-				}
-				else {
-					// My end is further behind edge
-					myPoint = myEdge.end;
-					otherPoint = otherEdge.start;
-				}
+				// Start of other is closest to me
+				otherPoint = otherEdge.start;
+				myPoint = myEdge.end; // Known through winding
 			}
-			// Triangle centroid is average
-			collision.contact = (myPoint + otherPoint + intersection) * (1.f / 3.f);
 		}
 		else {
-			// Quadrilateral manifold
-			// HACK maybe try centroid calculation?
-			// Average 
-			collision.contact = 0.25f * (myEdge.start + myEdge.end + otherEdge.start + otherEdge.end);
+			// Since normal points to this, opposite of above case
+			if (myAlignment > 0) {
+				// My start is further behind edge
+				myPoint = myEdge.start;
+				otherPoint = otherEdge.end;
+			}
+			else {
+				// My end is further behind edge
+				myPoint = myEdge.end;
+				otherPoint = otherEdge.start;
+			}
+		}
+		// Triangle centroid is average
+		collision.contact = (myPoint + otherPoint + intersection) * (1.f / 3.f);
+	}
+	else {
+		// Quadrilateral manifold
+		// HACK maybe try centroid calculation?
+		// Average 
+		collision.contact = 0.25f * (myEdge.start + myEdge.end + otherEdge.start + otherEdge.end);
+	}
+
+	// Manifold is made of incident edge's endpoints which are behind reference edge, after
+	// clipping incident edge to reference edge's sides
+	incident.clip(reference.direction, glm::dot(reference.direction, reference.start));
+	incident.clip(-reference.direction, glm::dot(-reference.direction, reference.end));
+	glm::vec2 referenceNormal = reference.getNormal();
+	float referenceOffset = glm::dot(referenceNormal, reference.start);
+	glm::vec2 endpoints[2] = { incident.start, incident.end };
+	for (unsigned int i = 0; i < 2; ++i) {
+		float separation = glm::dot(referenceNormal, endpoints[i]) - referenceOffset;
+		if (separation < 0) {
+			// Point of contact is halfway between incident point and reference edge
+			collision.addPoint(endpoints[i] - 0.5f * separation * referenceNormal, -separation, i);
 		}
-		
 	}
 	return collision;
 }
@@ -246,28 +276,22 @@ physics::Collision physics::Box::checkBoxCollision(Box * other)
 void physics::Box::calculateMoment()
 {
 	// based on 1/12 * m * width * height. Some sources say 1/12 * mass * (width^2 + height^2)
-	m_moment = (4.f / 12.f) * m_mass * m_xExtent * m_yExtent;	// 4/12 because extents are half total
-	if (m_moment == INFINITY) {
-		m_invMoment = 0;
-	}
-	else {
-		m_invMoment = 1.f / m_moment;
-	}
+	setMoment((4.f / 12.f) * m_mass * m_xExtent * m_yExtent);	// 4/12 because extents are half total
 }
 
 physics::Collision physics::Box::checkPlaneCollision(Plane * other)
 {
 	Collision collision(false, this, other);
 	std::array<glm::vec2, 4> corners = getCorners();
+	std::array<float, 4> distances;
 	float minDistance = INFINITY;
 	float sumDepth = 0;
 	glm::vec2 contact = { 0,0 };
 	// Check each corner's distance to plane, and get lowest
 	for (size_t i = 0; i < 4; ++i) {
 		float distance = other->distanceToPoint(corners[i]);
-		if (distance < minDistance) {
-			minDistance = distance;
-		}
+		distances[i] = distance;
+		minDistance = std::min(minDistance, distance);
 		if (distance < 0) {
 			// If colliding, add to contact for weighted average
 			collision.success = true;
@@ -279,6 +303,12 @@ physics::Collision physics::Box::checkPlaneCollision(Plane * other)
 		collision.depth = -minDistance;
 		collision.normal = other->getNormal();
 		collision.contact = contact / sumDepth;
+		// Deepest corners make up manifold, identified by their index
+		std::array<size_t, 4> order = { 0,1,2,3 };
+		std::sort(order.begin(), order.end(), [&distances](size_t a, size_t b) { return distances[a] < distances[b]; });
+		for (size_t i = 0; i < Collision::k_max_points && distances[order[i]] < 0; ++i) {
+			collision.addPoint(corners[order[i]], -distances[order[i]], (unsigned int)order[i]);
+		}
 	}
 	return collision;
 }
@@ -295,7 +325,7 @@ float physics::Box::getWidth()
 
 void physics::Box::setWidth(float width)
 {
-	if (width <= 0 || isnan(width) || isinf(width)) {
+	if (width <= 0 || std::isnan(width) || std::isinf(width)) {
 		throw std::invalid_argument("Width must be positive and finite");
 	}
 	m_xExtent = 0.5f * width;
@@ -309,7 +339,7 @@ float physics::Box::getHeight()
 
 void physics::Box::setHeight(float height)
 {
-	if (height <= 0 || isnan(height) || isinf(height)) {
+	if (height <= 0 || std::isnan(height) || std::isinf(height)) {
 		throw std::invalid_argument("Height must be positive and finite");
 	}
 	m_yExtent = 0.5f * height;
@@ -323,20 +353,71 @@ float physics::Box::getDiagonalLength()
 
 glm::vec2 physics::Box::getXExtent()
 {
-	return m_localX * m_xExtent;
+	return getLocalX() * m_xExtent;
 }
 
 glm::vec2 physics::Box::getYExtent()
 {
-	return m_localY * m_yExtent;
+	return getLocalY() * m_yExtent;
+}
+
+bool physics::Box::projectOntoAxes(Box * other, float myReach[4], float otherReach[4])
+{
+	glm::vec2 axes[4] = { getLocalX(), getLocalY(), other->getLocalX(), other->getLocalY() };
+	std::array<glm::vec2, 4> myCorners = getCorners();
+	std::array<glm::vec2, 4> otherCorners = other->getCorners();
+#ifdef PHYSICS_SIMD
+	// One axis per lane, so each corner is projected onto all four axes at once
+	__m128 axisX = _mm_setr_ps(axes[0].x, axes[1].x, axes[2].x, axes[3].x);
+	__m128 axisY = _mm_setr_ps(axes[0].y, axes[1].y, axes[2].y, axes[3].y);
+	__m128 myMin = _mm_set1_ps(INFINITY);
+	__m128 otherMin = _mm_set1_ps(INFINITY);
+	__m128 myMax = _mm_set1_ps(-INFINITY);
+	__m128 otherMax = _mm_set1_ps(-INFINITY);
+	for (size_t i = 0; i < 4; ++i) {
+		__m128 myProjection = _mm_add_ps(_mm_mul_ps(axisX, _mm_set1_ps(myCorners[i].x)), _mm_mul_ps(axisY, _mm_set1_ps(myCorners[i].y)));
+		__m128 otherProjection = _mm_add_ps(_mm_mul_ps(axisX, _mm_set1_ps(otherCorners[i].x)), _mm_mul_ps(axisY, _mm_set1_ps(otherCorners[i].y)));
+		myMin = _mm_min_ps(myMin, myProjection);
+		myMax = _mm_max_ps(myMax, myProjection);
+		otherMin = _mm_min_ps(otherMin, otherProjection);
+		otherMax = _mm_max_ps(otherMax, otherProjection);
+	}
+	__m128 mine = _mm_sub_ps(myMax, otherMin);
+	__m128 others = _mm_sub_ps(otherMax, myMin);
+	_mm_storeu_ps(myReach, mine);
+	_mm_storeu_ps(otherReach, others);
+	return _mm_movemask_ps(_mm_cmple_ps(_mm_min_ps(mine, others), _mm_setzero_ps())) == 0;
+#else
+	for (size_t a = 0; a < 4; ++a) {
+		// Get min and max projections along axis
+		float myMin = INFINITY;
+		float otherMin = INFINITY;
+		float myMax = -INFINITY;
+		float otherMax = -INFINITY;
+		for (size_t i = 0; i < 4; ++i) {
+			float myProjection = glm::dot(axes[a], myCorners[i]);
+			float otherProjection = glm::dot(axes[a], otherCorners[i]);
+			myMin = std::min(myMin, myProjection);
+			myMax = std::max(myMax, myProjection);
+			otherMin = std::min(otherMin, otherProjection);
+			otherMax = std::max(otherMax, otherProjection);
+		}
+		myReach[a] = myMax - otherMin;
+		otherReach[a] = otherMax - myMin;
+		if (std::min(myReach[a], otherReach[a]) <= 0) {
+			return false;
+		}
+	}
+	return true;
+#endif
 }
 
 std::array<glm::vec2, 4> physics::Box::getCorners()
 {
-	glm::vec2 x = m_xExtent * m_localX;
-	glm::vec2 y = m_yExtent * m_localY;
-	return { m_position - x - y, m_position + x - y,
-			 m_position + x + y, m_position - x + y };
+	glm::vec2 x = m_xExtent * getLocalX();
+	glm::vec2 y = m_yExtent * getLocalY();
+	return { getPosition() - x - y, getPosition() + x - y,
+			 getPosition() + x + y, getPosition() - x + y };
 }
 
 physics::Edge physics::Box::findBestEdge(glm::vec2 normal)
@@ -344,32 +425,32 @@ physics::Edge physics::Box::findBestEdge(glm::vec2 normal)
 	Edge edge;
 	glm::vec2 first, second, direction;
 	bool positive;
-	float x = glm::dot(normal, m_localX);
-	float y = glm::dot(normal, m_localY);
+	float x = glm::dot(normal, getLocalX());
+	float y = glm::dot(normal, getLocalY());
 	
 	// Figure out if best edge is on x or y axis
 	if (abs(x) > abs(y)) {
-		first = m_localX * m_xExtent - m_localY * m_yExtent;
-		second = m_localX * m_xExtent + m_localY * m_yExtent;
-		direction = m_localY;
+		first = getLocalX() * m_xExtent - getLocalY() * m_yExtent;
+		second = getLocalX() * m_xExtent + getLocalY() * m_yExtent;
+		direction = getLocalY();
 		positive = x > 0;
 	}
 	else {
-		first = m_localY * m_yExtent + m_localX * m_xExtent;
-		second = m_localY * m_yExtent - m_localX * m_xExtent;
-		direction = -m_localX;
+		first = getLocalY() * m_yExtent + getLocalX() * m_xExtent;
+		second = getLocalY() * m_yExtent - getLocalX() * m_xExtent;
+		direction = -getLocalX();
 		positive = y > 0;
 	}
 
 	// If on negative side, reverse vectors
 	if (positive) {
-		edge.start = m_position + first;
-		edge.end = m_position + second;
+		edge.start = getPosition() + first;
+		edge.end = getPosition() + second;
 		edge.direction = direction;
 	}
 	else {
-		edge.start = m_position - first;
-		edge.end = m_position - second;
+		edge.start = getPosition() - first;
+		edge.end = getPosition() - second;
 		edge.direction = -direction;
 	}
 	return edge;
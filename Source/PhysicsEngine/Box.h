@@ -33,6 +33,10 @@ namespace physics {
 	// Oriented box object
 	class Box : public RigidBody {
 	public:
+		// Another axis must have this proportion of the overlap on an earlier axis to be chosen as the
+		// collision normal, so nearly aligned boxes don't switch reference face between steps
+		static const float k_axis_preference;
+
 		Box(glm::vec2 position, float width, float height, float orientation,
 			glm::vec2 velocity = { 0,0 }, float angularVelocity = 0, float mass = 1.f,
 			float elasticity = 1.f, float friction = 0.f, float drag = 0.f, float angularDrag = 0.f, glm::vec4 colour = { 1,1,1,1 });
@@ -40,16 +44,23 @@ namespace physics {
 		Box(const Box& other);
 
 		virtual PhysicsObject* clone();
+		virtual PhysicsObjectPtr poolClone(ObjectPools& pools);
 
-		virtual void makeGizmo(float timeRatio);
+		virtual bool extractDrawRecord(float timeRatio, DrawRecord& record);
 
 		virtual bool isPointInside(glm::vec2 point);
 
+		virtual AABB getAABB();
+
 		virtual Collision checkCollision(PhysicsObject* other);
 		virtual Collision checkSphereCollision(Sphere* other);
 		virtual Collision checkBoxCollision(Box* other);
 		virtual Collision checkPlaneCollision(Plane* other);
 
+		// Return whether objects overlap, without finding contact details
+		bool overlapsSphere(Sphere* other);
+		bool overlapsBox(Box* other);
+
 		virtual ShapeType getShapeID();
 
 		virtual float getWidth();
@@ -75,6 +86,11 @@ namespace physics {
 		float m_yExtent;
 
 		virtual void calculateMoment();
+
+		// Projects both boxes' corners onto each box's axes, in order my x, my y, other's x, other's y
+		// Sets how far past the other's projection each box reaches along each axis, and returns false
+		// if any axis separates the boxes
+		bool projectOntoAxes(Box* other, float myReach[4], float otherReach[4]);
 	};
 
 
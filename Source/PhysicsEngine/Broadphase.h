@@ -0,0 +1,30 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "PhysicsObject.h"
+
+namespace physics {
+
+	// Pair of objects whose bounds overlap, to be tested by narrowphase
+	// first was added to the scene before second
+	struct BroadphasePair {
+		BroadphasePair(PhysicsObject* a_first = nullptr, PhysicsObject* a_second = nullptr, size_t a_firstID = 0, size_t a_secondID = 0,
+			ShapeType a_firstShape = ShapeType::spring, ShapeType a_secondShape = ShapeType::spring)
+			: first(a_first), second(a_second), firstID(a_firstID), secondID(a_secondID), firstShape(a_firstShape), secondShape(a_secondShape)
+		{};
+
+		PhysicsObject* first;
+		PhysicsObject* second;
+
+		// Order in which objects were added, used to sort pairs into a stable order
+		size_t firstID;
+		size_t secondID;
+
+		// Shapes of objects, cached so narrowphase can choose a kernel without virtual calls
+		ShapeType firstShape;
+		ShapeType secondShape;
+
+		bool operator<(const BroadphasePair& other) const {
+			return firstID < other.firstID || (firstID == other.firstID && secondID < other.secondID);
+		}
+	};
+}
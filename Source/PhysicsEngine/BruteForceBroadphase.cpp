@@ -0,0 +1,58 @@
+#include "BruteForceBroadphase.h"
+#include "PhysicsObject.h"
+
+physics::BruteForceBroadphase::BruteForceBroadphase() : m_nextID(0)
+{
+}
+
+void physics::BruteForceBroadphase::add(PhysicsObject * object)
+{
+	m_proxies.push_back({ object, m_nextID, object->getShapeID() });
+	++m_nextID;
+}
+
+void physics::BruteForceBroadphase::remove(PhysicsObject * object)
+{
+	m_proxies.erase(std::remove_if(m_proxies.begin(), m_proxies.end(), [object](const Proxy& p) {return p.object == object; }), m_proxies.end());
+}
+
+void physics::BruteForceBroadphase::removeDead()
+{
+	m_proxies.erase(std::remove_if(m_proxies.begin(), m_proxies.end(), [](const Proxy& p) {return !p.object->isAlive(); }), m_proxies.end());
+}
+
+void physics::BruteForceBroadphase::clear()
+{
+	m_proxies.clear();
+	m_pairs.clear();
+}
+
+void physics::BruteForceBroadphase::queryAABB(const AABB & bounds, std::vector<PhysicsObject*>& results)
+{
+	for (const Proxy& proxy : m_proxies) {
+		if (proxy.object->getAABB().overlaps(bounds)) {
+			results.push_back(proxy.object);
+		}
+	}
+}
+
+void physics::BruteForceBroadphase::queryPoint(glm::vec2 point, std::vector<PhysicsObject*>& results)
+{
+	for (const Proxy& proxy : m_proxies) {
+		if (proxy.object->isPointInside(point)) {
+			results.push_back(proxy.object);
+		}
+	}
+}
+
+void physics::BruteForceBroadphase::findPairs()
+{
+	m_pairs.clear();
+	for (auto first = m_proxies.begin(); first != m_proxies.end(); ++first) {
+		for (auto second = std::next(first, 1); second != m_proxies.end(); ++second) {
+			if (!first->object->isStatic() || !second->object->isStatic()) {
+				m_pairs.push_back(BroadphasePair(first->object, second->object, first->id, second->id, first->shape, second->shape));
+			}
+		}
+	}
+}
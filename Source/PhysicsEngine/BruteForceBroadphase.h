@@ -0,0 +1,41 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "IBroadphase.h"
+
+namespace physics {
+	class PhysicsObject;
+
+	// Broadphase which passes every pair of objects to the narrowphase, unless both are static
+	// Slow for large scenes, but useful as a baseline to compare other broadphases against
+	class BruteForceBroadphase : public IBroadphase {
+	public:
+		BruteForceBroadphase();
+
+		virtual BroadphaseType getType() { return brute_force; }
+
+		virtual void add(PhysicsObject* object);
+		virtual void remove(PhysicsObject* object);
+		virtual void removeDead();
+		virtual void clear();
+
+		virtual const std::vector<BroadphasePair>& getPairs() { return m_pairs; }
+
+		virtual size_t getProxyCount() { return m_proxies.size(); }
+
+		virtual void queryAABB(const AABB& bounds, std::vector<PhysicsObject*>& results);
+		virtual void queryPoint(glm::vec2 point, std::vector<PhysicsObject*>& results);
+
+	protected:
+		struct Proxy {
+			PhysicsObject* object;
+			size_t id;		// Order in which object was added
+			ShapeType shape;
+		};
+
+		std::vector<Proxy> m_proxies;	// In the order objects were added
+		std::vector<BroadphasePair> m_pairs;
+		size_t m_nextID;
+
+		virtual void findPairs();
+	};
+}
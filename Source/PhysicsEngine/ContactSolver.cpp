@@ -0,0 +1,309 @@
+#include "ContactSolver.h"
+#include "RigidBody.h"
+
+#include <stdexcept>
+
+const float physics::ContactSolver::k_restitution_threshold = 0.5f;
+const float physics::ContactSolver::k_slop = 0.005f;
+
+// Returns z component of cross product of 2D vectors
+static float cross(glm::vec2 a, glm::vec2 b)
+{
+	return a.x * b.y - a.y * b.x;
+}
+
+physics::ContactSolver::ContactSolver()
+	: m_cache(0, ContactKeyHash(), std::equal_to<ContactKey>(), CacheAllocator(std::make_shared<PoolStorage>())),
+	m_step(0), m_iterations(k_def_iterations), m_positionIterations(k_def_position_iterations), m_warmStarting(true)
+{
+}
+
+void physics::ContactSolver::addCollision(const Collision & collision)
+{
+	if (collision.first->isTrigger() || collision.second->isTrigger()) {
+		return;
+	}
+	// Only rigidbodies can be moved by collisions
+	RigidBody* body1 = nullptr;
+	RigidBody* body2 = nullptr;
+	ShapeType firstShape = collision.first->getShapeID();
+	ShapeType secondShape = collision.second->getShapeID();
+	if (firstShape == sphere || firstShape == obox) {
+		body1 = static_cast<RigidBody*>(collision.first);
+	}
+	if (secondShape == sphere || secondShape == obox) {
+		body2 = static_cast<RigidBody*>(collision.second);
+	}
+	if (!(body1 != nullptr && body1->isDynamic()) && !(body2 != nullptr && body2->isDynamic())) {
+		return;
+	}
+
+	auto found = m_cache.find(ContactKey(collision.first, collision.second));
+	ContactManifold* manifold;
+	if (found == m_cache.end()) {
+		manifold = &m_cache[ContactKey(collision.first, collision.second)];
+		manifold->first = collision.first;
+		manifold->second = collision.second;
+		manifold->pointCount = 0;
+	}
+	else {
+		manifold = &found->second;
+	}
+	if (manifold->pointCount > 0 && manifold->feature != collision.feature) {
+		// Different features in contact, so old impulses don't apply
+		manifold->pointCount = 0;
+	}
+	manifold->body1 = body1;
+	manifold->body2 = body2;
+	manifold->normal = collision.normal;
+	manifold->friction = PhysicsObject::combineFriction(collision.first, collision.second);
+	manifold->elasticity = PhysicsObject::combineElasticity(collision.first, collision.second);
+	manifold->feature = collision.feature;
+	manifold->lastStep = m_step;
+
+	// Shapes without a manifold have a single point of contact
+	ManifoldPoint single = { collision.contact, collision.depth, 0 };
+	const ManifoldPoint* points = (collision.pointCount > 0) ? collision.points : &single;
+	size_t pointCount = (collision.pointCount > 0) ? collision.pointCount : 1;
+
+	ContactPoint oldPoints[Collision::k_max_points];
+	size_t oldCount = manifold->pointCount;
+	std::copy(manifold->points, manifold->points + oldCount, oldPoints);
+	for (size_t i = 0; i < pointCount; ++i) {
+		ContactPoint& point = manifold->points[i];
+		point.position = points[i].position;
+		point.depth = points[i].depth;
+		point.feature = points[i].feature;
+		point.normalImpulse = 0;
+		point.tangentImpulse = 0;
+		// Carry over impulses from matching point last step
+		for (size_t j = 0; j < oldCount; ++j) {
+			if (oldPoints[j].feature == point.feature) {
+				point.normalImpulse = oldPoints[j].normalImpulse;
+				point.tangentImpulse = oldPoints[j].tangentImpulse;
+				break;
+			}
+		}
+	}
+	manifold->pointCount = pointCount;
+	m_active.push_back(manifold);
+}
+
+void physics::ContactSolver::solve()
+{
+	for (ContactManifold* manifold : m_active) {
+		prepare(*manifold);
+	}
+	for (size_t i = 0; i < m_iterations; ++i) {
+		for (ContactManifold* manifold : m_active) {
+			solveVelocity(*manifold);
+		}
+	}
+	for (ContactManifold* manifold : m_active) {
+		manifold->start1 = (manifold->body1 != nullptr) ? manifold->body1->getPosition() : glm::vec2(0);
+		manifold->start2 = (manifold->body2 != nullptr) ? manifold->body2->getPosition() : glm::vec2(0);
+	}
+	for (size_t i = 0; i < m_positionIterations; ++i) {
+		for (ContactManifold* manifold : m_active) {
+			correctPosition(*manifold);
+		}
+	}
+	m_active.clear();
+
+	// Drop manifolds for pairs no longer in contact
+	for (auto it = m_cache.begin(); it != m_cache.end();) {
+		if (it->second.lastStep != m_step) {
+			it = m_cache.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	++m_step;
+}
+
+void physics::ContactSolver::setIterations(size_t iterations)
+{
+	if (iterations == 0) {
+		throw std::invalid_argument("Solver must run at least one iteration");
+	}
+	m_iterations = iterations;
+}
+
+void physics::ContactSolver::setPositionIterations(size_t iterations)
+{
+	if (iterations == 0) {
+		throw std::invalid_argument("Solver must run at least one position iteration");
+	}
+	m_positionIterations = iterations;
+}
+
+void physics::ContactSolver::clear()
+{
+	m_cache.clear();
+	m_active.clear();
+}
+
+void physics::ContactSolver::forget(PhysicsObject * object)
+{
+	for (auto it = m_cache.begin(); it != m_cache.end();) {
+		if (it->first.first == object || it->first.second == object) {
+			it = m_cache.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+void physics::ContactSolver::forgetDead()
+{
+	for (auto it = m_cache.begin(); it != m_cache.end();) {
+		if (!it->first.first->isAlive() || !it->first.second->isAlive()) {
+			it = m_cache.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+const physics::ContactManifold * physics::ContactSolver::findManifold(PhysicsObject * first, PhysicsObject * second)
+{
+	auto found = m_cache.find(ContactKey(first, second));
+	if (found == m_cache.end()) {
+		found = m_cache.find(ContactKey(second, first));
+	}
+	return (found == m_cache.end()) ? nullptr : &found->second;
+}
+
+void physics::ContactSolver::prepare(ContactManifold & manifold)
+{
+	glm::vec2 normal = manifold.normal;
+	glm::vec2 tangent(-normal.y, normal.x);
+	for (size_t i = 0; i < manifold.pointCount; ++i) {
+		ContactPoint& point = manifold.points[i];
+
+		float invMass = 0;
+		float invNormalMoment = 0;
+		float invTangentMoment = 0;
+		if (manifold.body1 != nullptr) {
+			point.r1 = point.position - manifold.body1->getPosition();
+			float rn = cross(point.r1, normal);
+			float rt = cross(point.r1, tangent);
+			invMass += manifold.body1->getInvMass();
+			invNormalMoment += rn * rn * manifold.body1->getInvMoment();
+			invTangentMoment += rt * rt * manifold.body1->getInvMoment();
+		}
+		if (manifold.body2 != nullptr) {
+			point.r2 = point.position - manifold.body2->getPosition();
+			float rn = cross(point.r2, normal);
+			float rt = cross(point.r2, tangent);
+			invMass += manifold.body2->getInvMass();
+			invNormalMoment += rn * rn * manifold.body2->getInvMoment();
+			invTangentMoment += rt * rt * manifold.body2->getInvMoment();
+		}
+		point.normalMass = 1.f / (invMass + invNormalMoment);
+		point.tangentMass = 1.f / (invMass + invTangentMoment);
+
+		// Bounce back at a proportion of approach speed
+		float normalVelocity = glm::dot(relativeVelocity(manifold, point), normal);
+		point.velocityBias = 0;
+		if (normalVelocity < -k_restitution_threshold) {
+			point.velocityBias = -manifold.elasticity * normalVelocity;
+		}
+	}
+
+	for (size_t i = 0; i < manifold.pointCount; ++i) {
+		ContactPoint& point = manifold.points[i];
+		if (m_warmStarting) {
+			applyImpulse(manifold, point.normalImpulse * normal + point.tangentImpulse * tangent, point.position);
+		}
+		else {
+			point.normalImpulse = 0;
+			point.tangentImpulse = 0;
+		}
+	}
+}
+
+void physics::ContactSolver::solveVelocity(ContactManifold & manifold)
+{
+	glm::vec2 normal = manifold.normal;
+	glm::vec2 tangent(-normal.y, normal.x);
+
+	for (size_t i = 0; i < manifold.pointCount; ++i) {
+		ContactPoint& point = manifold.points[i];
+
+		// Normal impulse, clamping total so objects are only pushed apart
+		float normalVelocity = glm::dot(relativeVelocity(manifold, point), normal);
+		float impulse = point.normalMass * (point.velocityBias - normalVelocity);
+		float oldImpulse = point.normalImpulse;
+		point.normalImpulse = std::max(oldImpulse + impulse, 0.f);
+		applyImpulse(manifold, (point.normalImpulse - oldImpulse) * normal, point.position);
+
+		// Friction impulse, clamping total to within friction cone
+		float tangentVelocity = glm::dot(relativeVelocity(manifold, point), tangent);
+		float frictionImpulse = -point.tangentMass * tangentVelocity;
+		float maxFriction = manifold.friction * point.normalImpulse;
+		float oldFriction = point.tangentImpulse;
+		point.tangentImpulse = std::max(std::min(oldFriction + frictionImpulse, maxFriction), -maxFriction);
+		applyImpulse(manifold, (point.tangentImpulse - oldFriction) * tangent, point.position);
+	}
+}
+
+void physics::ContactSolver::correctPosition(ContactManifold & manifold)
+{
+	// Bodies are only moved, not rotated, so deepest point must be cleared
+	float depth = 0;
+	for (size_t i = 0; i < manifold.pointCount; ++i) {
+		depth = std::max(depth, manifold.points[i].depth);
+	}
+	// Take off separation already gained by moving either body
+	float invMass1 = 0;
+	float invMass2 = 0;
+	glm::vec2 moved(0);
+	if (manifold.body1 != nullptr) {
+		invMass1 = manifold.body1->getInvMass();
+		moved += manifold.body1->getPosition() - manifold.start1;
+	}
+	if (manifold.body2 != nullptr) {
+		invMass2 = manifold.body2->getInvMass();
+		moved -= manifold.body2->getPosition() - manifold.start2;
+	}
+	float remaining = depth - k_slop - glm::dot(moved, manifold.normal);
+	if (remaining <= 0 || invMass1 + invMass2 == 0) {
+		return;
+	}
+	// Lighter object moves further
+	glm::vec2 displacement = manifold.normal * (remaining / (invMass1 + invMass2));
+	if (invMass1 != 0) {
+		manifold.body1->setPosition(manifold.body1->getPosition() + displacement * invMass1);
+	}
+	if (invMass2 != 0) {
+		manifold.body2->setPosition(manifold.body2->getPosition() - displacement * invMass2);
+	}
+}
+
+void physics::ContactSolver::applyImpulse(ContactManifold & manifold, glm::vec2 impulse, glm::vec2 contact)
+{
+	if (manifold.body1 != nullptr) {
+		manifold.body1->applyImpulse(impulse, contact);
+	}
+	if (manifold.body2 != nullptr) {
+		manifold.body2->applyImpulse(-impulse, contact);
+	}
+}
+
+glm::vec2 physics::ContactSolver::relativeVelocity(const ContactManifold & manifold, const ContactPoint & point)
+{
+	glm::vec2 velocity(0);
+	if (manifold.body1 != nullptr) {
+		float w = manifold.body1->getAngularVelocity();
+		velocity += manifold.body1->getVelocity() + w * glm::vec2(-point.r1.y, point.r1.x);
+	}
+	if (manifold.body2 != nullptr) {
+		float w = manifold.body2->getAngularVelocity();
+		velocity -= manifold.body2->getVelocity() + w * glm::vec2(-point.r2.y, point.r2.x);
+	}
+	return velocity;
+}
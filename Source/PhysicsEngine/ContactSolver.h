@@ -0,0 +1,131 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "PhysicsObject.h"
+#include "ObjectPool.h"
+
+#include <unordered_map>
+
+namespace physics {
+	class RigidBody;
+
+	// Point of contact between two objects, kept between steps while objects stay in contact
+	struct ContactPoint {
+		glm::vec2 position;
+		float depth;
+		unsigned int feature;	// Identifies point within manifold, to match points between steps
+
+		// Impulses accumulated by solver, used to warm start next step
+		float normalImpulse;
+		float tangentImpulse;
+
+		// Calculated at start of each solve
+		glm::vec2 r1;			// Contact relative to first body
+		glm::vec2 r2;			// Contact relative to second body
+		float normalMass;		// Effective mass along normal
+		float tangentMass;		// Effective mass along tangent
+		float velocityBias;		// Target normal velocity, for restitution
+	};
+
+	// Set of contact points between a pair of objects
+	struct ContactManifold {
+		PhysicsObject* first;
+		PhysicsObject* second;
+		RigidBody* body1;		// First object as a rigidbody, or nullptr if immovable (such as a plane)
+		RigidBody* body2;
+		glm::vec2 normal;		// Points towards first object
+		float friction;
+		float elasticity;
+		unsigned int feature;	// Identifies features of shapes in contact
+		ContactPoint points[Collision::k_max_points];
+		size_t pointCount;
+		unsigned int lastStep;	// Step on which manifold was last found colliding
+		glm::vec2 start1;		// Body positions at start of position correction
+		glm::vec2 start2;
+	};
+
+	// Sequential impulse solver for collisions
+	// All collisions found in a step are gathered first, then impulses are applied to every contact
+	// point in turn over several iterations, so contacts in piles and stacks converge together.
+	// Manifolds are cached by object pair between steps. Impulses accumulated for a contact are
+	// applied again at the start of the next step (warm starting), so resting contacts start close to
+	// their solution and need fewer iterations.
+	class ContactSolver {
+	public:
+		static const size_t k_def_iterations = 4;
+		static const size_t k_def_position_iterations = 2;
+		static const float k_restitution_threshold;	// Approach speed below which contacts don't bounce
+		static const float k_slop;	// Overlap left by position correction, so resting contacts persist between steps
+
+		ContactSolver();
+
+		// Adds collision to be solved in the next call to solve
+		// Collisions involving triggers, or no dynamic bodies, are ignored
+		void addCollision(const Collision& collision);
+
+		// Solves velocities then positions of all collisions added since last solve, then drops
+		// manifolds not added this step
+		void solve();
+
+		// Drops all cached manifolds
+		void clear();
+
+		// Drops cached manifolds involving object, so a new object later made at the same address
+		// doesn't warm start from impulses found for this one
+		void forget(PhysicsObject* object);
+
+		// Drops cached manifolds involving any dead object, in one pass over the cache
+		void forgetDead();
+
+		// Number of velocity iterations each step
+		size_t getIterations() { return m_iterations; }
+		void setIterations(size_t iterations);
+
+		// Number of position correction iterations each step
+		size_t getPositionIterations() { return m_positionIterations; }
+		void setPositionIterations(size_t iterations);
+
+		bool isWarmStarting() { return m_warmStarting; }
+		void setWarmStarting(bool value) { m_warmStarting = value; }
+
+		// Returns number of manifolds being solved this step
+		size_t getContactCount() { return m_active.size(); }
+
+		// Returns cached manifold for pair, or nullptr if they aren't in contact
+		const ContactManifold* findManifold(PhysicsObject* first, PhysicsObject* second);
+
+	protected:
+		typedef std::pair<PhysicsObject*, PhysicsObject*> ContactKey;
+
+		struct ContactKeyHash {
+			size_t operator()(const ContactKey& key) const {
+				std::hash<PhysicsObject*> hasher;
+				return hasher(key.first) ^ (hasher(key.second) * 31);
+			}
+		};
+
+		typedef PoolAllocator<std::pair<const ContactKey, ContactManifold>> CacheAllocator;
+
+		// Entries come from a pool, so contacts starting and ending reuse memory rather than the heap
+		std::unordered_map<ContactKey, ContactManifold, ContactKeyHash, std::equal_to<ContactKey>, CacheAllocator> m_cache;
+		std::vector<ContactManifold*> m_active;	// Manifolds to solve this step, in order collisions were added
+		unsigned int m_step;
+		size_t m_iterations;
+		size_t m_positionIterations;
+		bool m_warmStarting;
+
+		// Calculates masses and bias for each contact, and applies warm start impulses
+		void prepare(ContactManifold& manifold);
+
+		// Applies impulses to move each contact towards its solution
+		void solveVelocity(ContactManifold& manifold);
+
+		// Pushes objects apart by overlap remaining after earlier corrections this step
+		void correctPosition(ContactManifold& manifold);
+
+		// Applies impulse to first body, and opposite impulse to second
+		void applyImpulse(ContactManifold& manifold, glm::vec2 impulse, glm::vec2 contact);
+
+		// Returns velocity of first body's contact relative to second's
+		glm::vec2 relativeVelocity(const ContactManifold& manifold, const ContactPoint& point);
+	};
+}
@@ -0,0 +1,22 @@
+#include "DrawRecord.h"
+
+physics::DrawSnapshot::DrawSnapshot() : timeRatio(0), timeStep(1), step(0)
+{
+}
+
+float physics::DrawSnapshot::timeRatioAt(Clock::time_point now) const
+{
+	float elapsed = std::chrono::duration<float>(now - time).count();
+	return glm::clamp(timeRatio + elapsed / timeStep, 0.f, 1.f);
+}
+
+void physics::DrawSnapshot::interpolate(float timeRatio, std::vector<DrawRecord>& records) const
+{
+	records.resize(current.size());
+	for (size_t i = 0; i < current.size(); ++i) {
+		records[i] = current[i];
+		records[i].position = glm::mix(past[i].position, current[i].position, timeRatio);
+		records[i].axisX = glm::mix(past[i].axisX, current[i].axisX, timeRatio);
+		records[i].axisY = glm::mix(past[i].axisY, current[i].axisY, timeRatio);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "ExternalLibraries.h"
+
+#include <chrono>
+
+namespace physics {
+
+	// What a draw record describes
+	enum DrawShape {
+		draw_circle,
+		draw_box,
+		draw_line
+	};
+
+	// Everything needed to draw one object, interpolated between the last two steps
+	// Scenes fill these instead of drawing, so the engine knows nothing about how they are rendered and can
+	// run without any renderer at all
+	struct DrawRecord {
+		DrawShape shape;
+		bool showLine;			// Circle only, whether to draw line from centre along axisX
+		glm::vec2 position;		// Centre of circle or box, or start of line
+		glm::vec2 axisX;		// Box's half extent along its x axis, circle's orientation line, or end of line
+		glm::vec2 axisY;		// Box's half extent along its y axis
+		float radius;			// Circle only
+		glm::vec4 colour;
+	};
+
+	// Draw records of every drawn actor before and after a step, for rendering without touching the scene
+	// Anything between the two is found by interpolating records, which matches how actors interpolate
+	// themselves, so a renderer on another thread can draw smoothly from the last snapshot it was given
+	struct DrawSnapshot {
+		typedef std::chrono::steady_clock Clock;
+
+		std::vector<DrawRecord> past;		// Each drawn actor at start of step
+		std::vector<DrawRecord> current;	// Same actors, in same order, at end of step
+		float timeRatio;					// Scene's time ratio when taken
+		float timeStep;
+		Clock::time_point time;				// When taken
+		size_t step;						// Snapshots published before this one
+
+		DrawSnapshot();
+
+		// Time ratio at given time, carrying on from when snapshot was taken, up to 1
+		float timeRatioAt(Clock::time_point now) const;
+
+		// Replaces records with snapshot's records interpolated by timeRatio
+		void interpolate(float timeRatio, std::vector<DrawRecord>& records) const;
+	};
+}
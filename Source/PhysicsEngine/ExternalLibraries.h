@@ -9,6 +9,4 @@
 
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
-#include <glm/matrix.hpp>
-
-#include "Gizmos.h"
\ No newline at end of file
+#include <glm/matrix.hpp>
\ No newline at end of file
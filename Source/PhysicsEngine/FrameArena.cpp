@@ -0,0 +1,68 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+// Rounds pointer up to multiple of alignment, which must be a power of two
+static char* alignUp(char* pointer, size_t alignment)
+{
+	uintptr_t address = (uintptr_t)pointer;
+	return (char*)((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+physics::FrameArena::FrameArena(size_t capacity)
+	: m_block(nullptr), m_capacity(capacity), m_offset(0), m_used(0), m_overflowNext(nullptr), m_overflowEnd(nullptr)
+{
+	if (capacity == 0) {
+		throw std::invalid_argument("Capacity must be positive");
+	}
+	m_block = (char*)::operator new(capacity);
+}
+
+physics::FrameArena::~FrameArena()
+{
+	for (char* block : m_overflow) {
+		::operator delete(block);
+	}
+	::operator delete(m_block);
+}
+
+void * physics::FrameArena::allocate(size_t size, size_t alignment)
+{
+	m_used += size;
+	char* start = alignUp(m_block + m_offset, alignment);
+	if (start + size <= m_block + m_capacity) {
+		m_offset = start + size - m_block;
+		return start;
+	}
+	// Past end of block, so take from overflow blocks until reset
+	start = (m_overflowNext != nullptr) ? alignUp(m_overflowNext, alignment) : nullptr;
+	if (start == nullptr || start + size > m_overflowEnd) {
+		size_t blockSize = std::max(m_capacity, size + alignment);
+		char* block = (char*)::operator new(blockSize);
+		m_overflow.push_back(block);
+		m_overflowEnd = block + blockSize;
+		start = alignUp(block, alignment);
+	}
+	m_overflowNext = start + size;
+	return start;
+}
+
+void physics::FrameArena::reset()
+{
+	if (!m_overflow.empty()) {
+		// Grow block to hold a whole step, with room for alignment padding
+		for (char* block : m_overflow) {
+			::operator delete(block);
+		}
+		m_overflow.clear();
+		m_overflowNext = nullptr;
+		m_overflowEnd = nullptr;
+		m_capacity = std::max(m_capacity * 2, m_used + m_used / 4);
+		::operator delete(m_block);
+		m_block = (char*)::operator new(m_capacity);
+	}
+	m_offset = 0;
+	m_used = 0;
+}
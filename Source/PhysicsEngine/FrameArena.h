@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace physics {
+
+	// Linear allocator for data which only lasts one step
+	// Allocating moves a pointer along a block, and freeing does nothing until reset, which drops everything
+	// at once. If a step runs past the end of the block, extra blocks are taken from the heap, then reset
+	// replaces them all with one block big enough for the whole step, so after a few steps the arena stops
+	// allocating. Not thread safe, so only the thread stepping the scene allocates from it.
+	class FrameArena {
+	public:
+		static const size_t k_def_capacity = 64 * 1024;
+
+		FrameArena(size_t capacity = k_def_capacity);
+		~FrameArena();
+
+		FrameArena(const FrameArena& other) = delete;
+		FrameArena& operator=(const FrameArena& other) = delete;
+
+		// Returns memory for size bytes with given alignment, which stays valid until reset
+		void* allocate(size_t size, size_t alignment);
+
+		// Frees everything allocated since last reset
+		void reset();
+
+		// Bytes allocated since last reset
+		size_t getUsed() { return m_used; }
+
+		// Bytes which can be allocated before taking more memory from the heap
+		size_t getCapacity() { return m_capacity; }
+
+	protected:
+		char* m_block;
+		size_t m_capacity;
+		size_t m_offset;		// Start of free space in block
+		size_t m_used;
+		std::vector<char*> m_overflow;	// Extra blocks taken this step
+		char* m_overflowNext;
+		char* m_overflowEnd;
+	};
+
+	// Allocator taking memory from a frame arena, or from the heap if it has no arena
+	// Containers using an arena must be destroyed before the arena is reset
+	template <typename T>
+	class ArenaAllocator {
+	public:
+		typedef T value_type;
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+
+		ArenaAllocator(FrameArena* arena = nullptr) : m_arena(arena) {}
+
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.getArena()) {}
+
+		T* allocate(size_t count)
+		{
+			if (m_arena == nullptr) {
+				return (T*)::operator new(count * sizeof(T));
+			}
+			return (T*)m_arena->allocate(count * sizeof(T), alignof(T));
+		}
+
+		void deallocate(T* pointer, size_t /*count*/)
+		{
+			if (m_arena == nullptr) {
+				::operator delete(pointer);
+			}
+		}
+
+		FrameArena* getArena() const { return m_arena; }
+
+		template <typename U>
+		bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.getArena(); }
+		template <typename U>
+		bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.getArena(); }
+
+	protected:
+		FrameArena* m_arena;
+	};
+}
@@ -0,0 +1,44 @@
+#include "IBroadphase.h"
+#include "BruteForceBroadphase.h"
+#include "SweepAndPrune.h"
+#include "SpatialHashGrid.h"
+#include "TreeBroadphase.h"
+
+#include <chrono>
+#include <stdexcept>
+
+physics::BroadphasePtr physics::IBroadphase::create(BroadphaseType type)
+{
+	switch (type) {
+	case brute_force:
+		return BroadphasePtr(new BruteForceBroadphase());
+	case sweep_and_prune:
+		return BroadphasePtr(new SweepAndPrune());
+	case spatial_hash:
+		return BroadphasePtr(new SpatialHashGrid());
+	case aabb_tree:
+		return BroadphasePtr(new TreeBroadphase());
+	default:
+		throw std::invalid_argument("Unknown broadphase type");
+	}
+}
+
+void physics::IBroadphase::update()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	findPairs();
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+	++m_stats.steps;
+	m_stats.candidatePairs = getPairs().size();
+	m_stats.contacts = 0;
+	m_stats.updateTime = elapsed.count();
+	m_stats.totalCandidatePairs += m_stats.candidatePairs;
+	m_stats.totalUpdateTime += m_stats.updateTime;
+}
+
+void physics::IBroadphase::recordContacts(size_t contacts)
+{
+	m_stats.contacts += contacts;
+	m_stats.totalContacts += contacts;
+}
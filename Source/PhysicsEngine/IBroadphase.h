@@ -0,0 +1,85 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "AABB.h"
+#include "Broadphase.h"
+
+namespace physics {
+	class PhysicsObject;
+	class IBroadphase;
+
+	typedef std::unique_ptr<IBroadphase> BroadphasePtr;
+
+	enum BroadphaseType {
+		brute_force,
+		sweep_and_prune,
+		spatial_hash,
+		aabb_tree
+	};
+
+	// Measurements of a broadphase's work
+	struct BroadphaseStats {
+		BroadphaseStats() : steps(0), candidatePairs(0), contacts(0), updateTime(0),
+			totalCandidatePairs(0), totalContacts(0), totalUpdateTime(0)
+		{};
+
+		size_t steps;					// Updates since stats were reset
+
+		size_t candidatePairs;			// Pairs passed to narrowphase by last update
+		size_t contacts;				// Candidate pairs in last update which were confirmed as colliding
+		double updateTime;				// Seconds spent in last update
+
+		size_t totalCandidatePairs;
+		size_t totalContacts;
+		double totalUpdateTime;
+	};
+
+	// Interface for broadphases, which find pairs of objects that might be colliding
+	// Scene adds each actor to its broadphase, and passes pairs found by each update to the narrowphase
+	class IBroadphase {
+	public:
+		virtual ~IBroadphase() {};
+
+		// Creates broadphase of given type
+		static BroadphasePtr create(BroadphaseType type);
+
+		virtual BroadphaseType getType() = 0;
+
+		// Starts tracking object
+		virtual void add(PhysicsObject* object) = 0;
+
+		// Stops tracking object
+		virtual void remove(PhysicsObject* object) = 0;
+
+		// Stops tracking all objects which have been killed
+		virtual void removeDead() = 0;
+
+		// Stops tracking all objects
+		virtual void clear() = 0;
+
+		// Finds pairs of objects to be tested by narrowphase, recording time taken
+		void update();
+
+		// Returns pairs found by last update, in the order the objects were added
+		virtual const std::vector<BroadphasePair>& getPairs() = 0;
+
+		virtual size_t getProxyCount() = 0;
+
+		// Appends every object whose bounds overlap bounds, as of last update
+		virtual void queryAABB(const AABB& bounds, std::vector<PhysicsObject*>& results) = 0;
+
+		// Appends every object containing point, as of last update
+		virtual void queryPoint(glm::vec2 point, std::vector<PhysicsObject*>& results) = 0;
+
+		// Records how many pairs found by last update were colliding
+		void recordContacts(size_t contacts);
+
+		const BroadphaseStats& getStats() { return m_stats; }
+		void resetStats() { m_stats = BroadphaseStats(); }
+
+	protected:
+		BroadphaseStats m_stats;
+
+		// Implementation of update, finding pairs
+		virtual void findPairs() = 0;
+	};
+}
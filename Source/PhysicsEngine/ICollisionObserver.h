@@ -10,8 +10,29 @@ namespace physics {
 	typedef std::shared_ptr<ICollisionObserver> CollisionObserverPtr;
 	typedef std::weak_ptr<ICollisionObserver> CollisionObserverWeakPtr;
 
+	// Stage of contact between a pair of objects
+	enum ContactEvent {
+		contact_begin,		// First step the pair touched
+		contact_stay,		// Pair touched last step too
+		contact_end			// First step the pair stopped touching
+	};
+
+	// Receives collisions of objects it observes, once each step's collisions have been solved
+	// Each callback does nothing unless overridden, so observers only handle the stages they need
+	// Collision's first object is always publisher. Pairs with a trigger are only tested for overlap, so their
+	// collisions have no normal, contact or depth
 	class ICollisionObserver {
 	public:
-		virtual void OnCollision(PhysicsObject* publisher, const Collision& collision) = 0;
+		virtual ~ICollisionObserver() {};
+
+		// Called when publisher first touches another object
+		virtual void OnCollisionBegin(PhysicsObject* /*publisher*/, const Collision& /*collision*/) {};
+
+		// Called on each later step that publisher keeps touching the object
+		virtual void OnCollisionStay(PhysicsObject* /*publisher*/, const Collision& /*collision*/) {};
+
+		// Called when publisher stops touching the object, with the last collision between them
+		// Not called if either object dies or leaves the scene
+		virtual void OnCollisionEnd(PhysicsObject* /*publisher*/, const Collision& /*collision*/) {};
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,193 @@
+#include "IslandManager.h"
+#include "RigidBody.h"
+#include "Joint.h"
+
+#include <cmath>
+#include <stdexcept>
+
+const float physics::IslandManager::k_def_linear_threshold = 0.05f;
+const float physics::IslandManager::k_def_angular_threshold = 0.05f;
+const float physics::IslandManager::k_def_time_to_sleep = 0.5f;
+
+physics::IslandManager::IslandManager()
+	: m_islandCount(0), m_sleepingEnabled(true), m_linearThreshold(k_def_linear_threshold),
+	m_angularThreshold(k_def_angular_threshold), m_timeToSleep(k_def_time_to_sleep)
+{
+}
+
+void physics::IslandManager::build(const std::vector<PhysicsObject*>& actors, const CollisionList& collisions)
+{
+	m_bodies.clear();
+	m_slotIndices.clear();
+	for (PhysicsObject* actor : actors) {
+		ShapeType shape = actor->getShapeID();
+		if (shape == sphere || shape == obox) {
+			RigidBody* body = static_cast<RigidBody*>(actor);
+			if (body->isDynamic()) {
+				if (body->getSlot() >= m_slotIndices.size()) {
+					m_slotIndices.resize(body->getSlot() + 1, -1);
+				}
+				m_slotIndices[body->getSlot()] = (int)m_bodies.size();
+				m_bodies.push_back(body);
+			}
+		}
+	}
+	m_parent.resize(m_bodies.size());
+	for (size_t i = 0; i < m_bodies.size(); ++i) {
+		m_parent[i] = i;
+	}
+
+	// Joints and contacts join their bodies' islands
+	for (PhysicsObject* actor : actors) {
+		if (actor->getShapeID() == spring) {
+			Joint* joint = static_cast<Joint*>(actor);
+			int end1 = indexOf(joint->getEnd1().get());
+			int end2 = indexOf(joint->getEnd2().get());
+			if (end1 >= 0 && end2 >= 0) {
+				unite(end1, end2);
+			}
+		}
+	}
+	for (const Collision& collision : collisions) {
+		if (collision.first->isTrigger() || collision.second->isTrigger()) {
+			continue;
+		}
+		int first = indexOf(collision.first);
+		int second = indexOf(collision.second);
+		if (first >= 0 && second >= 0) {
+			unite(first, second);
+		}
+	}
+
+	// Number islands in order their first body was added
+	m_island.resize(m_bodies.size());
+	m_islandCount = 0;
+	for (size_t i = 0; i < m_bodies.size(); ++i) {
+		size_t root = find(i);
+		if (root == i) {
+			m_island[i] = m_islandCount++;
+		}
+	}
+	for (size_t i = 0; i < m_bodies.size(); ++i) {
+		m_island[i] = m_island[find(i)];
+	}
+}
+
+void physics::IslandManager::wakeIslands()
+{
+	m_islandAwake.assign(m_islandCount, false);
+	for (size_t i = 0; i < m_bodies.size(); ++i) {
+		if (m_bodies[i]->isAwake()) {
+			m_islandAwake[m_island[i]] = true;
+		}
+	}
+	for (size_t i = 0; i < m_bodies.size(); ++i) {
+		if (m_islandAwake[m_island[i]] && !m_bodies[i]->isAwake()) {
+			m_bodies[i]->setAwake(true);
+		}
+	}
+}
+
+void physics::IslandManager::updateSleep(float timeStep)
+{
+	if (!m_sleepingEnabled) {
+		return;
+	}
+	float linearThresholdSqr = m_linearThreshold * m_linearThreshold;
+	m_islandSleepTime.assign(m_islandCount, INFINITY);
+	for (size_t i = 0; i < m_bodies.size(); ++i) {
+		RigidBody* body = m_bodies[i];
+		if (!body->isAwake()) {
+			continue;
+		}
+		glm::vec2 velocity = body->getVelocity();
+		if (glm::dot(velocity, velocity) < linearThresholdSqr && abs(body->getAngularVelocity()) < m_angularThreshold) {
+			body->setSleepTime(body->getSleepTime() + timeStep);
+		}
+		else {
+			body->setSleepTime(0);
+		}
+		float& islandTime = m_islandSleepTime[m_island[i]];
+		islandTime = std::min(islandTime, body->getSleepTime());
+	}
+	for (size_t i = 0; i < m_bodies.size(); ++i) {
+		if (m_bodies[i]->isAwake() && m_islandSleepTime[m_island[i]] >= m_timeToSleep) {
+			m_bodies[i]->setAwake(false);
+		}
+	}
+}
+
+int physics::IslandManager::getIsland(RigidBody * body)
+{
+	int index = indexOf(body);
+	return (index >= 0) ? (int)m_island[index] : -1;
+}
+
+void physics::IslandManager::setLinearThreshold(float threshold)
+{
+	if (threshold < 0 || std::isnan(threshold) || std::isinf(threshold)) {
+		throw std::invalid_argument("Threshold must be non-negative and finite");
+	}
+	m_linearThreshold = threshold;
+}
+
+void physics::IslandManager::setAngularThreshold(float threshold)
+{
+	if (threshold < 0 || std::isnan(threshold) || std::isinf(threshold)) {
+		throw std::invalid_argument("Threshold must be non-negative and finite");
+	}
+	m_angularThreshold = threshold;
+}
+
+void physics::IslandManager::setTimeToSleep(float time)
+{
+	if (time < 0 || std::isnan(time)) {
+		throw std::invalid_argument("Time to sleep must be non-negative");
+	}
+	m_timeToSleep = time;
+}
+
+int physics::IslandManager::indexOf(PhysicsObject * object)
+{
+	if (object == nullptr) {
+		return -1;
+	}
+	ShapeType shape = object->getShapeID();
+	if (shape != sphere && shape != obox) {
+		return -1;
+	}
+	size_t slot = static_cast<RigidBody*>(object)->getSlot();
+	if (slot >= m_slotIndices.size()) {
+		return -1;
+	}
+	// Slot may belong to a body in another store, or one which doesn't join islands
+	int index = m_slotIndices[slot];
+	return (index >= 0 && m_bodies[index] == object) ? index : -1;
+}
+
+size_t physics::IslandManager::find(size_t index)
+{
+	size_t root = index;
+	while (m_parent[root] != root) {
+		root = m_parent[root];
+	}
+	while (m_parent[index] != root) {
+		size_t next = m_parent[index];
+		m_parent[index] = root;
+		index = next;
+	}
+	return root;
+}
+
+void physics::IslandManager::unite(size_t first, size_t second)
+{
+	size_t firstRoot = find(first);
+	size_t secondRoot = find(second);
+	// Lower index becomes root, so island numbering follows order bodies were added
+	if (firstRoot < secondRoot) {
+		m_parent[secondRoot] = firstRoot;
+	}
+	else if (secondRoot < firstRoot) {
+		m_parent[firstRoot] = secondRoot;
+	}
+}
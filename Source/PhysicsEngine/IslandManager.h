@@ -0,0 +1,73 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "PhysicsObject.h"
+
+namespace physics {
+	class RigidBody;
+
+	// Groups dynamic bodies into islands of bodies connected by contacts or joints, and puts islands to
+	// sleep once every body in them has been still for long enough
+	// Islands are rebuilt every step with union-find. Static objects don't join islands, so bodies
+	// resting on the same ground can sleep separately.
+	class IslandManager {
+	public:
+		static const float k_def_linear_threshold;	// Speed below which a body counts as still
+		static const float k_def_angular_threshold;	// Angular speed below which a body counts as still
+		static const float k_def_time_to_sleep;		// Time an island must be still before sleeping
+
+		IslandManager();
+
+		// Rebuilds islands from dynamic bodies in actors, joined by joints and collisions
+		// Bodies are looked up by their slot in the body store, so actors must all share a store
+		void build(const std::vector<PhysicsObject*>& actors, const CollisionList& collisions);
+
+		// Wakes every body in an island with any awake body, so bodies touching or linked to a moving
+		// body move with it
+		void wakeIslands();
+
+		// Updates how long each body has been still, and puts islands to sleep which have been still
+		// for long enough
+		void updateSleep(float timeStep);
+
+		// Returns number of islands found by last build
+		size_t getIslandCount() { return m_islandCount; }
+
+		// Returns island of body as of last build, or -1 if body isn't in an island
+		int getIsland(RigidBody* body);
+
+		// Sets whether islands are put to sleep. Doesn't wake islands already asleep
+		bool isSleepingEnabled() { return m_sleepingEnabled; }
+		void setSleepingEnabled(bool value) { m_sleepingEnabled = value; }
+
+		float getLinearThreshold() { return m_linearThreshold; }
+		void setLinearThreshold(float threshold);
+
+		float getAngularThreshold() { return m_angularThreshold; }
+		void setAngularThreshold(float threshold);
+
+		float getTimeToSleep() { return m_timeToSleep; }
+		void setTimeToSleep(float time);
+
+	protected:
+		std::vector<RigidBody*> m_bodies;
+		std::vector<size_t> m_parent;		// Union-find parent of each body
+		std::vector<size_t> m_island;		// Island each body belongs to
+		std::vector<bool> m_islandAwake;
+		std::vector<float> m_islandSleepTime;	// Shortest time any body in island has been still
+		std::vector<int> m_slotIndices;		// Index of body in each body store slot, or -1
+		size_t m_islandCount;
+		bool m_sleepingEnabled;
+		float m_linearThreshold;
+		float m_angularThreshold;
+		float m_timeToSleep;
+
+		// Returns index of body, or -1 if it doesn't join islands
+		int indexOf(PhysicsObject* object);
+
+		// Returns root of body's set, compressing path as it goes
+		size_t find(size_t index);
+
+		// Merges sets containing both bodies
+		void unite(size_t first, size_t second);
+	};
+}
@@ -0,0 +1,196 @@
+#include "JobSystem.h"
+
+#include <stdexcept>
+
+physics::JobSystem::JobSystem(size_t workerCount) : m_queued(0), m_remaining(0), m_steals(0), m_stopping(false)
+{
+	startWorkers(workerCount);
+}
+
+physics::JobSystem::~JobSystem()
+{
+	stopWorkers();
+}
+
+void physics::JobSystem::setWorkerCount(size_t workerCount)
+{
+	stopWorkers();
+	startWorkers(workerCount);
+}
+
+void physics::JobSystem::parallelFor(size_t count, size_t grainSize, const RangeTask & task)
+{
+	if (grainSize == 0) {
+		throw std::invalid_argument("Grain size must be positive");
+	}
+	if (count == 0) {
+		return;
+	}
+	if (m_threads.empty()) {
+		// Run in order on this thread
+		for (size_t begin = 0; begin < count; begin += grainSize) {
+			task(begin, std::min(begin + grainSize, count));
+		}
+		return;
+	}
+
+	// Deal ranges out to every deque, including this thread's
+	size_t ranges = rangeCount(count, grainSize);
+	m_remaining = ranges;
+	m_queued += ranges;
+	for (size_t i = 0; i < ranges; ++i) {
+		size_t begin = i * grainSize;
+		WorkQueue& queue = *m_queues[i % m_queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.count == queue.ring.size()) {
+			// Deques are emptied by every parallelFor, so this is enough for all of this one's ranges
+			queue.reserve(queue.count + rangeCount(ranges - i, m_queues.size()));
+		}
+		queue.pushBack({ &task, begin, std::min(begin + grainSize, count) });
+	}
+	{
+		// Lock so no worker misses wake up between checking queue and waiting
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+	}
+	m_wake.notify_all();
+
+	// Help until every range is finished
+	Job job;
+	while (m_remaining > 0) {
+		if (takeJob(0, job)) {
+			runJob(job);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+
+	if (m_error) {
+		std::exception_ptr error = m_error;
+		m_error = nullptr;
+		std::rethrow_exception(error);
+	}
+}
+
+size_t physics::JobSystem::rangeCount(size_t count, size_t grainSize)
+{
+	return (count + grainSize - 1) / grainSize;
+}
+
+void physics::JobSystem::startWorkers(size_t workerCount)
+{
+	m_stopping = false;
+	m_queues.clear();
+	for (size_t i = 0; i <= workerCount; ++i) {
+		m_queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+	}
+	for (size_t i = 1; i <= workerCount; ++i) {
+		m_threads.push_back(std::thread(&JobSystem::workerLoop, this, i));
+	}
+}
+
+void physics::JobSystem::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& thread : m_threads) {
+		thread.join();
+	}
+	m_threads.clear();
+}
+
+void physics::JobSystem::workerLoop(size_t index)
+{
+	Job job;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(m_wakeMutex);
+			m_wake.wait(lock, [this]() { return m_stopping || m_queued > 0; });
+			if (m_stopping) {
+				return;
+			}
+		}
+		while (takeJob(index, job)) {
+			runJob(job);
+		}
+	}
+}
+
+bool physics::JobSystem::takeJob(size_t index, Job & job)
+{
+	{
+		WorkQueue& own = *m_queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (own.count > 0) {
+			job = own.popBack();
+			--m_queued;
+			return true;
+		}
+	}
+	// Start with next thread along, so thieves spread over different victims
+	for (size_t i = 1; i < m_queues.size(); ++i) {
+		WorkQueue& victim = *m_queues[(index + i) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (victim.count > 0) {
+			job = victim.popFront();
+			--m_queued;
+			++m_steals;
+			return true;
+		}
+	}
+	return false;
+}
+
+void physics::JobSystem::runJob(const Job & job)
+{
+	try {
+		(*job.task)(job.begin, job.end);
+	}
+	catch (...) {
+		std::lock_guard<std::mutex> lock(m_errorMutex);
+		if (!m_error) {
+			m_error = std::current_exception();
+		}
+	}
+	--m_remaining;
+}
+
+void physics::JobSystem::WorkQueue::reserve(size_t capacity)
+{
+	if (capacity <= ring.size()) {
+		return;
+	}
+	// Unwrap jobs to the start of the new ring
+	std::vector<Job> grown(capacity);
+	for (size_t i = 0; i < count; ++i) {
+		grown[i] = ring[(head + i) % ring.size()];
+	}
+	ring.swap(grown);
+	head = 0;
+}
+
+void physics::JobSystem::WorkQueue::pushBack(const Job & job)
+{
+	if (count == ring.size()) {
+		reserve(std::max<size_t>(ring.size() * 2, 4));
+	}
+	ring[(head + count) % ring.size()] = job;
+	++count;
+}
+
+physics::JobSystem::Job physics::JobSystem::WorkQueue::popBack()
+{
+	--count;
+	return ring[(head + count) % ring.size()];
+}
+
+physics::JobSystem::Job physics::JobSystem::WorkQueue::popFront()
+{
+	Job job = ring[head];
+	head = (head + 1) % ring.size();
+	--count;
+	return job;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "ExternalLibraries.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace physics {
+
+	// Work-stealing task scheduler
+	// Each thread has its own deque of jobs. Threads take jobs from the back of their own deque, and
+	// when it is empty steal from the front of others', so work spreads out without a shared queue.
+	// With no workers, every job runs on the calling thread in order, for debugging and tests.
+	// Deques are ring buffers which only grow when a parallelFor deals out more ranges than any before,
+	// so once a scene has warmed up, stepping it doesn't allocate whatever the worker count.
+	class JobSystem {
+	public:
+		// Task run over range [begin, end) of items
+		typedef std::function<void(size_t begin, size_t end)> RangeTask;
+
+		static const size_t k_def_grain_size = 64;
+
+		// workerCount = threads to start besides the calling thread, 0 runs everything on calling thread
+		JobSystem(size_t workerCount = 0);
+
+		~JobSystem();
+
+		JobSystem(const JobSystem& other) = delete;
+		JobSystem& operator=(const JobSystem& other) = delete;
+
+		size_t getWorkerCount() { return m_threads.size(); }
+
+		// Stops current workers and starts workerCount new ones
+		void setWorkerCount(size_t workerCount);
+
+		// Splits [0, count) into ranges of at most grainSize items, and runs task over each
+		// Returns once every range has finished. Ranges may run in any order, on any thread, so task must
+		// only write to data belonging to its range. The first exception thrown by a task is rethrown here
+		// Must only be called from the thread which owns the job system
+		void parallelFor(size_t count, size_t grainSize, const RangeTask& task);
+
+		// Returns number of ranges parallelFor splits count items into
+		static size_t rangeCount(size_t count, size_t grainSize);
+
+		// Returns number of jobs taken from another thread's deque since creation
+		size_t getStealCount() { return m_steals; }
+
+	protected:
+		struct Job {
+			const RangeTask* task;
+			size_t begin;
+			size_t end;
+		};
+
+		// Double ended queue of jobs in a ring buffer, keeping its memory when emptied
+		struct WorkQueue {
+			WorkQueue() : head(0), count(0) {}
+
+			std::mutex mutex;
+			std::vector<Job> ring;
+			size_t head;	// Index of front job in ring
+			size_t count;
+
+			// Makes room for capacity jobs in total
+			void reserve(size_t capacity);
+
+			void pushBack(const Job& job);
+			Job popBack();
+			Job popFront();
+		};
+
+		// Queue 0 belongs to the calling thread, then one per worker
+		std::vector<std::unique_ptr<WorkQueue>> m_queues;
+		std::vector<std::thread> m_threads;
+		std::mutex m_wakeMutex;
+		std::condition_variable m_wake;
+		std::atomic<size_t> m_queued;		// Jobs waiting in any deque
+		std::atomic<size_t> m_remaining;	// Jobs from current parallelFor not yet finished
+		std::atomic<size_t> m_steals;
+		std::mutex m_errorMutex;
+		std::exception_ptr m_error;
+		bool m_stopping;
+
+		void startWorkers(size_t workerCount);
+		void stopWorkers();
+
+		// Waits for and runs jobs until stopped
+		void workerLoop(size_t index);
+
+		// Takes job from back of own deque, or front of another's
+		bool takeJob(size_t index, Job& job);
+
+		void runJob(const Job& job);
+	};
+}
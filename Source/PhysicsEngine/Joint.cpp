@@ -5,7 +5,7 @@
 #include "Box.h"
 
 physics::Joint::Joint(RigidBodyPtr end1, RigidBodyPtr end2, glm::vec2 anchor1, glm::vec2 anchor2, glm::vec4 colour)
-	: PhysicsObject(0.f,0.f,colour), m_end1(end1), m_end2(end2), m_anchor1(anchor1), m_anchor2(anchor2)
+	: PhysicsObject(0.f,0.f,colour), m_end1(end1), m_end2(end2), m_anchor1(anchor1), m_anchor2(anchor2), m_collideConnected(true)
 {
 	if (m_end1 == m_end2) {
 		m_end2.reset();
@@ -13,11 +13,16 @@ physics::Joint::Joint(RigidBodyPtr end1, RigidBodyPtr end2, glm::vec2 anchor1, g
 }
 
 physics::Joint::Joint(const Joint & other) :
-	PhysicsObject(other), m_anchor1(other.m_anchor1), m_anchor2(other.m_anchor2)
+	PhysicsObject(other), m_anchor1(other.m_anchor1), m_anchor2(other.m_anchor2), m_collideConnected(other.m_collideConnected)
 {
 	// TODO figure out if deep or shallow or no copy of ends
 }
 
+physics::Joint::~Joint()
+{
+	excludeEnds(false);
+}
+
 void physics::Joint::fixedUpdate(PhysicsScene* scene)
 {
 }
@@ -25,7 +30,9 @@ void physics::Joint::fixedUpdate(PhysicsScene* scene)
 bool physics::Joint::setEnd1(RigidBodyPtr end)
 {
 	if (end != m_end2) {
+		excludeEnds(false);
 		m_end1 = end;
+		excludeEnds(true);
 		return true;
 	}
 	else {
@@ -36,7 +43,9 @@ bool physics::Joint::setEnd1(RigidBodyPtr end)
 bool physics::Joint::setEnd2(RigidBodyPtr end)
 {
 	if (end != m_end1) {
+		excludeEnds(false);
 		m_end2 = end;
+		excludeEnds(true);
 		return true;
 	}
 	else {
@@ -44,6 +53,14 @@ bool physics::Joint::setEnd2(RigidBodyPtr end)
 	}
 }
 
+void physics::Joint::setCollideConnected(bool value)
+{
+	if (value != m_collideConnected) {
+		m_collideConnected = value;
+		excludeEnds(!value);
+	}
+}
+
 void physics::Joint::setAnchor1(glm::vec2 anchorPoint)
 {
 	m_anchor1 = anchorPoint;
@@ -74,25 +91,30 @@ physics::Collision physics::Joint::checkPlaneCollision(Plane * other)
 	return Collision(false, this, other);
 }
 
-void physics::Joint::resolveCollision(PhysicsObject * other, const Collision & col)
-{
-	// Does nothing
-}
-
-void physics::Joint::resolveRigidbodyCollision(RigidBody * other, const Collision & col)
-{
-}
-
-void physics::Joint::resolvePlaneCollision(Plane * other, const Collision & col)
+void physics::Joint::removeKilledEnd()
 {
+	if ((m_end1 && !m_end1->isAlive()) || (m_end2 && !m_end2->isAlive())) {
+		excludeEnds(false);
+		if (m_end1 && !m_end1->isAlive()) {
+			m_end1.reset();
+		}
+		if (m_end2 && !m_end2->isAlive()) {
+			m_end2.reset();
+		}
+		excludeEnds(true);
+	}
 }
 
-void physics::Joint::removeKilledEnd()
+void physics::Joint::excludeEnds(bool exclude)
 {
-	if (m_end1 && !m_end1->isAlive()) {
-		m_end1.reset();
-	}
-	if (m_end2 && !m_end2->isAlive()) {
-		m_end2.reset();
+	if (!m_collideConnected && m_end1 && m_end2) {
+		if (exclude) {
+			m_end1->addCollisionExclusion(m_end2.get());
+			m_end2->addCollisionExclusion(m_end1.get());
+		}
+		else {
+			m_end1->removeCollisionExclusion(m_end2.get());
+			m_end2->removeCollisionExclusion(m_end1.get());
+		}
 	}
 }
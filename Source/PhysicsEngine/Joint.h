@@ -21,6 +21,8 @@ namespace physics {
 		
 		Joint(const Joint& other);
 
+		virtual ~Joint();
+
 		void fixedUpdate(PhysicsScene* scene);
 
 		bool setEnd1(RigidBodyPtr end);
@@ -35,17 +37,21 @@ namespace physics {
 		glm::vec2 getAnchor1() { return m_anchor1; }
 		glm::vec2 getAnchor2() { return m_anchor2; }
 
+		bool getCollideConnected() { return m_collideConnected; }
+
+		// Sets whether bodies at either end of joint can collide with each other
+		void setCollideConnected(bool value);
+
 		virtual bool isPointInside(glm::vec2 point) { return false; }
 
+		// Joints don't collide, so have empty bounds
+		virtual AABB getAABB() { return AABB(); }
+
 		virtual Collision checkCollision(PhysicsObject* other);
 		virtual Collision checkSphereCollision(Sphere* other);
 		virtual Collision checkBoxCollision(Box* other);
 		virtual Collision checkPlaneCollision(Plane* other);
 
-		virtual void resolveCollision(PhysicsObject* other, const Collision& col);
-		virtual void resolveRigidbodyCollision(RigidBody * other, const Collision& col);
-		virtual void resolvePlaneCollision(Plane* other, const Collision& col);
-
 		virtual glm::vec2 calculateMomentum() { return { 0,0 }; };
 
 		virtual bool isStatic() { return true; };
@@ -57,7 +63,12 @@ namespace physics {
 		glm::vec2 m_anchor1;
 		glm::vec2 m_anchor2;
 
+		bool m_collideConnected;	// If false, ends are excluded from colliding with each other
+
 		void removeKilledEnd();
+
+		// Adds or removes collision exclusion between ends, if they shouldn't collide
+		void excludeEnds(bool exclude);
 	};
 
 }
\ No newline at end of file
@@ -1,13 +1,37 @@
 #pragma once
+#include "ExternalLibraries.h"
+
+#include <stdexcept>
 
 namespace physics {
+
+	// Bitmask of collision layers
+	typedef unsigned int LayerMask;
+
+	// Collision layers
+	// Each object belongs to a set of layers, and has a mask of layers it can collide with.
+	// A pair of objects is only tested for collision if each is in a layer the other collides with.
 	class Layer {
+	public:
+		static const size_t k_max_layers = 32;
+		static const LayerMask k_none = 0;
+		static const LayerMask k_default = 1;		// Layer objects start in
+		static const LayerMask k_all = 0xFFFFFFFF;	// Mask objects start with
+
+		// Returns mask containing only layer with given index
+		static LayerMask fromIndex(size_t index) {
+			if (index >= k_max_layers) {
+				throw std::out_of_range("Layer index must be less than 32");
+			}
+			return 1u << index;
+		}
+
+		// Returns true if objects in given layers and masks can collide
+		static bool canCollide(LayerMask layers1, LayerMask mask1, LayerMask layers2, LayerMask mask2) {
+			return (layers1 & mask2) != 0 && (layers2 & mask1) != 0;
+		}
 
-		// TODO system for having different layers for collision detection (scene has map of layers to bitmask?), turn collisions on or off
-		// TODO stuff to access layers by name, index, etc
-		// TODO layer has bitmask for other layers it can interact with
-		// TODO adding new layers
 	private:
 		Layer();
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,312 @@
+#include "Narrowphase.h"
+#include "Sphere.h"
+#include "Box.h"
+#include "Plane.h"
+#include "JobSystem.h"
+#include "Simd.h"
+
+// Kernels call shapes' collision tests by qualified name, so calls are direct and can be inlined
+
+// Sphere kernels gather k_lanes pairs at a time and reject them together, only building collisions for
+// pairs which overlap. When fewer pairs are left than lanes, the spare lanes' results are ignored
+
+static void planeSphereKernel(const physics::Narrowphase::ShapePair* pairs, size_t count, physics::CollisionList& collisions)
+{
+	const size_t k_lanes = physics::Narrowphase::k_lanes;
+	physics::Narrowphase::PlaneLanes lanes = {};
+	for (size_t start = 0; start < count; start += k_lanes) {
+		size_t used = std::min(count - start, k_lanes);
+		for (size_t i = 0; i < used; ++i) {
+			physics::Plane* plane = static_cast<physics::Plane*>(pairs[start + i].first);
+			physics::Sphere* sphere = static_cast<physics::Sphere*>(pairs[start + i].second);
+			glm::vec2 position = sphere->getPosition();
+			glm::vec2 normal = plane->getNormal();
+			lanes.x[i] = position.x;
+			lanes.y[i] = position.y;
+			lanes.radius[i] = sphere->getRadius();
+			lanes.normalX[i] = normal.x;
+			lanes.normalY[i] = normal.y;
+			lanes.distance[i] = plane->getDistance();
+		}
+		unsigned hits = physics::Narrowphase::overlapping(lanes);
+		for (size_t i = 0; i < used; ++i) {
+			if (hits & (1u << i)) {
+				physics::Plane* plane = static_cast<physics::Plane*>(pairs[start + i].first);
+				physics::Sphere* sphere = static_cast<physics::Sphere*>(pairs[start + i].second);
+				physics::Collision col = plane->physics::Plane::checkSphereCollision(sphere);
+				if (col) {
+					collisions.push_back(col);
+				}
+			}
+		}
+	}
+}
+
+static void planeBoxKernel(const physics::Narrowphase::ShapePair* pairs, size_t count, physics::CollisionList& collisions)
+{
+	for (size_t i = 0; i < count; ++i) {
+		physics::Plane* plane = static_cast<physics::Plane*>(pairs[i].first);
+		physics::Box* box = static_cast<physics::Box*>(pairs[i].second);
+		physics::Collision col = box->physics::Box::checkPlaneCollision(plane);
+		if (col) {
+			collisions.push_back(col);
+		}
+	}
+}
+
+static void sphereSphereKernel(const physics::Narrowphase::ShapePair* pairs, size_t count, physics::CollisionList& collisions)
+{
+	const size_t k_lanes = physics::Narrowphase::k_lanes;
+	physics::Narrowphase::SphereLanes lanes = {};
+	for (size_t start = 0; start < count; start += k_lanes) {
+		size_t used = std::min(count - start, k_lanes);
+		for (size_t i = 0; i < used; ++i) {
+			physics::Sphere* first = static_cast<physics::Sphere*>(pairs[start + i].first);
+			physics::Sphere* second = static_cast<physics::Sphere*>(pairs[start + i].second);
+			glm::vec2 displacement = second->getPosition() - first->getPosition();
+			lanes.dx[i] = displacement.x;
+			lanes.dy[i] = displacement.y;
+			lanes.radii[i] = second->getRadius() + first->getRadius();
+		}
+		unsigned hits = physics::Narrowphase::overlapping(lanes);
+		for (size_t i = 0; i < used; ++i) {
+			if (hits & (1u << i)) {
+				physics::Sphere* first = static_cast<physics::Sphere*>(pairs[start + i].first);
+				physics::Sphere* second = static_cast<physics::Sphere*>(pairs[start + i].second);
+				// Batched test may round differently from the exact one, so it can only reject pairs
+				physics::Collision col = second->physics::Sphere::checkSphereCollision(first);
+				if (col) {
+					collisions.push_back(col);
+				}
+			}
+		}
+	}
+}
+
+static void sphereBoxKernel(const physics::Narrowphase::ShapePair* pairs, size_t count, physics::CollisionList& collisions)
+{
+	for (size_t i = 0; i < count; ++i) {
+		physics::Sphere* sphere = static_cast<physics::Sphere*>(pairs[i].first);
+		physics::Box* box = static_cast<physics::Box*>(pairs[i].second);
+		physics::Collision col = box->physics::Box::checkSphereCollision(sphere);
+		if (col) {
+			collisions.push_back(col);
+		}
+	}
+}
+
+static void boxBoxKernel(const physics::Narrowphase::ShapePair* pairs, size_t count, physics::CollisionList& collisions)
+{
+	for (size_t i = 0; i < count; ++i) {
+		physics::Box* first = static_cast<physics::Box*>(pairs[i].first);
+		physics::Box* second = static_cast<physics::Box*>(pairs[i].second);
+		physics::Collision col = second->physics::Box::checkBoxCollision(first);
+		if (col) {
+			collisions.push_back(col);
+		}
+	}
+}
+
+// Indexed by [first shape][second shape], with first shape never greater than second
+// Springs and pairs of planes never collide
+static const physics::Narrowphase::Kernel k_kernels[physics::shape_count][physics::shape_count] = {
+	//	spring		plane		sphere				obox
+	{	nullptr,	nullptr,	nullptr,			nullptr			},	// spring
+	{	nullptr,	nullptr,	planeSphereKernel,	planeBoxKernel	},	// plane
+	{	nullptr,	nullptr,	sphereSphereKernel,	sphereBoxKernel	},	// sphere
+	{	nullptr,	nullptr,	nullptr,			boxBoxKernel	}	// obox
+};
+
+// Overlap tests for pairs with a trigger, taking objects in kernel order
+
+static bool planeSphereOverlap(physics::PhysicsObject* first, physics::PhysicsObject* second)
+{
+	return static_cast<physics::Plane*>(first)->overlapsSphere(static_cast<physics::Sphere*>(second));
+}
+
+static bool planeBoxOverlap(physics::PhysicsObject* first, physics::PhysicsObject* second)
+{
+	return static_cast<physics::Plane*>(first)->overlapsBox(static_cast<physics::Box*>(second));
+}
+
+static bool sphereSphereOverlap(physics::PhysicsObject* first, physics::PhysicsObject* second)
+{
+	return static_cast<physics::Sphere*>(first)->overlapsSphere(static_cast<physics::Sphere*>(second));
+}
+
+static bool sphereBoxOverlap(physics::PhysicsObject* first, physics::PhysicsObject* second)
+{
+	return static_cast<physics::Box*>(second)->overlapsSphere(static_cast<physics::Sphere*>(first));
+}
+
+static bool boxBoxOverlap(physics::PhysicsObject* first, physics::PhysicsObject* second)
+{
+	return static_cast<physics::Box*>(first)->overlapsBox(static_cast<physics::Box*>(second));
+}
+
+static const physics::Narrowphase::OverlapTest k_overlap_tests[physics::shape_count][physics::shape_count] = {
+	//	spring		plane		sphere				obox
+	{	nullptr,	nullptr,	nullptr,			nullptr			},	// spring
+	{	nullptr,	nullptr,	planeSphereOverlap,	planeBoxOverlap	},	// plane
+	{	nullptr,	nullptr,	sphereSphereOverlap,sphereBoxOverlap},	// sphere
+	{	nullptr,	nullptr,	nullptr,			boxBoxOverlap	}	// obox
+};
+
+physics::Narrowphase::Narrowphase()
+{
+	m_bucketStart.fill(0);
+}
+
+unsigned physics::Narrowphase::overlapping(const SphereLanes & lanes)
+{
+	unsigned hits = 0;
+#ifdef PHYSICS_SIMD
+	for (size_t i = 0; i < k_lanes; i += 4) {
+		__m128 dx = _mm_loadu_ps(lanes.dx + i);
+		__m128 dy = _mm_loadu_ps(lanes.dy + i);
+		__m128 radii = _mm_loadu_ps(lanes.radii + i);
+		__m128 distanceSqr = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		hits |= _mm_movemask_ps(_mm_cmplt_ps(distanceSqr, _mm_mul_ps(radii, radii))) << i;
+	}
+#else
+	for (size_t i = 0; i < k_lanes; ++i) {
+		if (lanes.dx[i] * lanes.dx[i] + lanes.dy[i] * lanes.dy[i] < lanes.radii[i] * lanes.radii[i]) {
+			hits |= 1u << i;
+		}
+	}
+#endif
+	return hits;
+}
+
+unsigned physics::Narrowphase::overlapping(const PlaneLanes & lanes)
+{
+	unsigned hits = 0;
+#ifdef PHYSICS_SIMD
+	for (size_t i = 0; i < k_lanes; i += 4) {
+		__m128 distance = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(lanes.x + i), _mm_loadu_ps(lanes.normalX + i)),
+			_mm_mul_ps(_mm_loadu_ps(lanes.y + i), _mm_loadu_ps(lanes.normalY + i)));
+		distance = _mm_add_ps(distance, _mm_loadu_ps(lanes.distance + i));
+		hits |= _mm_movemask_ps(_mm_cmplt_ps(distance, _mm_loadu_ps(lanes.radius + i))) << i;
+	}
+#else
+	for (size_t i = 0; i < k_lanes; ++i) {
+		if (lanes.x[i] * lanes.normalX[i] + lanes.y[i] * lanes.normalY[i] + lanes.distance[i] < lanes.radius[i]) {
+			hits |= 1u << i;
+		}
+	}
+#endif
+	return hits;
+}
+
+physics::Narrowphase::Kernel physics::Narrowphase::getKernel(ShapeType first, ShapeType second)
+{
+	return (first <= second) ? k_kernels[first][second] : k_kernels[second][first];
+}
+
+bool physics::Narrowphase::overlaps(PhysicsObject * first, PhysicsObject * second)
+{
+	ShapeType firstShape = first->getShapeID();
+	ShapeType secondShape = second->getShapeID();
+	if (firstShape > secondShape) {
+		std::swap(first, second);
+		std::swap(firstShape, secondShape);
+	}
+	OverlapTest test = k_overlap_tests[firstShape][secondShape];
+	return test != nullptr && test(first, second);
+}
+
+void physics::Narrowphase::findCollisions(const std::vector<BroadphasePair>& pairs, CollisionList& collisions, JobSystem* jobs,
+	CollisionList* overlaps)
+{
+	// Count pairs for each shape pair, offset by one so prefix sum gives start of each bucket
+	m_bucketStart.fill(0);
+	for (const BroadphasePair& pair : pairs) {
+		ShapeType low = std::min(pair.firstShape, pair.secondShape);
+		ShapeType high = std::max(pair.firstShape, pair.secondShape);
+		++m_bucketStart[low * shape_count + high + 1];
+	}
+	for (size_t i = 1; i <= k_bucket_count; ++i) {
+		m_bucketStart[i] += m_bucketStart[i - 1];
+	}
+
+	// Scatter pairs into buckets, swapping objects into kernel order
+	std::array<size_t, k_bucket_count> cursor;
+	std::copy(m_bucketStart.begin(), m_bucketStart.end() - 1, cursor.begin());
+	m_sorted.resize(pairs.size());
+	m_sensorPairs.clear();
+	for (const BroadphasePair& pair : pairs) {
+		if (!PhysicsObject::canCollide(pair.first, pair.second)) {
+			continue;
+		}
+		if (!pair.first->isAwake() && !pair.second->isAwake()) {
+			// Neither object has moved since they were last tested
+			continue;
+		}
+		if (overlaps != nullptr && (pair.first->isTrigger() || pair.second->isTrigger())) {
+			if (pair.firstShape <= pair.secondShape) {
+				m_sensorPairs.push_back({ pair.first, pair.second });
+			}
+			else {
+				m_sensorPairs.push_back({ pair.second, pair.first });
+			}
+		}
+		else if (pair.firstShape <= pair.secondShape) {
+			m_sorted[cursor[pair.firstShape * shape_count + pair.secondShape]++] = { pair.first, pair.second };
+		}
+		else {
+			m_sorted[cursor[pair.secondShape * shape_count + pair.firstShape]++] = { pair.second, pair.first };
+		}
+	}
+
+	// Triggers have few pairs and cheap tests, so they're tested here rather than in batches
+	for (const ShapePair& pair : m_sensorPairs) {
+		OverlapTest test = k_overlap_tests[pair.first->getShapeID()][pair.second->getShapeID()];
+		if (test != nullptr && test(pair.first, pair.second)) {
+			overlaps->push_back(Collision(true, pair.first, pair.second));
+		}
+	}
+
+	if (jobs == nullptr || jobs->getWorkerCount() == 0) {
+		// Run each kernel over its bucket
+		for (size_t low = 0; low < shape_count; ++low) {
+			for (size_t high = low; high < shape_count; ++high) {
+				Kernel kernel = k_kernels[low][high];
+				size_t bucket = low * shape_count + high;
+				// Filtered pairs leave bucket short of its full size
+				size_t count = cursor[bucket] - m_bucketStart[bucket];
+				if (kernel != nullptr && count > 0) {
+					kernel(&m_sorted[m_bucketStart[bucket]], count, collisions);
+				}
+			}
+		}
+		return;
+	}
+
+	// Split buckets into batches, in same order as above
+	m_batches.clear();
+	for (size_t low = 0; low < shape_count; ++low) {
+		for (size_t high = low; high < shape_count; ++high) {
+			Kernel kernel = k_kernels[low][high];
+			size_t bucket = low * shape_count + high;
+			if (kernel != nullptr) {
+				for (size_t begin = m_bucketStart[bucket]; begin < cursor[bucket]; begin += k_batch_size) {
+					size_t count = cursor[bucket] - begin;
+					m_batches.push_back({ kernel, begin, (count < k_batch_size) ? count : k_batch_size });
+				}
+			}
+		}
+	}
+	if (m_batchCollisions.size() < m_batches.size()) {
+		m_batchCollisions.resize(m_batches.size());
+	}
+	jobs->parallelFor(m_batches.size(), 1, [this](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			const Batch& batch = m_batches[i];
+			m_batchCollisions[i].clear();
+			batch.kernel(&m_sorted[batch.begin], batch.count, m_batchCollisions[i]);
+		}
+	});
+	for (size_t i = 0; i < m_batches.size(); ++i) {
+		collisions.insert(collisions.end(), m_batchCollisions[i].begin(), m_batchCollisions[i].end());
+	}
+}
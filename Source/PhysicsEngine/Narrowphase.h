@@ -0,0 +1,88 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "PhysicsObject.h"
+#include "Broadphase.h"
+
+namespace physics {
+	class JobSystem;
+
+	// Tests pairs found by broadphase for collision
+	// Pairs are bucketed by the shapes involved, then each bucket is passed to a kernel for that
+	// pair of shapes, which tests every pair in the bucket without any virtual calls.
+	// Buckets can be split into batches tested in parallel. Each batch collects its own collisions,
+	// which are joined in batch order, so results are the same as testing on one thread.
+	class Narrowphase {
+	public:
+		static const size_t k_batch_size = 64;	// Pairs tested by each parallel job
+
+		// Pair with shapes in kernel order, so first's shape is never greater than second's
+		struct ShapePair {
+			PhysicsObject* first;
+			PhysicsObject* second;
+		};
+
+		// Tests count pairs of a single pair of shapes, appending each collision found
+		typedef void(*Kernel)(const ShapePair* pairs, size_t count, CollisionList& collisions);
+
+		// Returns whether a pair of shapes overlap, without finding contact details
+		typedef bool(*OverlapTest)(PhysicsObject* first, PhysicsObject* second);
+
+		// Pairs gathered by sphere kernels to be rejected together
+		static const size_t k_lanes = 8;
+
+		// Sphere pairs as structure of arrays, with offset between centres and sum of radii of each
+		struct SphereLanes {
+			float dx[k_lanes];
+			float dy[k_lanes];
+			float radii[k_lanes];
+		};
+
+		// Sphere and plane pairs as structure of arrays
+		struct PlaneLanes {
+			float x[k_lanes];
+			float y[k_lanes];
+			float radius[k_lanes];
+			float normalX[k_lanes];
+			float normalY[k_lanes];
+			float distance[k_lanes];
+		};
+
+		// Returns mask with bit set for each lane whose spheres overlap, comparing squared distances
+		static unsigned overlapping(const SphereLanes& lanes);
+
+		// Returns mask with bit set for each lane whose sphere is less than its radius in front of its plane
+		static unsigned overlapping(const PlaneLanes& lanes);
+
+		Narrowphase();
+
+		// Returns kernel testing given shapes, or nullptr if they can't collide
+		static Kernel getKernel(ShapeType first, ShapeType second);
+
+		// Returns whether objects overlap, using boolean tests which find no contact details
+		static bool overlaps(PhysicsObject* first, PhysicsObject* second);
+
+		// Tests each pair which passes PhysicsObject::canCollide, appending each collision found
+		// jobs = job system to test batches of pairs in parallel, or nullptr to test on this thread
+		// overlaps = if given, pairs with a trigger are only tested for overlap, and each overlapping pair is
+		// appended here with no contact details rather than to collisions
+		void findCollisions(const std::vector<BroadphasePair>& pairs, CollisionList& collisions, JobSystem* jobs = nullptr,
+			CollisionList* overlaps = nullptr);
+
+	protected:
+		static const size_t k_bucket_count = shape_count * shape_count;
+
+		// Range of pairs from one bucket, tested by one job
+		struct Batch {
+			Kernel kernel;
+			size_t begin;
+			size_t count;
+		};
+
+		std::vector<Batch> m_batches;
+		std::vector<CollisionList> m_batchCollisions;	// Collisions found by each batch, kept to reuse memory
+
+		std::vector<ShapePair> m_sorted;					// Pairs grouped by shapes
+		std::vector<ShapePair> m_sensorPairs;				// Pairs with a trigger, in kernel order
+		std::array<size_t, k_bucket_count + 1> m_bucketStart;	// Index of first pair of each shape pair
+	};
+}
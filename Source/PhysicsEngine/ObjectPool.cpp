@@ -0,0 +1,116 @@
+#include "ObjectPool.h"
+
+#include <stdexcept>
+
+physics::PoolStorage::PoolStorage(size_t chunkBlocks)
+	: m_chunkBlocks(chunkBlocks), m_blockSize(0), m_alignment(0), m_next(nullptr), m_end(nullptr), m_free(nullptr),
+	m_used(0), m_capacity(0), m_reserved(0)
+{
+	if (chunkBlocks == 0) {
+		throw std::invalid_argument("Chunks must hold at least one block");
+	}
+}
+
+physics::PoolStorage::~PoolStorage()
+{
+	for (char* chunk : m_chunks) {
+		::operator delete(chunk);
+	}
+}
+
+void * physics::PoolStorage::allocate(size_t size, size_t alignment)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_blockSize == 0 && alignment <= alignof(std::max_align_t)) {
+		// First object decides block size, padded so every block stays aligned
+		m_alignment = std::max(alignment, alignof(FreeBlock));
+		m_blockSize = (std::max(size, sizeof(FreeBlock)) + m_alignment - 1) / m_alignment * m_alignment;
+		if (m_reserved > 0) {
+			addChunk(m_reserved);
+			m_reserved = 0;
+		}
+	}
+	if (!fitsLocked(size, alignment)) {
+		return nullptr;
+	}
+	void* block;
+	if (m_free != nullptr) {
+		block = m_free;
+		m_free = m_free->next;
+	}
+	else {
+		if (m_next == m_end) {
+			addChunk(m_chunkBlocks);
+		}
+		block = m_next;
+		m_next += m_blockSize;
+	}
+	++m_used;
+	return block;
+}
+
+void physics::PoolStorage::deallocate(void * block)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	FreeBlock* freed = (FreeBlock*)block;
+	freed->next = m_free;
+	m_free = freed;
+	--m_used;
+}
+
+bool physics::PoolStorage::fits(size_t size, size_t alignment)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return fitsLocked(size, alignment);
+}
+
+void physics::PoolStorage::reserve(size_t count)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_blockSize == 0) {
+		m_reserved += count;
+	}
+	else if (count > m_capacity - m_used) {
+		// Free list and rest of newest chunk are already available
+		addChunk(count - (m_capacity - m_used));
+	}
+}
+
+size_t physics::PoolStorage::getBlockSize()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_blockSize;
+}
+
+size_t physics::PoolStorage::size()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_used;
+}
+
+size_t physics::PoolStorage::capacity()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_capacity;
+}
+
+bool physics::PoolStorage::fitsLocked(size_t size, size_t alignment)
+{
+	return size <= m_blockSize && alignment <= m_alignment;
+}
+
+void physics::PoolStorage::addChunk(size_t blocks)
+{
+	// Unused end of newest chunk goes on free list, so it isn't lost
+	while (m_next != m_end) {
+		FreeBlock* block = (FreeBlock*)m_next;
+		block->next = m_free;
+		m_free = block;
+		m_next += m_blockSize;
+	}
+	char* chunk = (char*)::operator new(blocks * m_blockSize);
+	m_chunks.push_back(chunk);
+	m_next = chunk;
+	m_end = chunk + blocks * m_blockSize;
+	m_capacity += blocks;
+}
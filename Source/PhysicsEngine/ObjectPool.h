@@ -0,0 +1,144 @@
+#pragma once
+#include "ExternalLibraries.h"
+
+#include <cstddef>
+#include <mutex>
+
+namespace physics {
+	class Sphere;
+	class Box;
+	class Plane;
+	class Spring;
+
+	// Hands out fixed size blocks carved from large chunks
+	// Freed blocks go on a free list to be reused, so creating and destroying objects takes constant time and
+	// never returns memory to the heap until the storage itself is destroyed. Blocks are sized by the first
+	// allocation, and thread safe so objects can be released from any thread.
+	class PoolStorage {
+	public:
+		static const size_t k_def_chunk_blocks = 256;
+
+		PoolStorage(size_t chunkBlocks = k_def_chunk_blocks);
+		~PoolStorage();
+
+		PoolStorage(const PoolStorage& other) = delete;
+		PoolStorage& operator=(const PoolStorage& other) = delete;
+
+		// Returns block for object of given size and alignment, or nullptr if it doesn't fit in a block
+		void* allocate(size_t size, size_t alignment);
+
+		// Returns block to free list. Block must have come from allocate
+		void deallocate(void* block);
+
+		// True if allocate gives blocks for objects of given size and alignment
+		bool fits(size_t size, size_t alignment);
+
+		// Makes room for count more blocks without allocating another chunk
+		void reserve(size_t count);
+
+		size_t getBlockSize();
+
+		// Blocks in use
+		size_t size();
+
+		// Blocks in use or free
+		size_t capacity();
+
+	protected:
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		std::mutex m_mutex;
+		size_t m_chunkBlocks;		// Blocks in each new chunk, unless more are reserved
+		size_t m_blockSize;			// 0 until first allocation
+		size_t m_alignment;
+		std::vector<char*> m_chunks;
+		char* m_next;				// Next unused block in newest chunk
+		char* m_end;				// End of newest chunk
+		FreeBlock* m_free;
+		size_t m_used;
+		size_t m_capacity;
+		size_t m_reserved;			// Blocks to make room for once block size is known
+
+		bool fitsLocked(size_t size, size_t alignment);
+		void addChunk(size_t blocks);
+	};
+
+	// Allocator taking single objects from shared pool storage, and anything else from the heap
+	// Storage is shared with every copy, so a pool outlives the objects made from it
+	template <typename T>
+	class PoolAllocator {
+	public:
+		typedef T value_type;
+
+		PoolAllocator(std::shared_ptr<PoolStorage> storage) : m_storage(storage) {}
+
+		template <typename U>
+		PoolAllocator(const PoolAllocator<U>& other) : m_storage(other.getStorage()) {}
+
+		T* allocate(size_t count)
+		{
+			void* block = count == 1 ? m_storage->allocate(sizeof(T), alignof(T)) : nullptr;
+			if (block == nullptr) {
+				block = ::operator new(count * sizeof(T));
+			}
+			return (T*)block;
+		}
+
+		void deallocate(T* pointer, size_t count)
+		{
+			if (count == 1 && m_storage->fits(sizeof(T), alignof(T))) {
+				m_storage->deallocate(pointer);
+			}
+			else {
+				::operator delete(pointer);
+			}
+		}
+
+		const std::shared_ptr<PoolStorage>& getStorage() const { return m_storage; }
+
+		template <typename U>
+		bool operator==(const PoolAllocator<U>& other) const { return m_storage == other.getStorage(); }
+		template <typename U>
+		bool operator!=(const PoolAllocator<U>& other) const { return m_storage != other.getStorage(); }
+
+	protected:
+		std::shared_ptr<PoolStorage> m_storage;
+	};
+
+	// Creates objects of one type packed together in pool storage
+	// Each object shares its block with its shared_ptr control block, so making one is a single pool allocation
+	template <typename T>
+	class ObjectPool {
+	public:
+		ObjectPool(size_t chunkBlocks = PoolStorage::k_def_chunk_blocks) : m_storage(std::make_shared<PoolStorage>(chunkBlocks)) {}
+
+		template <typename... Args>
+		std::shared_ptr<T> create(Args&&... args)
+		{
+			return std::allocate_shared<T>(PoolAllocator<T>(m_storage), std::forward<Args>(args)...);
+		}
+
+		// Makes room for count more objects without allocating another chunk
+		void reserve(size_t count) { m_storage->reserve(count); }
+
+		// Live objects made by pool
+		size_t size() { return m_storage->size(); }
+
+		size_t capacity() { return m_storage->capacity(); }
+
+		PoolStorage& getStorage() { return *m_storage; }
+
+	protected:
+		std::shared_ptr<PoolStorage> m_storage;
+	};
+
+	// Pools for each type of object created in large numbers, owned by a scene
+	struct ObjectPools {
+		ObjectPool<Sphere> spheres;
+		ObjectPool<Box> boxes;
+		ObjectPool<Plane> planes;
+		ObjectPool<Spring> springs;
+	};
+}
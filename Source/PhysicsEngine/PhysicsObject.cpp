@@ -2,31 +2,54 @@
 #include "ExternalLibraries.h"
 #include "ICollisionObserver.h"
 
+#include <atomic>
+
 physics::PhysicsObject::PhysicsObject(float elasticity, float friction, glm::vec4 colour) 
-	: m_colour(colour), m_alive(true), m_trigger(false), m_draw(true), m_tags(0)
+	: m_colour(colour), m_tags(0), m_layers(Layer::k_default), m_mask(Layer::k_all), m_group(0),
+	m_alive(true), m_trigger(false), m_draw(true)
 {
 	setElasticity(elasticity);
 	setFriction(friction);
 }
 
+physics::PhysicsObjectPtr physics::PhysicsObject::poolClone(ObjectPools & /*pools*/)
+{
+	return PhysicsObjectPtr(clone());
+}
+
 physics::PhysicsObject::PhysicsObject(const PhysicsObject & other) 
-	: m_elasticity(other.m_elasticity), m_friction(other.m_friction), m_colour(other.m_colour),
-	m_trigger(other.m_trigger), m_draw(other.m_draw), m_tags(other.m_tags), m_alive(true)
+	: std::enable_shared_from_this<PhysicsObject>(), m_colour(other.m_colour), m_elasticity(other.m_elasticity),
+	m_friction(other.m_friction), m_tags(other.m_tags), m_layers(other.m_layers), m_mask(other.m_mask),
+	m_group(other.m_group), m_alive(true), m_trigger(other.m_trigger), m_draw(other.m_draw)
 {
 }
 
-void physics::PhysicsObject::broadcastCollision(const Collision & collision)
+void physics::PhysicsObject::broadcastCollision(ContactEvent event, const Collision & collision)
 {
-	auto current = m_observers.begin();
-	while (current != m_observers.end()) {
-		if (current->expired()) {
-			current = m_observers.erase(current);
+	// Observers may subscribe during callbacks, so go by index and drop expired observers afterwards
+	bool expired = false;
+	for (size_t i = 0; i < m_observers.size(); ++i) {
+		CollisionObserverPtr observer = m_observers[i].lock();
+		if (!observer) {
+			expired = true;
+			continue;
 		}
-		else {
-			current->lock()->OnCollision(this, collision);
-			++current;
+		switch (event) {
+		case contact_begin:
+			observer->OnCollisionBegin(this, collision);
+			break;
+		case contact_stay:
+			observer->OnCollisionStay(this, collision);
+			break;
+		case contact_end:
+			observer->OnCollisionEnd(this, collision);
+			break;
 		}
 	}
+	if (expired) {
+		m_observers.erase(std::remove_if(m_observers.begin(), m_observers.end(),
+			[](const CollisionObserverWeakPtr& observer) { return observer.expired(); }), m_observers.end());
+	}
 }
 
 float physics::PhysicsObject::combineElasticity(PhysicsObject* e1, PhysicsObject* e2)
@@ -61,8 +84,9 @@ bool physics::PhysicsObject::addObserver(const CollisionObserverPtr & observer)
 
 bool physics::PhysicsObject::removeObserver(const CollisionObserverPtr & observer)
 {
+	// Left in place until next broadcast, as this may be called while observers are being informed
 	for_each(m_observers.begin(), m_observers.end(),
-		[observer](CollisionObserverWeakPtr o) {
+		[observer](CollisionObserverWeakPtr& o) {
 			if (o.lock() == observer) {
 				o.reset();
 			}
@@ -76,6 +100,39 @@ bool physics::PhysicsObject::isSubscribed(const CollisionObserverPtr & observer)
 	return std::any_of(m_observers.begin(), m_observers.end(), [observer](CollisionObserverWeakPtr c) {return c.lock() == observer; });
 }
 
+unsigned int physics::PhysicsObject::createCollisionGroup()
+{
+	// Soft bodies may be built on another thread while a physics thread runs
+	static std::atomic<unsigned int> nextGroup(0);
+	return ++nextGroup;
+}
+
+void physics::PhysicsObject::addCollisionExclusion(PhysicsObject * other)
+{
+	m_exclusions.push_back(other);
+}
+
+void physics::PhysicsObject::removeCollisionExclusion(PhysicsObject * other)
+{
+	auto exclusion = std::find(m_exclusions.begin(), m_exclusions.end(), other);
+	if (exclusion != m_exclusions.end()) {
+		m_exclusions.erase(exclusion);
+	}
+}
+
+bool physics::PhysicsObject::canCollide(PhysicsObject * first, PhysicsObject * second)
+{
+	if (!Layer::canCollide(first->m_layers, first->m_mask, second->m_layers, second->m_mask)) {
+		return false;
+	}
+	if (first->m_group != 0 && first->m_group == second->m_group) {
+		return false;
+	}
+	// Exclusions are always added to both objects, so only one list needs checking
+	return first->m_exclusions.empty()
+		|| std::find(first->m_exclusions.begin(), first->m_exclusions.end(), second) == first->m_exclusions.end();
+}
+
 void physics::PhysicsObject::setTags(unsigned int tags)
 {
 	m_tags = tags;
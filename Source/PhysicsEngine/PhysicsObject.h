@@ -1,5 +1,10 @@
 #pragma once
 #include "ExternalLibraries.h"
+#include "AABB.h"
+#include "Layer.h"
+#include "FrameArena.h"
+#include "ICollisionObserver.h"
+#include "DrawRecord.h"
 
 
 namespace physics {
@@ -8,7 +13,8 @@ namespace physics {
 		spring,
 		plane,
 		sphere,
-		obox
+		obox,
+		shape_count		// Number of shape types
 	};
 
 	class PhysicsScene;
@@ -18,6 +24,7 @@ namespace physics {
 	class Box;
 	class Plane;
 	class ICollisionObserver;
+	struct ObjectPools;
 
 	typedef std::shared_ptr<PhysicsObject> PhysicsObjectPtr;
 	typedef std::weak_ptr<PhysicsObject> PhysicsObjectWeakPtr;
@@ -25,9 +32,18 @@ namespace physics {
 	typedef std::shared_ptr<ICollisionObserver> CollisionObserverPtr;
 	typedef std::weak_ptr<ICollisionObserver> CollisionObserverWeakPtr;
 
+	// Point in a collision's contact manifold
+	struct ManifoldPoint {
+		glm::vec2 position;
+		float depth;
+		unsigned int feature;	// Identifies point within manifold, so it can be matched with last step's
+	};
+
 	struct Collision {
-		Collision(bool a_success = false, PhysicsObject* a_first = nullptr, PhysicsObject* a_second = nullptr, glm::vec2 a_normal = glm::vec2(0), glm::vec2 a_contact = glm::vec2(0), float a_depth = 0)
-			: success(a_success), first(a_first), second(a_second), normal(a_normal), contact(a_contact), depth(a_depth)
+		static const size_t k_max_points = 2;
+
+		Collision(bool a_success = false, PhysicsObject* a_first = nullptr, PhysicsObject* a_second = nullptr, glm::vec2 a_normal = glm::vec2(0), glm::vec2 a_contact = glm::vec2(0), float a_depth = 0, unsigned int a_feature = 0)
+			: success(a_success), first(a_first), second(a_second), normal(a_normal), contact(a_contact), depth(a_depth), feature(a_feature), pointCount(0)
 		{};
 
 		// Whether the collision occurred
@@ -45,14 +61,36 @@ namespace physics {
 		// Depth by which objects interpenetrate
 		float depth;
 
+		// Identifies the features of each shape in contact, so contact can be matched with last step's
+		unsigned int feature;
+
+		// Points making up contact manifold, for shapes which can touch along an edge
+		// If there are none, contact and depth describe the only point
+		ManifoldPoint points[k_max_points];
+		size_t pointCount;
+
 		operator bool() const { return success; }
 
+		// Adds point to manifold, if there is room
+		void addPoint(glm::vec2 position, float pointDepth, unsigned int pointFeature) {
+			if (pointCount < k_max_points) {
+				points[pointCount++] = { position, pointDepth, pointFeature };
+			}
+		}
+
 		// Returns collision with first and second objects swapped
 		Collision reverse() const {
-			return Collision(success, second, first, -normal, contact, depth);
+			Collision reversed(*this);
+			reversed.first = second;
+			reversed.second = first;
+			reversed.normal = -normal;
+			return reversed;
 		}
 	};
 
+	// Collisions found in a step, taken from the scene's frame arena
+	typedef std::vector<Collision, ArenaAllocator<Collision>> CollisionList;
+
 	// Abstract base class for all physical objects
 	class PhysicsObject : public std::enable_shared_from_this<PhysicsObject> {
 		
@@ -66,20 +104,34 @@ namespace physics {
 		float m_elasticity;	// Coefficient of elasticity
 		float m_friction;	// Coefficient of friction
 		unsigned int m_tags;	// Bitmask for use by observers
+		LayerMask m_layers;		// Collision layers object belongs to
+		LayerMask m_mask;		// Collision layers object can collide with
+		unsigned int m_group;	// Objects sharing a nonzero group don't collide with each other
 		bool m_alive;		// True until object set as dead
 		bool m_trigger;		// If true, no physical effect from collision
-		bool m_draw;		// If true, gizmo will be created for rendering
+		bool m_draw;		// If true, draw record is extracted for rendering
 
 		std::vector<CollisionObserverWeakPtr> m_observers;
 
+		// Objects this can't collide with, such as the other end of a joint
+		// An object may appear more than once if excluded by more than one joint
+		std::vector<PhysicsObject*> m_exclusions;
+
 	public:
+		virtual ~PhysicsObject() {};
+
 		virtual PhysicsObject* clone() = 0;
 
+		// Returns copy made from matching pool, or from heap for types without one
+		// Types deriving from pooled shapes must override this as well as clone, or copies will be sliced
+		virtual PhysicsObjectPtr poolClone(ObjectPools& pools);
+
 		virtual void earlyUpdate(PhysicsScene* m_scene) = 0;
 		virtual void fixedUpdate(PhysicsScene* m_scene) = 0;
 
-		// Draw object with gizmos
-		virtual void makeGizmo(float timeRatio) = 0;
+		// Fills record describing how to draw object, interpolated between last two steps by timeRatio
+		// Returns false if there is nothing to draw
+		virtual bool extractDrawRecord(float timeRatio, DrawRecord& record) = 0;
 
 		glm::vec4 getColour() { return m_colour; }
 		void setColour(glm::vec4 colour) { m_colour = colour; }
@@ -92,6 +144,9 @@ namespace physics {
 
 		virtual bool isPointInside(glm::vec2 point) = 0;
 
+		// Returns world space bounds of object, used by broadphase
+		virtual AABB getAABB() = 0;
+
 		// test collision against other object
 		// returns struct describing collision
 		virtual Collision checkCollision(PhysicsObject* other) = 0;
@@ -99,18 +154,16 @@ namespace physics {
 		virtual Collision checkBoxCollision(Box* other) = 0;
 		virtual Collision checkPlaneCollision(Plane* other) = 0;
 
-		virtual void resolveCollision(PhysicsObject* other, const Collision& col) = 0;
-		virtual void resolveRigidbodyCollision(RigidBody * other, const Collision& col) = 0;
-		virtual void resolvePlaneCollision(Plane* other, const Collision& col) = 0;
-
 		virtual ShapeType getShapeID() = 0;
 
 		virtual float calculateEnergy(PhysicsScene* m_scene) = 0;
 		virtual glm::vec2 calculateMomentum() = 0;
 
-		// Informs all observers that object was collided with
-		// collision = collision to send to observers
-		void broadcastCollision(const Collision& collision);
+		// Informs all observers that object was collided with, dropping observers which no longer exist
+		// event = stage of contact, collision = collision to send to observers
+		void broadcastCollision(ContactEvent event, const Collision& collision);
+
+		bool hasObservers() { return !m_observers.empty(); }
 
 		// Calculates the combined elasticity for a pair of objects
 		// e1,e2 = colliding objects
@@ -122,6 +175,10 @@ namespace physics {
 
 		// Returns true if the object is set as static
 		virtual bool isStatic() = 0;
+
+		// Returns true if the object can move this step
+		// Static objects never move, and sleeping bodies don't until woken
+		virtual bool isAwake() { return !isStatic(); }
 		
 		// Returns true if the object has not been killed
 		bool isAlive() { return m_alive; };
@@ -153,6 +210,28 @@ namespace physics {
 
 		void setTags(unsigned int tags);
 
+		LayerMask getLayers() { return m_layers; }
+		void setLayers(LayerMask layers) { m_layers = layers; }
+
+		LayerMask getCollisionMask() { return m_mask; }
+		void setCollisionMask(LayerMask mask) { m_mask = mask; }
+
+		unsigned int getCollisionGroup() { return m_group; }
+		void setCollisionGroup(unsigned int group) { m_group = group; }
+
+		// Returns a collision group not used by any other caller
+		static unsigned int createCollisionGroup();
+
+		// Prevents collisions with other object until exclusion is removed
+		void addCollisionExclusion(PhysicsObject* other);
+
+		// Removes one exclusion added for other object
+		void removeCollisionExclusion(PhysicsObject* other);
+
+		// Returns true if layers, masks, groups and exclusions allow objects to collide
+		// Checked before narrowphase, so pairs failing this are never tested
+		static bool canCollide(PhysicsObject* first, PhysicsObject* second);
+
 		// Sets passed bits to true in object's tags
 		void addTags(unsigned int tags);
 
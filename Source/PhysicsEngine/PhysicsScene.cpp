@@ -1,38 +1,48 @@
 #include "PhysicsScene.h"
 #include "ExternalLibraries.h"
 #include "PhysicsObject.h"
+#include "RigidBody.h"
+#include "AABBTree.h"
+#include "Trace.h"
+
+#include <cmath>
+#include <stdexcept>
 
 using namespace physics;
 
 const float PhysicsScene::k_def_max_frame = 0.05f;
 
-physics::PhysicsScene::PhysicsScene(float timeStep, glm::vec2 gravity) 
-	: m_timeStep(timeStep), m_gravity(gravity), m_accumulatedTime(0), m_maxFrameLength(k_def_max_frame)
+physics::PhysicsScene::PhysicsScene(float timeStep, glm::vec2 gravity, BroadphaseType broadphase) 
+	: m_gravity(gravity), m_timeStep(timeStep), m_maxFrameLength(k_def_max_frame), m_accumulatedTime(0),
+	m_broadphase(IBroadphase::create(broadphase))
 {
-	if (timeStep <= 0 || isnan(timeStep) || isinf(timeStep)) {
+	if (timeStep <= 0 || std::isnan(timeStep) || std::isinf(timeStep)) {
 		throw std::invalid_argument("Timestep must be positive and finite");
 	}
 }
 
 physics::PhysicsScene::~PhysicsScene()
 {
+	// Actors may outlive scene
+	for (PhysicsObject* actor : m_actors.getObjects()) {
+		detachBody(actor);
+	}
 }
 
 bool physics::PhysicsScene::inScene(PhysicsObject * actor)
 {
-	return std::any_of(m_actors.begin(), m_actors.end(), [actor](PhysicsObjectPtr a) { return a.get() == actor; });
+	return m_actors.contains(actor);
 }
 
 bool physics::PhysicsScene::inScene(PhysicsObjectPtr actor)
 {
-	return std::any_of(m_actors.begin(), m_actors.end(), [actor](PhysicsObjectPtr a) { return a == actor; });
+	return m_actors.contains(actor.get());
 }
 
 bool physics::PhysicsScene::addActor(PhysicsObject * actor)
 {
 	if (!inScene(actor)) {
-		m_actors.push_back(PhysicsObjectPtr(actor));
-		return true;
+		return addActor(PhysicsObjectPtr(actor));
 	}
 	else {
 		return false;
@@ -41,8 +51,9 @@ bool physics::PhysicsScene::addActor(PhysicsObject * actor)
 
 bool physics::PhysicsScene::addActor(PhysicsObjectPtr actor)
 {
-	if (!inScene(actor)) {
-		m_actors.push_back(actor);
+	if (m_actors.add(actor) != ActorHandle()) {
+		attachBody(actor.get());
+		m_broadphase->add(actor.get());
 		return true;
 	}
 	else {
@@ -52,16 +63,63 @@ bool physics::PhysicsScene::addActor(PhysicsObjectPtr actor)
 
 bool physics::PhysicsScene::removeActor(PhysicsObject * actor)
 {
-	m_actors.erase(std::remove_if(m_actors.begin(), m_actors.end(), [actor](PhysicsObjectPtr a) {return a.get() == actor; }), m_actors.end());
+	if (!inScene(actor)) {
+		return false;
+	}
+	wakeNear(actor);
+	m_broadphase->remove(actor);
+	detachBody(actor);
+	m_contactSolver.forget(actor);
+	// Kill before registry drops what may be the last reference
 	actor->kill();
+	forgetDeadContacts();
+	m_actors.remove(actor);
 	return true;
 }
 
 bool physics::PhysicsScene::removeActor(PhysicsObjectPtr actor)
 {
-	m_actors.erase(std::remove(m_actors.begin(), m_actors.end(), actor), m_actors.end());
-	actor->kill();
-	return true;
+	return removeActor(actor.get());
+}
+
+bool physics::PhysicsScene::removeActor(ActorHandle handle)
+{
+	PhysicsObject* actor = m_actors.get(handle);
+	return actor != nullptr && removeActor(actor);
+}
+
+size_t physics::PhysicsScene::addActors(const std::vector<PhysicsObjectPtr>& actors)
+{
+	m_actors.reserve(actors.size());
+	m_bodyStore.reserve(actors.size());
+	size_t added = 0;
+	for (const PhysicsObjectPtr& actor : actors) {
+		if (addActor(actor)) {
+			++added;
+		}
+	}
+	return added;
+}
+
+size_t physics::PhysicsScene::removeActors(const std::vector<PhysicsObjectPtr>& actors)
+{
+	// actors keeps every actor alive until broadphase has dropped them
+	size_t removed = 0;
+	for (const PhysicsObjectPtr& actor : actors) {
+		if (inScene(actor)) {
+			addRemovedBounds(actor.get());
+			detachBody(actor.get());
+			actor->kill();
+			m_actors.remove(actor.get());
+			++removed;
+		}
+	}
+	// Actors killed earlier are also dropped, as they would have been at the end of the next step
+	m_broadphase->removeDead();
+	m_contactSolver.forgetDead();
+	forgetDeadContacts();
+	wakeNearRemoved();
+	return removed;
 }
 
 bool physics::PhysicsScene::inScene(IFixedUpdater * actor)
@@ -128,62 +186,278 @@ bool physics::PhysicsScene::removeUpdater(FixedUpdaterPtr updater)
 void physics::PhysicsScene::clear()
 {
 	m_updaters.clear();
-	for ( auto actor : m_actors) {
+	for (PhysicsObject* actor : m_actors.getObjects()) {
+		detachBody(actor);
 		actor->kill();
 	}
 	m_actors.clear();
+	m_broadphase->clear();
+	m_contactSolver.clear();
+	m_contacts.clear();
+	m_lastContacts.clear();
 }
 
 void physics::PhysicsScene::update(float deltaTime)
 {
+	PHYSICS_TRACE_SCOPE("PhysicsScene::update", "physics");
+	PHYSICS_PROFILE_BEGIN_FRAME(m_profiler);
 	m_accumulatedTime = std::min( m_accumulatedTime +deltaTime, m_maxFrameLength);
 
 	while (m_accumulatedTime >= m_timeStep) {
+		PHYSICS_TRACE_SCOPE("Step", "physics");
+		PHYSICS_PROFILE_COUNT(m_profiler, counter_sub_steps, 1);
 
+		PHYSICS_PROFILE_PHASE(m_profiler, phase_updaters);
 		removePendingUpdaters();
 		for (auto updater : m_updaters) {
 			updater->fixedUpdate(this);
 		}
-		for (auto actor : m_actors) {
+		// Joints apply forces to other actors here, so this runs on one thread
+		PHYSICS_PROFILE_PHASE(m_profiler, phase_early_update);
+		for (PhysicsObject* actor : m_actors.getObjects()) {
 			actor->earlyUpdate(this);
 		}
-		for (auto actor : m_actors) {
-			actor->fixedUpdate(this);
-		}
-		// Test Collisions
-		for (auto firstActor = m_actors.begin(); firstActor != m_actors.end(); ++firstActor) {
-			for (auto otherActor = std::next(firstActor,1); otherActor != m_actors.end(); ++otherActor) {
-				// TODO check layers and masks
-				if (!(*firstActor)->isStatic() || !(*otherActor)->isStatic())
-				{
-					Collision col = (*firstActor)->checkCollision(otherActor->get());
-					if (col) {
-						resolveCollision(col);
-					}
+		// Rigidbodies are integrated straight from the store, each range of slots on its own, apart from
+		// those with their own fixedUpdate
+		PHYSICS_PROFILE_PHASE(m_profiler, phase_fixed_update);
+		for (PhysicsObject* actor : m_actors.getObjects()) {
+			ShapeType shape = actor->getShapeID();
+			if (shape != sphere && shape != obox) {
+				actor->fixedUpdate(this);
+			}
+			else {
+				RigidBody* body = static_cast<RigidBody*>(actor);
+				if (m_bodyStore.flags[body->getSlot()] & BodyStore::custom_update) {
+					body->fixedUpdate(this);
 				}
 			}
 		}
+		m_jobs.parallelFor(m_bodyStore.size(), JobSystem::k_def_grain_size, [this](size_t begin, size_t end) {
+			m_bodyStore.integrate(m_gravity, m_timeStep, begin, end, BodyStore::custom_update);
+		});
+		PHYSICS_PROFILE_COUNT(m_profiler, counter_bodies_integrated, m_bodyStore.size());
+		// Find pairs with overlapping bounds, then test them for collision
+		PHYSICS_PROFILE_PHASE(m_profiler, phase_pairs);
+		m_broadphase->update();
+		PHYSICS_PROFILE_COUNT(m_profiler, counter_pairs_tested, m_broadphase->getPairs().size());
+		{
+			PHYSICS_PROFILE_PHASE(m_profiler, phase_narrowphase);
+			ArenaAllocator<Collision> allocator(&m_frameArena);
+			CollisionList collisions(allocator);
+			CollisionList overlaps(allocator);	// Triggers only need to know what they overlap
+			m_narrowphase.findCollisions(m_broadphase->getPairs(), collisions, &m_jobs, &overlaps);
+			m_broadphase->recordContacts(collisions.size());
+			PHYSICS_PROFILE_COUNT(m_profiler, counter_contacts, collisions.size());
+			// Bodies touching or linked to moving bodies must wake before being solved
+			PHYSICS_PROFILE_PHASE(m_profiler, phase_resolve);
+			if (m_islands.isSleepingEnabled()) {
+				m_islands.build(m_actors.getObjects(), collisions);
+				m_islands.wakeIslands();
+			}
+			for (const Collision& col : collisions) {
+				resolveCollision(col);
+			}
+			for (const Collision& overlap : overlaps) {
+				trackContact(overlap);
+			}
+		}
+		m_contactSolver.solve();
+		PHYSICS_PROFILE_PHASE(m_profiler, phase_events);
+		dispatchCollisionEvents();
+		PHYSICS_PROFILE_PHASE(m_profiler, phase_resolve);
+		m_islands.updateSleep(m_timeStep);
+		PHYSICS_PROFILE_PHASE(m_profiler, phase_remove_dead);
 		removeDeadActors();
+		PHYSICS_PROFILE_END_PHASE(m_profiler);
+		// Everything taken from arena this step has gone
+		m_frameArena.reset();
 		m_accumulatedTime -= m_timeStep;
 	}
-	updateGizmos();
+	PHYSICS_PROFILE_END_FRAME(m_profiler);
 }
 
-void physics::PhysicsScene::updateGizmos()
+void physics::PhysicsScene::extractDrawRecords(std::vector<DrawRecord>& records)
 {
-	// TODO have actors create their gizmos
-	float timeRatio = m_accumulatedTime / m_timeStep;
-	for (auto actor : m_actors) {
-		if (actor->shouldDraw()) {
-			actor->makeGizmo(timeRatio);
+	records.clear();
+	float timeRatio = getTimeRatio();
+	for (PhysicsObject* actor : m_actors.getObjects()) {
+		DrawRecord record = {};
+		if (actor->shouldDraw() && actor->extractDrawRecord(timeRatio, record)) {
+			records.push_back(record);
 		}
 	}
 }
 
+void physics::PhysicsScene::extractDrawSnapshot(DrawSnapshot & snapshot)
+{
+	snapshot.past.clear();
+	snapshot.current.clear();
+	for (PhysicsObject* actor : m_actors.getObjects()) {
+		DrawRecord past = {};
+		DrawRecord current = {};
+		if (actor->shouldDraw() && actor->extractDrawRecord(0, past) && actor->extractDrawRecord(1, current)) {
+			snapshot.past.push_back(past);
+			snapshot.current.push_back(current);
+		}
+	}
+	snapshot.timeRatio = getTimeRatio();
+	snapshot.timeStep = m_timeStep;
+	snapshot.time = DrawSnapshot::Clock::now();
+}
+
 void physics::PhysicsScene::removeDeadActors()
 {
-	m_actors.erase(std::remove_if(m_actors.begin(), m_actors.end(), [](PhysicsObjectPtr a) {return !(a->isAlive()); }), m_actors.end());
+	forgetDeadContacts();
+	m_contactSolver.forgetDead();
+	for (PhysicsObject* actor : m_actors.getObjects()) {
+		if (!actor->isAlive()) {
+			addRemovedBounds(actor);
+			detachBody(actor);
+		}
+	}
+	wakeNearRemoved();
+	// Broadphase must drop dead objects while scene still holds them
+	m_broadphase->removeDead();
+	// Go backwards, so actors moved into removed actors' places have already been checked
+	const std::vector<PhysicsObject*>& actors = m_actors.getObjects();
+	for (size_t i = actors.size(); i > 0; --i) {
+		if (!actors[i - 1]->isAlive()) {
+			m_actors.remove(actors[i - 1]);
+		}
+	}
+
+}
+
+void physics::PhysicsScene::dispatchCollisionEvents()
+{
+	if (m_contacts.empty() && m_lastContacts.empty()) {
+		return;
+	}
+	std::less<PhysicsObject*> less;
+	auto byPair = [less](const TrackedContact& a, const TrackedContact& b) {
+		return less(a.first, b.first) || (a.first == b.first && less(a.second, b.second));
+	};
+	std::sort(m_contacts.begin(), m_contacts.end(), byPair);
+
+	ArenaAllocator<CollisionEvent> allocator(&m_frameArena);
+	std::vector<CollisionEvent, ArenaAllocator<CollisionEvent>> events(allocator);
+	events.reserve(m_contacts.size() + m_lastContacts.size());
+	m_carried.clear();
+	// Contacts only found last step have ended, and go out after this step's contacts in last step's order
+	size_t endOrder = m_contacts.size();
+	auto endContact = [&](const TrackedContact& last) {
+		if (!last.first->isAwake() && !last.second->isAwake()) {
+			// Narrowphase skips pairs which are both asleep, so they're still touching
+			m_carried.push_back(last);
+		}
+		else {
+			events.push_back({ contact_end, endOrder + last.order, last.collision });
+		}
+	};
+
+	// Walk both lists in pair order
+	size_t lastIndex = 0;
+	for (const TrackedContact& contact : m_contacts) {
+		while (lastIndex < m_lastContacts.size() && byPair(m_lastContacts[lastIndex], contact)) {
+			endContact(m_lastContacts[lastIndex++]);
+		}
+		if (lastIndex < m_lastContacts.size() && !byPair(contact, m_lastContacts[lastIndex])) {
+			events.push_back({ contact_stay, contact.order, contact.collision });
+			++lastIndex;
+		}
+		else {
+			events.push_back({ contact_begin, contact.order, contact.collision });
+		}
+	}
+	while (lastIndex < m_lastContacts.size()) {
+		endContact(m_lastContacts[lastIndex++]);
+	}
+
+	// Carried contacts count as found after this step's contacts
+	if (!m_carried.empty()) {
+		for (TrackedContact& carried : m_carried) {
+			carried.order = endOrder++;
+		}
+		m_contacts.insert(m_contacts.end(), m_carried.begin(), m_carried.end());
+		std::sort(m_contacts.begin(), m_contacts.end(), byPair);
+	}
+	m_lastContacts.swap(m_contacts);
+	m_contacts.clear();
+
+	std::sort(events.begin(), events.end(), [](const CollisionEvent& a, const CollisionEvent& b) { return a.order < b.order; });
+	for (const CollisionEvent& event : events) {
+		event.collision.first->broadcastCollision(event.event, event.collision);
+		event.collision.second->broadcastCollision(event.event, event.collision.reverse());
+	}
+}
+
+void physics::PhysicsScene::forgetDeadContacts()
+{
+	m_lastContacts.erase(std::remove_if(m_lastContacts.begin(), m_lastContacts.end(), [](const TrackedContact& contact) {
+		return !contact.first->isAlive() || !contact.second->isAlive();
+	}), m_lastContacts.end());
+}
+
+void physics::PhysicsScene::wakeNear(PhysicsObject * object)
+{
+	AABB bounds = object->getAABB();
+	if (bounds.isEmpty()) {
+		return;
+	}
+	m_nearby.clear();
+	m_broadphase->queryAABB(bounds.fattened(AABBTree::k_def_margin), m_nearby);
+	for (PhysicsObject* other : m_nearby) {
+		ShapeType shape = other->getShapeID();
+		if (other != object && (shape == sphere || shape == obox)) {
+			RigidBody* body = static_cast<RigidBody*>(other);
+			if (body->isDynamic() && !body->isAwake()) {
+				body->setAwake(true);
+			}
+		}
+	}
+}
 
+void physics::PhysicsScene::addRemovedBounds(PhysicsObject * actor)
+{
+	AABB bounds = actor->getAABB();
+	if (!bounds.isEmpty()) {
+		m_removedBounds.push_back(bounds.fattened(AABBTree::k_def_margin));
+	}
+}
+
+void physics::PhysicsScene::wakeNearRemoved()
+{
+	if (m_removedBounds.empty()) {
+		return;
+	}
+	// Bounded boxes are sorted by left edge, so each body only checks those which could reach it
+	// Unbounded ones, such as planes', are few and checked against every body
+	auto unbounded = std::partition(m_removedBounds.begin(), m_removedBounds.end(), [](const AABB& b) { return b.isBounded(); });
+	std::sort(m_removedBounds.begin(), unbounded, [](const AABB& a, const AABB& b) { return a.min.x < b.min.x; });
+	float widest = 0;
+	for (auto it = m_removedBounds.begin(); it != unbounded; ++it) {
+		widest = std::max(widest, it->max.x - it->min.x);
+	}
+	for (size_t slot = 0; slot < m_bodyStore.size(); ++slot) {
+		if (m_bodyStore.flags[slot] & (BodyStore::static_body | BodyStore::awake)) {
+			continue;
+		}
+		RigidBody* body = m_bodyStore.bodies[slot];
+		if (!body->isDynamic()) {
+			continue;
+		}
+		AABB bounds = body->getAABB();
+		bool near = std::any_of(unbounded, m_removedBounds.end(), [&bounds](const AABB& b) { return b.overlaps(bounds); });
+		auto first = std::lower_bound(m_removedBounds.begin(), unbounded, bounds.min.x - widest,
+			[](const AABB& b, float x) { return b.min.x < x; });
+		for (auto it = first; !near && it != unbounded && it->min.x <= bounds.max.x; ++it) {
+			near = it->overlaps(bounds);
+		}
+		if (near) {
+			body->setAwake(true);
+		}
+	}
+	m_removedBounds.clear();
 }
 
 void physics::PhysicsScene::removePendingUpdaters()
@@ -202,7 +476,7 @@ void physics::PhysicsScene::removePendingUpdaters()
 
 void physics::PhysicsScene::setTimeStep(const float timeStep)
 {
-	if (timeStep <= 0 || isnan(timeStep) || isinf(timeStep)) {
+	if (timeStep <= 0 || std::isnan(timeStep) || std::isinf(timeStep)) {
 		throw std::invalid_argument("Timestep must be positive and finite");
 	}
 	m_timeStep = timeStep;
@@ -215,24 +489,93 @@ void physics::PhysicsScene::setMaxFrameLength(const float maxFrameLength)
 
 void physics::PhysicsScene::resolveCollision(const Collision& collision)
 {
-	// Involved objects inform their subscribers
-	collision.first->broadcastCollision(collision);
-	Collision reversed = collision.reverse();
-	collision.second->broadcastCollision(reversed);
+	trackContact(collision);
+	// Solver ignores collisions with triggers
+	m_contactSolver.addCollision(collision);
+}
+
+void physics::PhysicsScene::trackContact(const Collision & collision)
+{
+	if (collision.first->hasObservers() || collision.second->hasObservers()) {
+		if (std::less<PhysicsObject*>()(collision.first, collision.second)) {
+			m_contacts.push_back({ collision.first, collision.second, collision, m_contacts.size() });
+		}
+		else {
+			m_contacts.push_back({ collision.second, collision.first, collision.reverse(), m_contacts.size() });
+		}
+	}
+}
 
-	// If neither are triggers, resolve collision
-	if (!collision.first->isTrigger() && !collision.second->isTrigger()) {
-		collision.first->resolveCollision(collision.second, collision);
+void physics::PhysicsScene::setSleepingEnabled(bool value)
+{
+	m_islands.setSleepingEnabled(value);
+	if (!value) {
+		for (PhysicsObject* actor : m_actors.getObjects()) {
+			ShapeType shape = actor->getShapeID();
+			if (shape == sphere || shape == obox) {
+				RigidBody* body = static_cast<RigidBody*>(actor);
+				if (body->isDynamic() && !body->isAwake()) {
+					body->setAwake(true);
+				}
+			}
+		}
 	}
+}
 
+void physics::PhysicsScene::setBroadphase(BroadphaseType type)
+{
+	m_broadphase = IBroadphase::create(type);
+	for (PhysicsObject* actor : m_actors.getObjects()) {
+		m_broadphase->add(actor);
+	}
+}
 
+std::vector<PhysicsObject*> physics::PhysicsScene::queryAABB(const AABB & bounds)
+{
+	std::vector<PhysicsObject*> results;
+	m_broadphase->queryAABB(bounds, results);
+	return results;
+}
+
+std::vector<PhysicsObject*> physics::PhysicsScene::queryPoint(glm::vec2 point)
+{
+	std::vector<PhysicsObject*> results;
+	m_broadphase->queryPoint(point, results);
+	return results;
 }
 
 float physics::PhysicsScene::calculateEnergy()
 {
 	float energy = 0;
-	for (auto actor : m_actors) {
+	for (PhysicsObject* actor : m_actors.getObjects()) {
 		energy += actor->calculateEnergy(this);
 	}
 	return energy;
 }
+
+void physics::PhysicsScene::attachBody(PhysicsObject * actor)
+{
+	ShapeType shape = actor->getShapeID();
+	if (shape == sphere || shape == obox) {
+		RigidBody* body = static_cast<RigidBody*>(actor);
+		body->setStore(&m_bodyStore);
+		if (body->hasCustomUpdate()) {
+			m_bodyStore.flags[body->getSlot()] |= BodyStore::custom_update;
+		}
+		else {
+			m_bodyStore.flags[body->getSlot()] &= ~BodyStore::custom_update;
+		}
+	}
+}
+
+void physics::PhysicsScene::detachBody(PhysicsObject * actor)
+{
+	ShapeType shape = actor->getShapeID();
+	if (shape == sphere || shape == obox) {
+		RigidBody* body = static_cast<RigidBody*>(actor);
+		// Only move bodies out of this scene
+		if (body->getStore() == &m_bodyStore) {
+			body->setStore(nullptr);
+		}
+	}
+}
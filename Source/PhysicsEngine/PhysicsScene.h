@@ -2,6 +2,16 @@
 #include "ExternalLibraries.h"
 
 #include "IFixedUpdater.h"
+#include "IBroadphase.h"
+#include "Narrowphase.h"
+#include "ContactSolver.h"
+#include "IslandManager.h"
+#include "JobSystem.h"
+#include "BodyStore.h"
+#include "ActorRegistry.h"
+#include "ObjectPool.h"
+#include "DrawRecord.h"
+#include "Profiler.h"
 
 namespace physics {
 	class PhysicsObject;
@@ -14,7 +24,7 @@ namespace physics {
 	public:
 		static const float k_def_max_frame;
 
-		PhysicsScene(float timeStep = 0.01f, glm::vec2 gravity = glm::vec2(0,-10));
+		PhysicsScene(float timeStep = 0.01f, glm::vec2 gravity = glm::vec2(0,-10), BroadphaseType broadphase = sweep_and_prune);
 		~PhysicsScene();
 
 		bool inScene(PhysicsObject* actor);
@@ -25,6 +35,21 @@ namespace physics {
 
 		bool removeActor(PhysicsObject* actor);
 		bool removeActor(PhysicsObjectPtr actor);
+		bool removeActor(ActorHandle handle);
+
+		// Adds each actor not already in scene, including repeats within actors, making room for them all
+		// at once. Returns number of actors added
+		size_t addActors(const std::vector<PhysicsObjectPtr>& actors);
+
+		// Removes each actor in scene, and returns number removed
+		// Broadphase drops them together, rather than searching for each one
+		size_t removeActors(const std::vector<PhysicsObjectPtr>& actors);
+
+		// Returns handle of actor, or invalid handle if it isn't in scene
+		ActorHandle getHandle(PhysicsObject* actor) { return m_actors.find(actor); }
+
+		// Returns actor, or nullptr if it has been removed
+		PhysicsObject* getActor(ActorHandle handle) { return m_actors.get(handle); }
 
 		bool inScene(IFixedUpdater* updater);
 		bool inScene(FixedUpdaterPtr updater);
@@ -40,7 +65,20 @@ namespace physics {
 
 		void update(float deltaTime);
 
-		std::vector<PhysicsObjectPtr> const& getActors() { return m_actors; }
+		// Replaces records with one for each drawn actor, interpolated to time since the last step
+		// Scene never draws itself, so renderers fetch records after updating
+		void extractDrawRecords(std::vector<DrawRecord>& records);
+
+		// Fills snapshot with records of drawn actors at start and end of last step, and current time ratio
+		void extractDrawSnapshot(DrawSnapshot& snapshot);
+
+		// Fraction of a step that has passed since last step
+		float getTimeRatio() const { return m_accumulatedTime / m_timeStep; }
+
+		// Actors in no particular order, as removing an actor moves the last into its place
+		std::vector<PhysicsObjectPtr> const& getActors() { return m_actors.getOwners(); }
+
+		size_t getActorCount() { return m_actors.size(); }
 	
 		glm::vec2 getGravity() { return m_gravity; }
 		void setGravity(glm::vec2 gravity) { m_gravity = gravity; }
@@ -51,23 +89,125 @@ namespace physics {
 		void setMaxFrameLength(const float maxFrameLength);
 		float getMaxFrameLength() const { return m_maxFrameLength; }
 
+		// Adds collision to be solved at the end of the step
+		// Observers of either object are informed once the step's collisions have been solved
 		void resolveCollision(const Collision& collision);
 
 		float calculateEnergy();
 
+		BroadphaseType getBroadphaseType() { return m_broadphase->getType(); }
+
+		// Replaces broadphase with new one of given type, containing all current actors
+		void setBroadphase(BroadphaseType type);
+
+		IBroadphase* getBroadphase() { return m_broadphase.get(); }
+
+		const BroadphaseStats& getBroadphaseStats() { return m_broadphase->getStats(); }
+
+		ContactSolver& getContactSolver() { return m_contactSolver; }
+
+		// Velocity iterations run by contact solver each step. More iterations make piles more stable
+		size_t getSolverIterations() { return m_contactSolver.getIterations(); }
+		void setSolverIterations(size_t iterations) { m_contactSolver.setIterations(iterations); }
+
+		size_t getPositionIterations() { return m_contactSolver.getPositionIterations(); }
+		void setPositionIterations(size_t iterations) { m_contactSolver.setPositionIterations(iterations); }
+
+		IslandManager& getIslandManager() { return m_islands; }
+
+		JobSystem& getJobSystem() { return m_jobs; }
+
+		// State of every rigidbody in scene, integrated together each step
+		BodyStore& getBodyStore() { return m_bodyStore; }
+
+		// Pools to create spheres, boxes, planes and springs from, keeping objects of each type together
+		// Objects may outlive the scene, as each keeps its pool's memory alive
+		ObjectPools& getPools() { return m_pools; }
+
+		// Threads besides the calling thread used to update actors and test collisions
+		// With 0, the scene runs entirely on the calling thread
+		size_t getWorkerCount() { return m_jobs.getWorkerCount(); }
+		void setWorkerCount(size_t workerCount) { m_jobs.setWorkerCount(workerCount); }
+
+		// Sets whether islands of bodies at rest are put to sleep. Disabling wakes all bodies
+		bool isSleepingEnabled() { return m_islands.isSleepingEnabled(); }
+		void setSleepingEnabled(bool value);
+
+		// Time spent in each phase of recent updates, and work done in them
+		// Stats stay empty when built with PHYSICS_NO_PROFILE
+		Profiler& getProfiler() { return m_profiler; }
+
+		// Returns all actors whose bounds overlap bounds
+		std::vector<PhysicsObject*> queryAABB(const AABB& bounds);
+
+		// Returns all actors containing point
+		std::vector<PhysicsObject*> queryPoint(glm::vec2 point);
+
 	protected:
 		glm::vec2 m_gravity;
 		float m_timeStep;
 		float m_maxFrameLength;
 		float m_accumulatedTime;
-		std::vector<PhysicsObjectPtr> m_actors;
+		ObjectPools m_pools;
+		BodyStore m_bodyStore;	// Declared before actors so bodies can leave it as they're destroyed
+		ActorRegistry m_actors;
 		std::vector<FixedUpdaterPtr> m_updaters;
+		JobSystem m_jobs;
 		std::vector<IFixedUpdater *> m_updaterToRemove;
-
-		void updateGizmos();
+		BroadphasePtr m_broadphase;
+		Narrowphase m_narrowphase;
+		FrameArena m_frameArena;	// Memory for data only needed during a step, such as collisions found
+		ContactSolver m_contactSolver;
+		IslandManager m_islands;
+		Profiler m_profiler;
+		std::vector<PhysicsObject*> m_nearby;	// Scratch space for waking objects near removed ones
+		std::vector<AABB> m_removedBounds;		// Scratch space for bounds of actors removed together
+
+		// Collision between a pair of objects, at least one of them observed
+		// Objects are in address order, so the same pair can be matched between steps
+		struct TrackedContact {
+			PhysicsObject* first;
+			PhysicsObject* second;
+			Collision collision;
+			size_t order;		// Position in step's collisions, so events go out in the order found
+		};
+
+		struct CollisionEvent {
+			ContactEvent event;
+			size_t order;
+			Collision collision;
+		};
+
+		std::vector<TrackedContact> m_contacts;		// Contacts found this step
+		std::vector<TrackedContact> m_lastContacts;	// Contacts found last step, sorted by pair
+		std::vector<TrackedContact> m_carried;		// Scratch space for sleeping contacts kept without being found
+
+		// Records collision to inform observers of at end of step, if either object has any
+		void trackContact(const Collision& collision);
+
+		// Compares this step's contacts with last step's, then informs observers of each contact beginning,
+		// staying or ending
+		void dispatchCollisionEvents();
+
+		// Drops contacts with dead objects, which end without informing observers
+		void forgetDeadContacts();
 
 		void removeDeadActors();
 
+		// Wakes bodies near object, which may have been resting on it
+		void wakeNear(PhysicsObject* object);
+
+		// Adds bounds of actor about to be removed to m_removedBounds, for wakeNearRemoved
+		void addRemovedBounds(PhysicsObject* actor);
+
+		// Wakes bodies near any of m_removedBounds in one pass over the body store, then clears them
+		// Used when removing many actors, where querying broadphase for each would be quadratic
+		void wakeNearRemoved();
+
+		// Moves rigidbody's state into scene's store, or back out to the detached store
+		void attachBody(PhysicsObject* actor);
+		void detachBody(PhysicsObject* actor);
+
 		void removePendingUpdaters();
 	};
 }
\ No newline at end of file
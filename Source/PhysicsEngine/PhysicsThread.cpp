@@ -0,0 +1,117 @@
+#include "PhysicsThread.h"
+
+#include "PhysicsScene.h"
+
+#include <stdexcept>
+
+physics::PhysicsThread::PhysicsThread(PhysicsScene * scene)
+	: m_scene(scene), m_running(false), m_ready(0), m_back(1), m_front(2), m_published(0)
+{
+	if (scene == nullptr) {
+		throw std::invalid_argument("Physics thread needs a scene");
+	}
+}
+
+physics::PhysicsThread::~PhysicsThread()
+{
+	try {
+		stop();
+	}
+	catch (...) {
+	}
+}
+
+void physics::PhysicsThread::start()
+{
+	if (isRunning()) {
+		return;
+	}
+	m_error = nullptr;
+	m_running = true;
+	m_thread = std::thread(&PhysicsThread::threadLoop, this);
+}
+
+void physics::PhysicsThread::stop()
+{
+	if (!isRunning()) {
+		return;
+	}
+	m_running = false;
+	m_thread.join();
+	if (m_error) {
+		std::exception_ptr error = m_error;
+		m_error = nullptr;
+		std::rethrow_exception(error);
+	}
+}
+
+void physics::PhysicsThread::post(Command command)
+{
+	std::lock_guard<std::mutex> lock(m_commandMutex);
+	m_commands.push_back(std::move(command));
+}
+
+void physics::PhysicsThread::step(float deltaTime)
+{
+	runCommands();
+	m_scene->update(deltaTime);
+	publish();
+}
+
+const physics::DrawSnapshot & physics::PhysicsThread::getSnapshot()
+{
+	if (m_ready.load(std::memory_order_relaxed) & k_fresh) {
+		// Swap held snapshot for newest, leaving the old one for the physics thread to write
+		m_front = m_ready.exchange(m_front, std::memory_order_acq_rel) & ~k_fresh;
+	}
+	return m_snapshots[m_front];
+}
+
+void physics::PhysicsThread::threadLoop()
+{
+	typedef DrawSnapshot::Clock Clock;
+	Clock::time_point last = Clock::now();
+	while (m_running) {
+		Clock::time_point now = Clock::now();
+		try {
+			step(std::chrono::duration<float>(now - last).count());
+		}
+		catch (...) {
+			m_error = std::current_exception();
+			m_running = false;
+			return;
+		}
+		last = now;
+		// Wait until next step is due
+		float wait = (1 - m_scene->getTimeRatio()) * m_scene->getTimeStep();
+		std::this_thread::sleep_for(std::chrono::duration<float>(wait));
+	}
+}
+
+void physics::PhysicsThread::runCommands()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_commandMutex);
+		m_runningCommands.swap(m_commands);
+	}
+	try {
+		for (Command& command : m_runningCommands) {
+			command(m_scene);
+		}
+	}
+	catch (...) {
+		// Commands after the one that threw are dropped, rather than run again next step
+		m_runningCommands.clear();
+		throw;
+	}
+	m_runningCommands.clear();
+}
+
+void physics::PhysicsThread::publish()
+{
+	DrawSnapshot& snapshot = m_snapshots[m_back];
+	m_scene->extractDrawSnapshot(snapshot);
+	snapshot.step = m_published++;
+	// Hand snapshot over, taking back whichever one reader isn't holding
+	m_back = m_ready.exchange(m_back | k_fresh, std::memory_order_acq_rel) & ~k_fresh;
+}
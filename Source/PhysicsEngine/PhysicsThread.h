@@ -0,0 +1,83 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "DrawRecord.h"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace physics {
+	class PhysicsScene;
+
+	// Steps a scene on its own thread, so slow steps don't hold up rendering
+	// Once started, nothing else may touch the scene. Other threads change it by posting commands, which run
+	// on the physics thread in the order posted, before its next step. After each update the thread publishes
+	// a snapshot of what to draw, which one render thread reads without locking: snapshots are triple
+	// buffered, so the physics thread always has a buffer to write while the reader holds another.
+	// Without starting the thread, calling step each frame runs everything on the calling thread instead.
+	// Bodies may be created on any thread and posted to the scene, but once posted belong to the physics
+	// thread. Bodies a command removes from the scene stay with the physics thread until stopped, so other
+	// threads mustn't use them meanwhile, though they may drop their references to them at any time.
+	class PhysicsThread {
+	public:
+		typedef std::function<void(PhysicsScene* scene)> Command;
+
+		// Scene must outlive thread, or the thread must be stopped before it is destroyed
+		PhysicsThread(PhysicsScene* scene);
+
+		// Stops thread, discarding any error it stopped with
+		~PhysicsThread();
+
+		PhysicsThread(const PhysicsThread& other) = delete;
+		PhysicsThread& operator=(const PhysicsThread& other) = delete;
+
+		// Starts stepping scene in real time on a new thread. Does nothing if already running
+		void start();
+
+		// Waits for thread to finish its current step, then rethrows any exception that stopped it
+		// Commands not yet run stay queued for the next step
+		void stop();
+
+		// True from start until stop, even if an exception ended stepping early
+		bool isRunning() { return m_thread.joinable(); }
+
+		// Queues command to run before next step. Callable from any thread
+		void post(Command command);
+
+		// Runs queued commands, updates scene by deltaTime and publishes snapshot
+		// Called by the thread each time round, or each frame by the owner when the thread isn't running
+		void step(float deltaTime);
+
+		// Returns newest published snapshot, which stays unchanged until the next call
+		// Only one thread may read snapshots
+		const DrawSnapshot& getSnapshot();
+
+		PhysicsScene* getScene() { return m_scene; }
+
+	protected:
+		static const int k_fresh = 4;		// Set on m_ready index until reader takes it
+
+		PhysicsScene* m_scene;
+		std::thread m_thread;
+		std::atomic<bool> m_running;
+		std::exception_ptr m_error;
+
+		std::mutex m_commandMutex;
+		std::vector<Command> m_commands;
+		std::vector<Command> m_runningCommands;		// Commands being run, swapped out so posting doesn't wait
+
+		DrawSnapshot m_snapshots[3];
+		std::atomic<int> m_ready;			// Newest published snapshot, and k_fresh if reader hasn't taken it
+		int m_back;							// Snapshot physics thread writes
+		int m_front;						// Snapshot reader holds
+		size_t m_published;
+
+		// Steps scene until stopped, waiting between steps so it runs in real time
+		void threadLoop();
+
+		void runCommands();
+		void publish();
+	};
+}
@@ -1,15 +1,19 @@
 #include "Plane.h"
+#include "ObjectPool.h"
 #include "Sphere.h"
 #include "Box.h"
 #include "PhysicsScene.h"
 
+#include <cmath>
+#include <stdexcept>
+
 physics::Plane::Plane(glm::vec2 normal, float distance, float elasticity, float friction, glm::vec4 colour)
 	: PhysicsObject(elasticity, friction, colour), m_normal(glm::normalize(normal)), m_distance(distance)
 {
-	if (isinf(distance) || isnan(distance)) {
+	if (std::isinf(distance) || std::isnan(distance)) {
 		throw std::invalid_argument("Distance must be finite");
 	}
-	if (isnan(m_normal.x) || isnan(m_normal.y)) {
+	if (std::isnan(m_normal.x) || std::isnan(m_normal.y)) {
 		throw std::invalid_argument("Invalid normal");
 	}
 }
@@ -24,6 +28,11 @@ physics::PhysicsObject * physics::Plane::clone()
 	return new Plane(*this);
 }
 
+physics::PhysicsObjectPtr physics::Plane::poolClone(ObjectPools & pools)
+{
+	return pools.planes.create(*this);
+}
+
 void physics::Plane::earlyUpdate(PhysicsScene* scene)
 {
 }
@@ -33,14 +42,16 @@ void physics::Plane::fixedUpdate(PhysicsScene* scene)
 	// Do nothing
 }
 
-void physics::Plane::makeGizmo(float timeRatio)
+bool physics::Plane::extractDrawRecord(float timeRatio, DrawRecord& record)
 {
 	float lineSegmentLength = 300;
 	glm::vec2 centerPoint = -m_normal * m_distance;
 	glm::vec2 parallel(m_normal.y, -m_normal.x);
-	glm::vec2 start = centerPoint + (parallel * lineSegmentLength);
-	glm::vec2 end = centerPoint - (parallel * lineSegmentLength);
-	aie::Gizmos::add2DLine(start, end, m_colour);
+	record.shape = draw_line;
+	record.position = centerPoint + (parallel * lineSegmentLength);
+	record.axisX = centerPoint - (parallel * lineSegmentLength);
+	record.colour = m_colour;
+	return true;
 }
 
 physics::Collision physics::Plane::checkCollision(PhysicsObject * other)
@@ -61,6 +72,18 @@ physics::Collision physics::Plane::checkSphereCollision(Sphere * other)
 	return collision;
 }
 
+bool physics::Plane::overlapsSphere(Sphere * other)
+{
+	return distanceToPoint(other->getPosition()) < other->getRadius();
+}
+
+bool physics::Plane::overlapsBox(Box * other)
+{
+	// Box reaches towards plane by its extents projected onto normal
+	float reach = abs(glm::dot(other->getXExtent(), m_normal)) + abs(glm::dot(other->getYExtent(), m_normal));
+	return distanceToPoint(other->getPosition()) < reach;
+}
+
 physics::Collision physics::Plane::checkBoxCollision(Box * other)
 {
 	return other->checkPlaneCollision(this);
@@ -74,7 +97,7 @@ physics::Collision physics::Plane::checkPlaneCollision(Plane * other)
 void physics::Plane::setNormal(glm::vec2 normal)
 {
 	glm::vec2 normalized = glm::normalize(normal);
-	if (isnan(normalized.x) || isnan(normalized.y)) {
+	if (std::isnan(normalized.x) || std::isnan(normalized.y)) {
 		throw std::invalid_argument("Invalid normal");
 	}
 	m_normal = normalized;
@@ -82,13 +105,13 @@ void physics::Plane::setNormal(glm::vec2 normal)
 
 void physics::Plane::setDistance(float distance)
 {
-	if (isinf(distance) || isnan(distance)) {
+	if (std::isinf(distance) || std::isnan(distance)) {
 		throw std::invalid_argument("Distance must be finite");
 	}
 	m_distance = distance;
 }
 
-inline float physics::Plane::distanceToPoint(glm::vec2 point)
+float physics::Plane::distanceToPoint(glm::vec2 point)
 {
 	return glm::dot(point, m_normal) + m_distance;
 }
@@ -97,18 +120,3 @@ physics::ShapeType physics::Plane::getShapeID()
 {
 	return ShapeType::plane;
 }
-
-void physics::Plane::resolveCollision(PhysicsObject* other, const Collision & col)
-{
-	other->resolvePlaneCollision(this, col);
-}
-
-void physics::Plane::resolveRigidbodyCollision(RigidBody * other, const Collision & col)
-{
-	other->resolvePlaneCollision(this, col);
-}
-
-void physics::Plane::resolvePlaneCollision(Plane* other, const Collision & col)
-{
-	// Nothing happens, they're both static
-}
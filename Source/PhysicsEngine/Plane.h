@@ -15,22 +15,26 @@ namespace physics {
 
 		Plane(const Plane& other);
 		virtual PhysicsObject* clone();
+		virtual PhysicsObjectPtr poolClone(ObjectPools& pools);
 
 		virtual void earlyUpdate(PhysicsScene* scene);
 		virtual void fixedUpdate(PhysicsScene* scene);
-		virtual void makeGizmo(float timeRatio);
+		virtual bool extractDrawRecord(float timeRatio, DrawRecord& record);
 
 		virtual bool isPointInside(glm::vec2 point) { return false; }
 
+		// Planes extend infinitely, so overlap everything
+		virtual AABB getAABB() { return AABB::infinite(); }
+
 		virtual Collision checkCollision(PhysicsObject* other);
 		virtual Collision checkSphereCollision(Sphere* other);
 		virtual Collision checkBoxCollision(Box* other);
 		virtual Collision checkPlaneCollision(Plane* other);
 
+		// Return whether object is less than its extent in front of plane, without finding contact details
+		bool overlapsSphere(Sphere* other);
+		bool overlapsBox(Box* other);
 
-		virtual void resolveCollision(PhysicsObject* other, const Collision & col) override;
-		virtual void resolveRigidbodyCollision(RigidBody * other, const Collision & col) override;
-		virtual void resolvePlaneCollision(Plane* other, const Collision & col) override;
 
 		glm::vec2 getNormal() { return m_normal; }
 		void setNormal(glm::vec2 normal);
@@ -38,7 +42,7 @@ namespace physics {
 		float getDistance() { return m_distance; }
 		void setDistance(float distance);
 
-		inline float distanceToPoint(glm::vec2 point);
+		float distanceToPoint(glm::vec2 point);
 
 		virtual ShapeType getShapeID();
 
@@ -0,0 +1,196 @@
+#include "Profiler.h"
+
+#include "Trace.h"
+
+#include <cmath>
+#include <stdexcept>
+
+physics::RollingStats::RollingStats(size_t window) : m_next(0), m_count(0)
+{
+	if (window == 0) {
+		throw std::invalid_argument("Window must hold at least one sample");
+	}
+	m_samples.resize(window);
+	m_sorted.reserve(window);
+}
+
+void physics::RollingStats::add(double sample)
+{
+	m_samples[m_next] = sample;
+	m_next = (m_next + 1) % m_samples.size();
+	m_count = std::min(m_count + 1, m_samples.size());
+}
+
+void physics::RollingStats::clear()
+{
+	m_next = 0;
+	m_count = 0;
+}
+
+double physics::RollingStats::last() const
+{
+	if (m_count == 0) {
+		return 0;
+	}
+	return m_samples[(m_next + m_samples.size() - 1) % m_samples.size()];
+}
+
+double physics::RollingStats::min() const
+{
+	if (m_count == 0) {
+		return 0;
+	}
+	// Samples fill buffer from the start, so first count are always in use
+	return *std::min_element(m_samples.begin(), m_samples.begin() + m_count);
+}
+
+double physics::RollingStats::max() const
+{
+	if (m_count == 0) {
+		return 0;
+	}
+	return *std::max_element(m_samples.begin(), m_samples.begin() + m_count);
+}
+
+double physics::RollingStats::average() const
+{
+	if (m_count == 0) {
+		return 0;
+	}
+	double total = 0;
+	for (size_t i = 0; i < m_count; ++i) {
+		total += m_samples[i];
+	}
+	return total / m_count;
+}
+
+double physics::RollingStats::percentile(double percent) const
+{
+	if (!(percent >= 0 && percent <= 100)) {
+		throw std::invalid_argument("Percentile must be between 0 and 100");
+	}
+	if (m_count == 0) {
+		return 0;
+	}
+	m_sorted.assign(m_samples.begin(), m_samples.begin() + m_count);
+	// Nearest rank
+	size_t rank = (size_t)std::ceil(percent / 100 * m_count);
+	size_t index = rank > 0 ? rank - 1 : 0;
+	std::nth_element(m_sorted.begin(), m_sorted.begin() + index, m_sorted.end());
+	return m_sorted[index];
+}
+
+physics::Profiler::Profiler(size_t window) : m_frameStats(window), m_frames(0), m_phase(k_no_phase)
+{
+	for (RollingStats& stats : m_phaseStats) {
+		stats = RollingStats(window);
+	}
+	for (RollingStats& stats : m_counterStats) {
+		stats = RollingStats(window);
+	}
+	m_frameTimes.fill(0);
+	m_frameCounts.fill(0);
+}
+
+void physics::Profiler::beginFrame()
+{
+	m_frameTimes.fill(0);
+	m_frameCounts.fill(0);
+	m_phase = k_no_phase;
+	m_frameStart = Clock::now();
+}
+
+void physics::Profiler::endFrame()
+{
+	endPhase();
+	if (m_frameCounts[counter_sub_steps] == 0) {
+		return;
+	}
+	std::chrono::duration<double> elapsed = Clock::now() - m_frameStart;
+	m_frameStats.add(elapsed.count());
+	for (size_t i = 0; i < phase_count; ++i) {
+		m_phaseStats[i].add(m_frameTimes[i]);
+	}
+	for (size_t i = 0; i < counter_count; ++i) {
+		m_counterStats[i].add((double)m_frameCounts[i]);
+	}
+	++m_frames;
+}
+
+void physics::Profiler::beginPhase(ProfilePhase phase)
+{
+	Clock::time_point now = Clock::now();
+	finishPhase(now);
+	m_phase = phase;
+	m_phaseStart = now;
+}
+
+void physics::Profiler::endPhase()
+{
+	finishPhase(Clock::now());
+	m_phase = k_no_phase;
+}
+
+void physics::Profiler::finishPhase(Clock::time_point now)
+{
+	if (m_phase == k_no_phase) {
+		return;
+	}
+	m_frameTimes[m_phase] += std::chrono::duration<double>(now - m_phaseStart).count();
+#ifdef PHYSICS_TRACE
+	// Phases show up in traces nested inside the step they belong to
+	Tracer::getInstance().record(getPhaseName((ProfilePhase)m_phase), "physics", m_phaseStart, now);
+#endif
+}
+
+void physics::Profiler::reset()
+{
+	for (RollingStats& stats : m_phaseStats) {
+		stats.clear();
+	}
+	for (RollingStats& stats : m_counterStats) {
+		stats.clear();
+	}
+	m_frameStats.clear();
+	m_frames = 0;
+}
+
+const char * physics::Profiler::getPhaseName(ProfilePhase phase)
+{
+	switch (phase) {
+	case phase_updaters:
+		return "Updaters";
+	case phase_early_update:
+		return "Early update";
+	case phase_fixed_update:
+		return "Fixed update";
+	case phase_pairs:
+		return "Pairs";
+	case phase_narrowphase:
+		return "Narrowphase";
+	case phase_resolve:
+		return "Resolve";
+	case phase_events:
+		return "Events";
+	case phase_remove_dead:
+		return "Remove dead";
+	default:
+		throw std::invalid_argument("Not a profile phase");
+	}
+}
+
+const char * physics::Profiler::getCounterName(ProfileCounter counter)
+{
+	switch (counter) {
+	case counter_pairs_tested:
+		return "Pairs tested";
+	case counter_contacts:
+		return "Contacts";
+	case counter_bodies_integrated:
+		return "Bodies integrated";
+	case counter_sub_steps:
+		return "Sub-steps";
+	default:
+		throw std::invalid_argument("Not a profile counter");
+	}
+}
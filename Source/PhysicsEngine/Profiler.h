@@ -0,0 +1,139 @@
+#pragma once
+#include "ExternalLibraries.h"
+
+#include <chrono>
+
+// Scenes time each phase of their steps and count the work done, unless built with PHYSICS_NO_PROFILE
+// Without it, every profiling macro expands to nothing, so steps do no extra work at all
+#ifndef PHYSICS_NO_PROFILE
+#define PHYSICS_PROFILE
+#endif
+
+#ifdef PHYSICS_PROFILE
+#define PHYSICS_PROFILE_BEGIN_FRAME(profiler) (profiler).beginFrame()
+#define PHYSICS_PROFILE_END_FRAME(profiler) (profiler).endFrame()
+#define PHYSICS_PROFILE_PHASE(profiler, phase) (profiler).beginPhase(phase)
+#define PHYSICS_PROFILE_END_PHASE(profiler) (profiler).endPhase()
+#define PHYSICS_PROFILE_COUNT(profiler, counter, count) (profiler).addCount(counter, count)
+#else
+#define PHYSICS_PROFILE_BEGIN_FRAME(profiler) ((void)0)
+#define PHYSICS_PROFILE_END_FRAME(profiler) ((void)0)
+#define PHYSICS_PROFILE_PHASE(profiler, phase) ((void)0)
+#define PHYSICS_PROFILE_END_PHASE(profiler) ((void)0)
+#define PHYSICS_PROFILE_COUNT(profiler, counter, count) ((void)0)
+#endif
+
+namespace physics {
+
+	// Parts of a scene step timed by profiler
+	enum ProfilePhase {
+		phase_updaters,			// Fixed updaters
+		phase_early_update,		// Actors' early updates, where joints apply forces
+		phase_fixed_update,		// Actors' fixed updates and rigidbody integration
+		phase_pairs,			// Broadphase finding pairs to test
+		phase_narrowphase,		// Testing pairs for collision
+		phase_resolve,			// Waking islands, solving contacts and putting bodies to sleep
+		phase_events,			// Broadcasting collision events to observers
+		phase_remove_dead,		// Removing dead actors
+		phase_count				// Number of phases
+	};
+
+	// Work counted by profiler
+	enum ProfileCounter {
+		counter_pairs_tested,		// Pairs passed from broadphase to narrowphase
+		counter_contacts,			// Colliding pairs found by narrowphase
+		counter_bodies_integrated,	// Rigidbodies integrated
+		counter_sub_steps,			// Steps run
+		counter_count				// Number of counters
+	};
+
+	// Keeps the last window samples of a value, and summarises them
+	// Memory for the window is taken up front, so adding samples never allocates
+	class RollingStats {
+	public:
+		static const size_t k_def_window = 120;
+
+		RollingStats(size_t window = k_def_window);
+
+		void add(double sample);
+		void clear();
+
+		// Samples in window, up to window size
+		size_t count() const { return m_count; }
+		size_t getWindow() const { return m_samples.size(); }
+
+		// Each returns 0 with no samples
+		double last() const;
+		double min() const;
+		double max() const;
+		double average() const;
+
+		// Returns smallest sample which at least percent of samples are less than or equal to
+		double percentile(double percent) const;
+
+	protected:
+		std::vector<double> m_samples;		// Ring buffer, oldest sample at m_next once full
+		size_t m_next;
+		size_t m_count;
+		mutable std::vector<double> m_sorted;	// Scratch space for finding percentiles
+	};
+
+	// Times phases of a scene's steps, and counts work done in them
+	// Each frame is one call to the scene's update. Phase times and counts are summed over every step in a
+	// frame, then added to rolling stats. Frames which run no steps aren't recorded. Stats should only be
+	// read from the thread updating the scene. Each phase is also recorded as a trace event, unless built
+	// with PHYSICS_NO_TRACE
+	class Profiler {
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		Profiler(size_t window = RollingStats::k_def_window);
+
+		// Starts new frame, discarding anything from a frame which wasn't ended
+		void beginFrame();
+
+		// Records frame's totals, if it ran any steps
+		void endFrame();
+
+		// Starts timing phase, ending current phase if there is one
+		void beginPhase(ProfilePhase phase);
+		void endPhase();
+
+		void addCount(ProfileCounter counter, size_t count) { m_frameCounts[counter] += count; }
+
+		// Seconds spent in phase each frame
+		const RollingStats& getPhaseStats(ProfilePhase phase) const { return m_phaseStats[phase]; }
+
+		// Total of counter each frame
+		const RollingStats& getCounterStats(ProfileCounter counter) const { return m_counterStats[counter]; }
+
+		// Seconds spent in each whole frame
+		const RollingStats& getFrameStats() const { return m_frameStats; }
+
+		// Frames recorded since creation or reset
+		size_t getFrameCount() const { return m_frames; }
+
+		// Clears all stats
+		void reset();
+
+		static const char* getPhaseName(ProfilePhase phase);
+		static const char* getCounterName(ProfileCounter counter);
+
+	protected:
+		static const int k_no_phase = -1;
+
+		std::array<RollingStats, phase_count> m_phaseStats;
+		std::array<RollingStats, counter_count> m_counterStats;
+		RollingStats m_frameStats;
+		size_t m_frames;
+
+		Clock::time_point m_frameStart;
+		Clock::time_point m_phaseStart;
+		int m_phase;								// Phase being timed, or k_no_phase
+		std::array<double, phase_count> m_frameTimes;
+		std::array<size_t, counter_count> m_frameCounts;
+
+		// Adds time since current phase began to its total, and traces it
+		void finishPhase(Clock::time_point now);
+	};
+}
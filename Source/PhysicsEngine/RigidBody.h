@@ -1,6 +1,7 @@
 #pragma once
 #include "ExternalLibraries.h"
 #include "PhysicsObject.h"
+#include "BodyStore.h"
 
 namespace physics
 {
@@ -17,10 +18,21 @@ namespace physics
 
 		RigidBody(const RigidBody& other);
 
+		virtual ~RigidBody();
+
+		// Slot in store can't be shared between bodies
+		RigidBody& operator=(const RigidBody& other) = delete;
+
 		virtual void earlyUpdate(PhysicsScene* scene);
 
+		// Steps body on its own. Scenes integrate their bodies together instead, and only call this for
+		// bodies whose hasCustomUpdate returns true
 		virtual void fixedUpdate(PhysicsScene* scene);
 
+		// Subclasses overriding fixedUpdate must override this to return true, or scenes won't call it
+		// Checked when body is added to a scene
+		virtual bool hasCustomUpdate() { return false; }
+
 		// Instantaneous change in momentum
 		void applyImpulse(glm::vec2 force);
 		void applyImpulse(glm::vec2 force, glm::vec2 contact);
@@ -35,19 +47,22 @@ namespace physics
 		void applyForceFromOther(RigidBody* other, glm::vec2 force);
 		void applyForceFromOther(RigidBody* other, glm::vec2 force, glm::vec2 contact);
 
-		glm::vec2 getPosition() { return m_position; }
+		glm::vec2 getPosition() { return m_store->position[m_slot]; }
 		void setPosition(glm::vec2 position);
 
-		glm::vec2 getPastPosition() { return m_pastPosition; }
+		glm::vec2 getPastPosition() { return m_store->pastPosition[m_slot]; }
 
-		glm::vec2 getVelocity() { return m_velocity; }
+		glm::vec2 getVelocity() { return m_store->velocity[m_slot]; }
 		void setVelocity(glm::vec2 velocity);
 
 		float getOrientation();
 		void setOrientation(float orientation);
 
-		glm::vec2 getLocalX() { return m_localX; }
-		glm::vec2 getLocalY() { return m_localY; }
+		glm::vec2 getLocalX() { return m_store->localX[m_slot]; }
+		glm::vec2 getLocalY() { return m_store->localY[m_slot]; }
+
+		glm::vec2 getPastX() { return m_store->pastX[m_slot]; }
+		glm::vec2 getPastY() { return m_store->pastY[m_slot]; }
 
 		virtual float getWidth() = 0;
 		virtual float getHeight() = 0;
@@ -59,10 +74,10 @@ namespace physics
 		float getMass();
 		void setMass(float mass);
 
-		float getDrag() { return m_drag; }
+		float getDrag() { return m_store->drag[m_slot]; }
 		void setDrag(float drag);
 
-		float getAngularDrag() { return m_angularDrag; }
+		float getAngularDrag() { return m_store->angularDrag[m_slot]; }
 		void setAngularDrag(float drag);
 
 		float getInvMass();
@@ -71,17 +86,34 @@ namespace physics
 
 		float getInvMoment();
 
-		virtual bool isStatic() { return m_static; };
+		virtual bool isStatic() { return (m_store->flags[m_slot] & BodyStore::static_body) != 0; };
 
 		// Sets body as static. On becoming static, body gets infinite mass and zero velocity
 		void setStatic(bool value);
 
-		inline bool isKinematic() { return m_invMass == 0; }
+		inline bool isKinematic() { return m_store->invMass[m_slot] == 0; }
 
 		inline bool isDynamic() { return !(isKinematic() || isStatic()); };
 
+		virtual bool isAwake() { return (m_store->flags[m_slot] & (BodyStore::static_body | BodyStore::awake)) == BodyStore::awake; }
+
+		// Wakes body, or puts it to sleep. Sleeping bodies are stopped, and skip integration and collision
+		// tests against other sleeping or static objects until woken
+		void setAwake(bool value);
+
+		// Time body has been moving slowly enough to sleep
+		float getSleepTime() { return m_sleepTime; }
+		void setSleepTime(float time) { m_sleepTime = time; }
+
 		virtual void resetAlive();
 
+		// Store holding body's state, and body's index in it
+		BodyStore* getStore() { return m_store; }
+		size_t getSlot() { return m_slot; }
+
+		// Moves body's state into store, keeping its value. nullptr moves it to the detached store
+		void setStore(BodyStore* store);
+
 		glm::vec2 localToWorldSpace(glm::vec2 localPos);
 
 		glm::vec2 pastLocalToWorldSpace(glm::vec2 localPos);
@@ -92,43 +124,25 @@ namespace physics
 
 		virtual glm::vec2 calculateMomentum();
 
-		virtual void resolveCollision(PhysicsObject* other, const Collision & col) override;
-		virtual void resolveRigidbodyCollision(RigidBody * other, const Collision & col) override;
-		virtual void resolvePlaneCollision(Plane* other, const Collision & col) override;
-
 	protected:
-		glm::vec2 m_position;
-		glm::vec2 m_pastPosition; // Used to avoid temporal aliasing
-		glm::vec2 m_velocity;
-		glm::vec2 m_totalForce;
-		
-		float m_mass;
-		float m_invMass;
-
-		float m_moment;
-		float m_invMoment;
-
-		float m_drag;
-		float m_angularDrag;
-
-		float m_orientation;
+		friend struct BodyStore;
 
-		glm::vec2 m_localX;
-		glm::vec2 m_localY;
+		// Position, velocity and other state used every step live in the store, past position and
+		// axes being kept to avoid temporal aliasing
+		BodyStore* m_store;
+		size_t m_slot;
 
-		glm::vec2 m_pastX;
-		glm::vec2 m_pastY;
-
-		float m_angularVelocity;
-		float m_totalTorque;
-
-		bool m_static;
+		float m_mass;
+		float m_moment;
 
-		void seperateObjects(RigidBody* other, glm::vec2 displacement);
+		float m_sleepTime;
 
 		// Calculates moment of inertia using correct formula for shape
 		virtual void calculateMoment() = 0;
 
+		// Sets moment of inertia and its inverse
+		void setMoment(float moment);
+
 		void calculateAxes();
 	};
 
@@ -0,0 +1,66 @@
+#pragma once
+#include "ExternalLibraries.h"
+
+// Vectorized kernels use SSE2 to handle four lanes per instruction where available
+// Define PHYSICS_NO_SIMD to build their scalar paths instead
+#if !defined(PHYSICS_NO_SIMD) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#define PHYSICS_SIMD
+#endif
+
+#ifdef PHYSICS_SIMD
+#include <emmintrin.h>
+
+namespace physics {
+	namespace simd {
+		// Selects a where mask is set, otherwise b
+		inline __m128 select(__m128 mask, __m128 a, __m128 b)
+		{
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+
+		// Loads four vec2 as separate x and y
+		inline void loadVec2(const glm::vec2* source, __m128& x, __m128& y)
+		{
+			__m128 first = _mm_loadu_ps(&source[0].x);
+			__m128 second = _mm_loadu_ps(&source[2].x);
+			x = _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+			y = _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+		}
+
+		// Stores four vec2 from separate x and y
+		inline void storeVec2(glm::vec2* destination, __m128 x, __m128 y)
+		{
+			_mm_storeu_ps(&destination[0].x, _mm_unpacklo_ps(x, y));
+			_mm_storeu_ps(&destination[2].x, _mm_unpackhi_ps(x, y));
+		}
+
+		// Sine and cosine of four angles in [-pi, pi]
+		// Reduces each angle to within pi/4 of a multiple of pi/2, then uses the minimax polynomials from Cephes,
+		// swapping and negating results depending on the quadrant
+		inline void sincos(__m128 angle, __m128& sin, __m128& cos)
+		{
+			__m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(glm::two_over_pi<float>())));
+			__m128 quadrantF = _mm_cvtepi32_ps(quadrant);
+			// pi/2 split in two, so reduction doesn't lose precision
+			__m128 r = _mm_sub_ps(angle, _mm_mul_ps(quadrantF, _mm_set1_ps(1.5703125f)));
+			r = _mm_sub_ps(r, _mm_mul_ps(quadrantF, _mm_set1_ps(4.8382679e-4f)));
+			__m128 z = _mm_mul_ps(r, r);
+
+			__m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+			s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(-1.6666654611e-1f));
+			s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), r), r);
+
+			__m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(-1.388731625493765e-3f));
+			c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(4.166664568298827e-2f));
+			c = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(c, z), z), _mm_sub_ps(_mm_set1_ps(1), _mm_mul_ps(_mm_set1_ps(0.5f), z)));
+
+			// Odd quadrants swap sine and cosine, and bit 1 of the quadrant gives the sign
+			__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+			__m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+			__m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+			sin = _mm_xor_ps(select(swap, c, s), sinSign);
+			cos = _mm_xor_ps(select(swap, s, c), cosSign);
+		}
+	}
+}
+#endif
@@ -1,16 +1,17 @@
 #include "SoftBody.h"
-#include "Rigidbody.h"
+#include "RigidBody.h"
 #include "Sphere.h"
 #include "Spring.h"
 
-physics::SoftBody::SoftBody()
+physics::SoftBody::SoftBody() : m_group(PhysicsObject::createCollisionGroup()), m_selfCollision(true)
 {
 }
 
 physics::SoftBody::SoftBody(glm::vec2 position, RigidBody* particle, size_t cols, size_t rows,
 	float distance, float strength, float shearStrength, float bendStrength,
-	float damping, glm::vec4 springColour) 
-	: m_particles(cols, std::vector<RigidBodyPtr>(rows, RigidBodyPtr())), m_structureSprings(), m_shearSprings(), m_bendSprings()
+	float damping, glm::vec4 springColour, ObjectPools* pools) 
+	: m_particles(cols, std::vector<RigidBodyPtr>(rows, RigidBodyPtr())), m_structureSprings(), m_shearSprings(), m_bendSprings(),
+	m_group(PhysicsObject::createCollisionGroup()), m_selfCollision(true)
 {
 	// Reserve memory for new objects
 	if (cols > 0 && rows > 0) {
@@ -31,6 +32,12 @@ physics::SoftBody::SoftBody(glm::vec2 position, RigidBody* particle, size_t cols
 		m_structureSprings.reserve(std::max(cols, rows) - 2);
 	}
 
+	if (cols > 0 && rows > 0) {
+		size_t springs = cols * (rows - 1) + rows * (cols - 1) + 2 * (cols - 1) * (rows - 1);
+		springs += cols * (rows > 2 ? rows - 2 : 0) + rows * (cols > 2 ? cols - 2 : 0);
+		reservePools(particle, cols * rows, springs, pools);
+	}
+
 	//float diagonalDistance = sqrtf(2 * distance * distance);
 
 	glm::vec2 localX = particle->getLocalX();
@@ -57,30 +64,30 @@ physics::SoftBody::SoftBody(glm::vec2 position, RigidBody* particle, size_t cols
 
 	for (size_t x = 0; x < cols; ++x) {
 		for (size_t y = 0; y < rows; ++y) {
-			m_particles[x][y] = RigidBodyPtr((RigidBody*)particle->clone());
+			m_particles[x][y] = makeParticle(particle, pools);
 			m_particles[x][y]->setPosition(position +(float)x * distance * localX + (float)y * distance * localY);
 			if (y >= 1) {
 				// Attach structure spring to last row
-				m_structureSprings.push_back(std::make_shared<Spring>(strength, yEdgeDistance, damping, m_particles[x][y], m_particles[x][y - 1], bottom, top));
+				m_structureSprings.push_back(makeSpring(pools, strength, yEdgeDistance, damping, m_particles[x][y], m_particles[x][y - 1], bottom, top));
 				if (y >= 2) {
 					// Attach bend spring two rows back
-					m_bendSprings.push_back(std::make_shared<Spring>(bendStrength, 2* distance, damping, m_particles[x][y], m_particles[x][y-2]));	
+					m_bendSprings.push_back(makeSpring(pools, bendStrength, 2* distance, damping, m_particles[x][y], m_particles[x][y-2]));	
 				}
 			}
 			if (x >= 1) {
 				// Attach structure spring to last column
-				m_structureSprings.push_back(std::make_shared<Spring>(strength, xEdgeDistance, damping, m_particles[x][y], m_particles[x-1][y], left, right));
+				m_structureSprings.push_back(makeSpring(pools, strength, xEdgeDistance, damping, m_particles[x][y], m_particles[x-1][y], left, right));
 				if ( x >= 2) {
 					// Attach bend spring two columns back
-					m_bendSprings.push_back(std::make_shared<Spring>(bendStrength, 2* distance, damping, m_particles[x][y], m_particles[x-2][y]));	
+					m_bendSprings.push_back(makeSpring(pools, bendStrength, 2* distance, damping, m_particles[x][y], m_particles[x-2][y]));	
 				}
 				if (y >= 1) {
 					// Attach shear spring to last column and row
-					m_shearSprings.push_back(std::make_shared<Spring>(shearStrength, diagonalDistance, damping, m_particles[x][y], m_particles[x - 1][y - 1],-topRight,topRight));	
+					m_shearSprings.push_back(makeSpring(pools, shearStrength, diagonalDistance, damping, m_particles[x][y], m_particles[x - 1][y - 1],-topRight,topRight));	
 				}
 				if (y + 1 < rows) {
 					// Attach shear spring to last column and next row
-					m_shearSprings.push_back(std::make_shared<Spring>(shearStrength, diagonalDistance, damping, m_particles[x][y], m_particles[x - 1][y + 1], -bottomRight, bottomRight));
+					m_shearSprings.push_back(makeSpring(pools, shearStrength, diagonalDistance, damping, m_particles[x][y], m_particles[x - 1][y + 1], -bottomRight, bottomRight));
 				}
 			}
 		}
@@ -89,30 +96,42 @@ physics::SoftBody::SoftBody(glm::vec2 position, RigidBody* particle, size_t cols
 
 void physics::SoftBody::addToScene(physics::PhysicsScene * scene)
 {
-	for (auto column : m_particles) {
-		for (auto particle : column) {
-			PhysicsObjectPtr object = std::dynamic_pointer_cast<PhysicsObject, RigidBody>(particle);
-			if (object) {
-				scene->addActor(object);
+	std::vector<PhysicsObjectPtr> actors;
+	getActors(actors);
+	scene->addActors(actors);
+}
+
+void physics::SoftBody::removeFromScene(PhysicsScene * scene)
+{
+	std::vector<PhysicsObjectPtr> actors;
+	getActors(actors);
+	scene->removeActors(actors);
+}
+
+void physics::SoftBody::getActors(std::vector<PhysicsObjectPtr>& actors)
+{
+	size_t particles = m_particles.empty() ? 0 : m_particles.size() * m_particles[0].size();
+	actors.reserve(actors.size() + particles + m_structureSprings.size() + m_shearSprings.size() + m_bendSprings.size());
+	for (const auto& column : m_particles) {
+		for (const RigidBodyPtr& particle : column) {
+			if (particle) {
+				actors.push_back(particle);
 			}
 		}
 	}
-	for (auto spring : m_structureSprings) {
-		PhysicsObjectPtr object = std::dynamic_pointer_cast<PhysicsObject, Spring>(spring);
-		if (object) {
-			scene->addActor(object);
+	for (const SpringPtr& spring : m_structureSprings) {
+		if (spring) {
+			actors.push_back(spring);
 		}
 	}
-	for (auto spring : m_shearSprings) {
-		PhysicsObjectPtr object = std::dynamic_pointer_cast<PhysicsObject, Spring>(spring);
-		if (object) {
-			scene->addActor(object);
+	for (const SpringPtr& spring : m_shearSprings) {
+		if (spring) {
+			actors.push_back(spring);
 		}
 	}
-	for (auto spring : m_bendSprings) {
-		PhysicsObjectPtr object = std::dynamic_pointer_cast<PhysicsObject, Spring>(spring);
-		if (object) {
-			scene->addActor(object);
+	for (const SpringPtr& spring : m_bendSprings) {
+		if (spring) {
+			actors.push_back(spring);
 		}
 	}
 }
@@ -186,3 +205,53 @@ void physics::SoftBody::setDamping(float damping)
 		s->setDamping(damping);
 	}
 }
+
+void physics::SoftBody::setSelfCollision(bool value)
+{
+	m_selfCollision = value;
+	for (const auto& column : m_particles) {
+		for (const RigidBodyPtr& particle : column) {
+			if (!particle) {
+				continue;
+			}
+			if (!value) {
+				particle->setCollisionGroup(m_group);
+			}
+			else if (particle->getCollisionGroup() == m_group) {
+				// Leave groups the caller has since given particles
+				particle->setCollisionGroup(0);
+			}
+		}
+	}
+}
+
+physics::RigidBodyPtr physics::SoftBody::makeParticle(RigidBody * particle, ObjectPools * pools)
+{
+	if (pools == nullptr) {
+		return RigidBodyPtr((RigidBody*)particle->clone());
+	}
+	return std::static_pointer_cast<RigidBody>(particle->poolClone(*pools));
+}
+
+void physics::SoftBody::reservePools(RigidBody * particle, size_t particles, size_t springs, ObjectPools * pools)
+{
+	if (pools == nullptr) {
+		return;
+	}
+	if (particle->getShapeID() == ShapeType::sphere) {
+		pools->spheres.reserve(particles);
+	}
+	else if (particle->getShapeID() == ShapeType::obox) {
+		pools->boxes.reserve(particles);
+	}
+	pools->springs.reserve(springs);
+}
+
+physics::SpringPtr physics::SoftBody::makeSpring(ObjectPools * pools, float tightness, float length, float damping,
+	RigidBodyPtr end1, RigidBodyPtr end2, glm::vec2 anchor1, glm::vec2 anchor2)
+{
+	if (pools == nullptr) {
+		return std::make_shared<Spring>(tightness, length, damping, end1, end2, anchor1, anchor2);
+	}
+	return pools->springs.create(tightness, length, damping, end1, end2, anchor1, anchor2);
+}
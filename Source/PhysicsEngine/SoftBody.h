@@ -1,5 +1,6 @@
 #pragma once
 #include "PhysicsScene.h"
+#include "ObjectPool.h"
 
 namespace physics {
 	class RigidBody;
@@ -15,11 +16,18 @@ namespace physics {
 	public:
 		SoftBody();
 
-		SoftBody(glm::vec2 position, RigidBody* particle, size_t cols, size_t rows, float distance, float strength, float shearStrength, float bendStrength, float damping, glm::vec4 springColour = { 1,1,1,1 });
+		// If pools is given, particles and springs are made from them rather than the heap
+		SoftBody(glm::vec2 position, RigidBody* particle, size_t cols, size_t rows, float distance, float strength, float shearStrength, float bendStrength, float damping, glm::vec4 springColour = { 1,1,1,1 }, ObjectPools* pools = nullptr);
 
 		// Adds each object from body to scene
 		void addToScene(PhysicsScene* scene);
 
+		// Removes each object from body from scene
+		void removeFromScene(PhysicsScene* scene);
+
+		// Appends particles, then springs, to actors
+		void getActors(std::vector<PhysicsObjectPtr>& actors);
+
 		// Kills all objects making up soft body
 		void kill();
 
@@ -38,6 +46,13 @@ namespace physics {
 		// Sets damping on springs
 		void setDamping(float damping);
 
+		bool getSelfCollision() { return m_selfCollision; }
+
+		// Sets whether particles can collide with each other
+		// Springs already keep particles apart, so turning this off saves testing every pair of particles
+		// Turning it on only takes particles out of the soft body's own collision group, not any other group
+		void setSelfCollision(bool value);
+
 		const std::vector<std::vector<RigidBodyPtr>>& getParticles() { return m_particles; }
 
 	protected:
@@ -45,5 +60,16 @@ namespace physics {
 		std::vector<SpringPtr> m_structureSprings;
 		std::vector<SpringPtr> m_shearSprings;
 		std::vector<SpringPtr> m_bendSprings;
+		unsigned int m_group;	// Collision group shared by particles
+		bool m_selfCollision;
+
+		// Copies particle, from pools if given
+		static RigidBodyPtr makeParticle(RigidBody* particle, ObjectPools* pools);
+
+		// Makes room in pools for particles and springs about to be made
+		static void reservePools(RigidBody* particle, size_t particles, size_t springs, ObjectPools* pools);
+
+		static SpringPtr makeSpring(ObjectPools* pools, float tightness, float length, float damping, RigidBodyPtr end1, RigidBodyPtr end2,
+			glm::vec2 anchor1 = { 0,0 }, glm::vec2 anchor2 = { 0,0 });
 	};
 }
\ No newline at end of file
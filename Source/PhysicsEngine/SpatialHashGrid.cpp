@@ -0,0 +1,236 @@
+#include "SpatialHashGrid.h"
+#include "PhysicsObject.h"
+#include "RigidBody.h"
+
+#include <cmath>
+#include <stdexcept>
+
+const float physics::SpatialHashGrid::k_def_cell_size = 1.f;
+const float physics::SpatialHashGrid::k_cell_size_factor = 1.f;
+const size_t physics::SpatialHashGrid::k_max_cells = 64;
+
+// Cell coordinates beyond this are treated as oversized, to avoid integer overflow
+static const float k_max_cell_coord = 1.0e9f;
+
+physics::SpatialHashGrid::SpatialHashGrid(float cellSize) : m_nextID(0), m_cellSize(k_def_cell_size), m_autoCellSize(true)
+{
+	setCellSize(cellSize);
+}
+
+void physics::SpatialHashGrid::add(PhysicsObject * object)
+{
+	AABB bounds = object->getAABB();
+	if (!bounds.isEmpty()) {
+		m_proxies.push_back({ object, dynamic_cast<RigidBody*>(object), m_nextID, bounds, object->isStatic(), object->getShapeID(), glm::ivec2(1), glm::ivec2(0) });
+	}
+	++m_nextID;
+}
+
+void physics::SpatialHashGrid::remove(PhysicsObject * object)
+{
+	m_proxies.erase(std::remove_if(m_proxies.begin(), m_proxies.end(), [object](const Proxy& p) {return p.object == object; }), m_proxies.end());
+}
+
+void physics::SpatialHashGrid::removeDead()
+{
+	m_proxies.erase(std::remove_if(m_proxies.begin(), m_proxies.end(), [](const Proxy& p) {return !p.object->isAlive(); }), m_proxies.end());
+}
+
+void physics::SpatialHashGrid::clear()
+{
+	m_proxies.clear();
+	m_pairs.clear();
+	m_entries.clear();
+	m_oversized.clear();
+}
+
+void physics::SpatialHashGrid::queryAABB(const AABB & bounds, std::vector<PhysicsObject*>& results)
+{
+	for (const Proxy& proxy : m_proxies) {
+		if (proxy.bounds.overlaps(bounds)) {
+			results.push_back(proxy.object);
+		}
+	}
+}
+
+void physics::SpatialHashGrid::queryPoint(glm::vec2 point, std::vector<PhysicsObject*>& results)
+{
+	for (const Proxy& proxy : m_proxies) {
+		if (proxy.bounds.contains(point) && proxy.object->isPointInside(point)) {
+			results.push_back(proxy.object);
+		}
+	}
+}
+
+void physics::SpatialHashGrid::setCellSize(float cellSize)
+{
+	if (cellSize < 0 || std::isnan(cellSize) || std::isinf(cellSize)) {
+		throw std::invalid_argument("Cell size must be positive and finite, or zero for automatic sizing");
+	}
+	m_autoCellSize = (cellSize == 0);
+	if (!m_autoCellSize) {
+		m_cellSize = cellSize;
+	}
+}
+
+void physics::SpatialHashGrid::findPairs()
+{
+	for (Proxy& proxy : m_proxies) {
+		proxy.bounds = proxy.object->getAABB();
+		proxy.isStatic = proxy.object->isStatic();
+	}
+	if (m_autoCellSize) {
+		calculateCellSize();
+	}
+	buildGrid();
+
+	m_pairs.clear();
+	size_t bucketCount = m_bucketStart.size() - 1;
+	for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+		size_t end = m_bucketStart[bucket + 1];
+		for (size_t i = m_bucketStart[bucket]; i < end; ++i) {
+			const CellEntry& firstEntry = m_entries[i];
+			const Proxy& first = m_proxies[firstEntry.proxy];
+			for (size_t j = i + 1; j < end; ++j) {
+				const CellEntry& secondEntry = m_entries[j];
+				// Different cells may share a bucket
+				if (firstEntry.cell != secondEntry.cell) {
+					continue;
+				}
+				const Proxy& second = m_proxies[secondEntry.proxy];
+				// Objects sharing several cells are only paired in the cell holding the corner of their overlap
+				if (cellAt(glm::max(first.bounds.min, second.bounds.min)) != firstEntry.cell) {
+					continue;
+				}
+				testPair(first, second);
+			}
+		}
+	}
+	// Oversized objects are tested against everything else
+	for (size_t i = 0; i < m_oversized.size(); ++i) {
+		const Proxy& first = m_proxies[m_oversized[i]];
+		for (size_t j = i + 1; j < m_oversized.size(); ++j) {
+			testPair(first, m_proxies[m_oversized[j]]);
+		}
+		for (const Proxy& second : m_proxies) {
+			if (second.minCell.x <= second.maxCell.x) {
+				testPair(first, second);
+			}
+		}
+	}
+	// Resolve in the order objects were added, so results don't depend on their positions
+	std::sort(m_pairs.begin(), m_pairs.end());
+}
+
+void physics::SpatialHashGrid::calculateCellSize()
+{
+	m_diagonals.clear();
+	for (const Proxy& proxy : m_proxies) {
+		if (proxy.body != nullptr) {
+			m_diagonals.push_back(proxy.body->getDiagonalLength());
+		}
+	}
+	if (m_diagonals.empty()) {
+		m_cellSize = k_def_cell_size;
+	}
+	else {
+		// Median isn't skewed by a few very large objects
+		auto median = m_diagonals.begin() + m_diagonals.size() / 2;
+		std::nth_element(m_diagonals.begin(), median, m_diagonals.end());
+		m_cellSize = (*median > 0) ? *median * k_cell_size_factor : k_def_cell_size;
+	}
+}
+
+void physics::SpatialHashGrid::buildGrid()
+{
+	// Find cells touched by each proxy
+	size_t entryCount = 0;
+	float invCellSize = 1.f / m_cellSize;
+	m_oversized.clear();
+	for (size_t i = 0; i < m_proxies.size(); ++i) {
+		Proxy& proxy = m_proxies[i];
+		bool oversized = !proxy.bounds.isBounded();
+		if (!oversized) {
+			glm::vec2 minCell = glm::floor(proxy.bounds.min * invCellSize);
+			glm::vec2 maxCell = glm::floor(proxy.bounds.max * invCellSize);
+			glm::vec2 cellCount = maxCell - minCell + glm::vec2(1);
+			oversized = cellCount.x * cellCount.y > k_max_cells
+				|| glm::any(glm::greaterThan(glm::abs(minCell), glm::vec2(k_max_cell_coord)))
+				|| glm::any(glm::greaterThan(glm::abs(maxCell), glm::vec2(k_max_cell_coord)));
+			if (!oversized) {
+				proxy.minCell = glm::ivec2(minCell);
+				proxy.maxCell = glm::ivec2(maxCell);
+				entryCount += (size_t)(cellCount.x * cellCount.y);
+			}
+		}
+		if (oversized) {
+			// Empty cell range marks proxy as not in grid
+			proxy.minCell = glm::ivec2(1);
+			proxy.maxCell = glm::ivec2(0);
+			m_oversized.push_back(i);
+		}
+	}
+
+	// Table has at least twice as many buckets as entries to keep buckets small
+	size_t bucketCount = 16;
+	while (bucketCount < 2 * entryCount) {
+		bucketCount *= 2;
+	}
+
+	// Count entries per bucket, offset by one so prefix sum gives start of each bucket
+	m_bucketStart.assign(bucketCount + 1, 0);
+	for (const Proxy& proxy : m_proxies) {
+		for (int x = proxy.minCell.x; x <= proxy.maxCell.x; ++x) {
+			for (int y = proxy.minCell.y; y <= proxy.maxCell.y; ++y) {
+				++m_bucketStart[hashCell({ x,y }, bucketCount) + 1];
+			}
+		}
+	}
+	for (size_t i = 1; i <= bucketCount; ++i) {
+		m_bucketStart[i] += m_bucketStart[i - 1];
+	}
+
+	// Scatter entries into their buckets, using start of next bucket as a write cursor
+	m_entries.resize(entryCount);
+	for (size_t i = 0; i < m_proxies.size(); ++i) {
+		const Proxy& proxy = m_proxies[i];
+		for (int x = proxy.minCell.x; x <= proxy.maxCell.x; ++x) {
+			for (int y = proxy.minCell.y; y <= proxy.maxCell.y; ++y) {
+				glm::ivec2 cell(x, y);
+				size_t bucket = hashCell(cell, bucketCount);
+				m_entries[m_bucketStart[bucket]++] = { cell, i };
+			}
+		}
+	}
+	// Cursors now point at end of each bucket, so shift back to get starts
+	for (size_t i = bucketCount; i > 0; --i) {
+		m_bucketStart[i] = m_bucketStart[i - 1];
+	}
+	m_bucketStart[0] = 0;
+}
+
+size_t physics::SpatialHashGrid::hashCell(glm::ivec2 cell, size_t bucketCount)
+{
+	// Bucket count is a power of two, so mask selects bucket
+	unsigned int hash = ((unsigned int)cell.x * 73856093u) ^ ((unsigned int)cell.y * 19349663u);
+	return hash & (bucketCount - 1);
+}
+
+glm::ivec2 physics::SpatialHashGrid::cellAt(glm::vec2 point)
+{
+	// Must match rounding used when building grid
+	return glm::ivec2(glm::floor(point * (1.f / m_cellSize)));
+}
+
+void physics::SpatialHashGrid::testPair(const Proxy & first, const Proxy & second)
+{
+	if ((first.isStatic && second.isStatic) || !first.bounds.overlaps(second.bounds)) {
+		return;
+	}
+	if (first.id < second.id) {
+		m_pairs.push_back(BroadphasePair(first.object, second.object, first.id, second.id, first.shape, second.shape));
+	}
+	else {
+		m_pairs.push_back(BroadphasePair(second.object, first.object, second.id, first.id, second.shape, first.shape));
+	}
+}
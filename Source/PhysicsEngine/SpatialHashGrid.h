@@ -0,0 +1,100 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "AABB.h"
+#include "IBroadphase.h"
+
+namespace physics {
+	class PhysicsObject;
+	class RigidBody;
+
+	// Uniform grid broadphase, with cells stored in a hash table
+	// Each object is entered into every cell its bounds touch, and only objects sharing a cell are
+	// tested against each other. Works best when most objects are of a similar size.
+	// The table is rebuilt each step by counting sort into flat arrays, which are kept between steps
+	// so no memory is allocated once the grid has warmed up.
+	class SpatialHashGrid : public IBroadphase {
+	public:
+		static const float k_def_cell_size;		// Cell size used when there are no rigidbodies to measure
+		static const float k_cell_size_factor;	// Multiple of median diagonal used as automatic cell size
+		static const size_t k_max_cells;		// Objects touching more cells than this are tested against everything
+
+		// cellSize = width of grid cells, or 0 to size cells automatically from the objects in the grid
+		SpatialHashGrid(float cellSize = 0.f);
+
+		virtual BroadphaseType getType() { return spatial_hash; }
+
+		// Starts tracking object's bounds
+		// Objects with empty bounds (such as joints) can't collide and are ignored
+		virtual void add(PhysicsObject* object);
+
+		// Stops tracking object
+		virtual void remove(PhysicsObject* object);
+
+		// Stops tracking all objects which have been killed
+		virtual void removeDead();
+
+		// Stops tracking all objects
+		virtual void clear();
+
+		// Returns pairs found by last update, in the order the objects were added
+		virtual const std::vector<BroadphasePair>& getPairs() { return m_pairs; }
+
+		virtual size_t getProxyCount() { return m_proxies.size(); }
+
+		virtual void queryAABB(const AABB& bounds, std::vector<PhysicsObject*>& results);
+		virtual void queryPoint(glm::vec2 point, std::vector<PhysicsObject*>& results);
+
+		// Returns width of cells used by last update
+		float getCellSize() { return m_cellSize; }
+
+		bool isAutoCellSize() { return m_autoCellSize; }
+
+		// Sets fixed width of cells, or 0 to size cells automatically
+		void setCellSize(float cellSize);
+
+	protected:
+		struct Proxy {
+			PhysicsObject* object;
+			RigidBody* body;	// Same object if it is a rigidbody, used to size cells
+			size_t id;			// Order in which object was added
+			AABB bounds;
+			bool isStatic;
+			ShapeType shape;
+			glm::ivec2 minCell;
+			glm::ivec2 maxCell;
+		};
+
+		struct CellEntry {
+			glm::ivec2 cell;
+			size_t proxy;
+		};
+
+		std::vector<Proxy> m_proxies;
+		std::vector<BroadphasePair> m_pairs;
+		std::vector<CellEntry> m_entries;		// Entries for every cell touched, grouped by bucket
+		std::vector<size_t> m_bucketStart;		// Index of first entry in each bucket
+		std::vector<size_t> m_oversized;		// Proxies too large (or unbounded) to enter into grid
+		std::vector<float> m_diagonals;			// Scratch space for finding median size
+		size_t m_nextID;
+		float m_cellSize;
+		bool m_autoCellSize;
+
+		// Updates bounds of all objects, rebuilds grid and finds overlapping pairs
+		virtual void findPairs();
+
+		// Sets cell size from median diagonal length of rigidbodies
+		void calculateCellSize();
+
+		// Sorts proxies' cells into buckets
+		void buildGrid();
+
+		// Returns bucket that cell is hashed into
+		size_t hashCell(glm::ivec2 cell, size_t bucketCount);
+
+		// Returns cell containing point
+		glm::ivec2 cellAt(glm::vec2 point);
+
+		// Adds pair if objects can collide and their bounds overlap
+		void testPair(const Proxy& first, const Proxy& second);
+	};
+}
@@ -1,13 +1,17 @@
 #include "Sphere.h"
+#include "ObjectPool.h"
 #include "ExternalLibraries.h"
 #include "Plane.h"
 #include "Box.h"
 
+#include <cmath>
+#include <stdexcept>
+
 physics::Sphere::Sphere(glm::vec2 position, float radius, glm::vec2 velocity, float angularVelocity, float mass, float elasticity, float friction, float drag, float angularDrag, glm::vec4 colour, bool showLine)
 	: RigidBody(position,velocity, 0,mass,elasticity,angularVelocity,friction, drag, angularDrag,colour), m_radius(radius), m_showLine(showLine)
 {
 
-	if (radius <= 0 || isnan(radius) || isinf(radius)) {
+	if (radius <= 0 || std::isnan(radius) || std::isinf(radius)) {
 		throw std::invalid_argument("Radius must be positive and finite");
 	}
 	calculateMoment();
@@ -23,23 +27,35 @@ physics::PhysicsObject * physics::Sphere::clone()
 	return new Sphere(*this);
 }
 
-void physics::Sphere::makeGizmo(float timeRatio)
+physics::PhysicsObjectPtr physics::Sphere::poolClone(ObjectPools & pools)
 {
-	glm::vec2 interpolated = glm::mix(m_pastPosition, m_position, timeRatio);
-	aie::Gizmos::add2DCircle(interpolated, m_radius, k_segments, m_colour);
-	// draw a line to show orientation
-	if (m_showLine) {
-		glm::vec2 interpolatedLine = glm::mix(m_pastY * m_radius, m_localY * m_radius, timeRatio);
-		aie::Gizmos::add2DLine(interpolated, interpolatedLine + interpolated, { 0,0,0,1 });
-	}
+	return pools.spheres.create(*this);
+}
+
+bool physics::Sphere::extractDrawRecord(float timeRatio, DrawRecord& record)
+{
+	record.shape = draw_circle;
+	record.position = glm::mix(getPastPosition(), getPosition(), timeRatio);
+	record.radius = m_radius;
+	record.colour = m_colour;
+	// line to show orientation
+	record.showLine = m_showLine;
+	record.axisX = glm::mix(getPastY() * m_radius, getLocalY() * m_radius, timeRatio);
+	return true;
 }
 
 bool physics::Sphere::isPointInside(glm::vec2 point)
 {
-	glm::vec2 displacement = point - m_position;
+	glm::vec2 displacement = point - getPosition();
 	return glm::dot(displacement, displacement) < m_radius * m_radius;
 }
 
+physics::AABB physics::Sphere::getAABB()
+{
+	glm::vec2 extent(m_radius);
+	return AABB(getPosition() - extent, getPosition() + extent);
+}
+
 physics::Collision physics::Sphere::checkCollision(PhysicsObject * other)
 {
 	return other->checkSphereCollision(this);
@@ -48,27 +64,36 @@ physics::Collision physics::Sphere::checkCollision(PhysicsObject * other)
 physics::Collision physics::Sphere::checkSphereCollision(Sphere * other)
 {
 	Collision collision(false, this, other);
-	glm::vec2 displacement = m_position - other->m_position;
-	float distance = glm::length(displacement);
-	if (distance < m_radius + other->m_radius) {
+	glm::vec2 displacement = getPosition() - other->getPosition();
+	float radii = m_radius + other->m_radius;
+	// Reject before taking square root
+	if (glm::dot(displacement, displacement) < radii * radii) {
+		float distance = glm::length(displacement);
 		collision.success = true;
 		if (distance != 0) {
 			collision.normal = glm::normalize(displacement);
-			collision.depth = m_radius + other->m_radius - distance;
+			collision.depth = radii - distance;
 
 			// point of contact is at half depth from edge
-			collision.contact = (0.5f * collision.depth - m_radius) * collision.normal + m_position;
+			collision.contact = (0.5f * collision.depth - m_radius) * collision.normal + getPosition();
 		}
 		else {
 			collision.normal = { 1,0 };
-			collision.depth = m_radius + other->m_radius;
-			collision.contact = m_position;
+			collision.depth = radii;
+			collision.contact = getPosition();
 		}
 
 	}
 	return collision;
 }
 
+bool physics::Sphere::overlapsSphere(Sphere * other)
+{
+	glm::vec2 displacement = getPosition() - other->getPosition();
+	float radii = m_radius + other->m_radius;
+	return glm::dot(displacement, displacement) < radii * radii;
+}
+
 physics::Collision physics::Sphere::checkBoxCollision(Box * other)
 {
 	return other->checkSphereCollision(this);
@@ -87,7 +112,7 @@ physics::ShapeType physics::Sphere::getShapeID()
 
 void physics::Sphere::setRadius(float radius)
 {
-	if (radius <= 0 || isnan(radius) || isinf(radius)) {
+	if (radius <= 0 || std::isnan(radius) || std::isinf(radius)) {
 		throw std::invalid_argument("Radius must be positive and finite");
 	}
 	m_radius = radius;
@@ -113,11 +138,5 @@ float physics::Sphere::getDiagonalLength()
 
 void physics::Sphere::calculateMoment()
 {
-	m_moment = 0.5f * m_mass * m_radius * m_radius;
-	if (m_moment == INFINITY) {
-		m_invMoment = 0;
-	}
-	else {
-		m_invMoment = 1.f / m_moment;
-	}
+	setMoment(0.5f * m_mass * m_radius * m_radius);
 }
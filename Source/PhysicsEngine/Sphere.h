@@ -19,16 +19,22 @@ namespace physics {
 		Sphere(const Sphere& other);
 
 		virtual PhysicsObject* clone();
+		virtual PhysicsObjectPtr poolClone(ObjectPools& pools);
 
-		virtual void makeGizmo(float timeRatio);
+		virtual bool extractDrawRecord(float timeRatio, DrawRecord& record);
 		
 		virtual bool isPointInside(glm::vec2 point);
 
+		virtual AABB getAABB();
+
 		virtual Collision checkCollision(PhysicsObject* other);
 		virtual Collision checkSphereCollision(Sphere* other);
 		virtual Collision checkBoxCollision(Box* other);
 		virtual Collision checkPlaneCollision(Plane* other);
 
+		// Returns whether spheres overlap, without finding contact details
+		bool overlapsSphere(Sphere* other);
+
 
 		virtual ShapeType getShapeID();
 
@@ -1,20 +1,24 @@
 #include "Spring.h"
+#include "ObjectPool.h"
 
 #include "ExternalLibraries.h"
 
-#include "Rigidbody.h"
+#include "RigidBody.h"
+
+#include <cmath>
+#include <stdexcept>
 
 physics::Spring::Spring(float tightness, float length, float damping, 
 	RigidBodyPtr end1, RigidBodyPtr end2, glm::vec2 anchor1, glm::vec2 anchor2, glm::vec4 colour)
 	: Joint(end1,end2,anchor1,anchor2,colour), m_tightness(tightness), m_length(length), m_damping(damping)
 {
-	if (m_tightness < 0 || isnan(m_tightness) || isinf(m_tightness)) {
+	if (m_tightness < 0 || std::isnan(m_tightness) || std::isinf(m_tightness)) {
 		throw std::invalid_argument("Tightness must be non-negative and finite");
 	}
-	if (m_length < 0 || isnan(m_length) || isinf(m_length)) {
+	if (m_length < 0 || std::isnan(m_length) || std::isinf(m_length)) {
 		throw std::invalid_argument("Length must be non-negative and finite");
 	}
-	if (m_damping < 0 || isnan(m_damping) || isinf(m_damping)) {
+	if (m_damping < 0 || std::isnan(m_damping) || std::isinf(m_damping)) {
 		throw std::invalid_argument("Damping must be non-negative and finite");
 	}
 }
@@ -29,9 +33,14 @@ physics::PhysicsObject * physics::Spring::clone()
 	return new Spring(*this);
 }
 
+physics::PhysicsObjectPtr physics::Spring::poolClone(ObjectPools & pools)
+{
+	return pools.springs.create(*this);
+}
+
 void physics::Spring::setTightness(float tightness)
 {
-	if (tightness < 0 || isnan(tightness) || isinf(tightness)) {
+	if (tightness < 0 || std::isnan(tightness) || std::isinf(tightness)) {
 		throw std::invalid_argument("Tightness must be non-negative and finite");
 	}
 	m_tightness = tightness;
@@ -39,7 +48,7 @@ void physics::Spring::setTightness(float tightness)
 
 void physics::Spring::setLength(float length)
 {
-	if (length < 0 || isnan(length) || isinf(length)) {
+	if (length < 0 || std::isnan(length) || std::isinf(length)) {
 		throw std::invalid_argument("Length must be non-negative and finite");
 	}
 	m_length = length;
@@ -47,7 +56,7 @@ void physics::Spring::setLength(float length)
 
 void physics::Spring::setDamping(float damping)
 {
-	if (damping < 0 || isnan(damping) || isinf(damping)) {
+	if (damping < 0 || std::isnan(damping) || std::isinf(damping)) {
 		throw std::invalid_argument("Damping must be non-negative and finite");
 	}
 	m_damping = damping;
@@ -56,6 +65,10 @@ void physics::Spring::setDamping(float damping)
 void physics::Spring::earlyUpdate(PhysicsScene* scene)
 {
 	if (m_end1 && m_end2 && m_end1->isAlive() && m_end2->isAlive()) {
+		if (!m_end1->isAwake() && !m_end2->isAwake()) {
+			// Neither end can move, so no need to calculate force
+			return;
+		}
 		// get distance between ends, calculate difference to length, multiply by tightness
 		glm::vec2 pos1 = m_end1->localToWorldSpace(m_anchor1);
 		glm::vec2 pos2 = m_end2->localToWorldSpace(m_anchor2);
@@ -86,17 +99,18 @@ void physics::Spring::earlyUpdate(PhysicsScene* scene)
 	}
 }
 
-void physics::Spring::makeGizmo(float timeRatio)
+bool physics::Spring::extractDrawRecord(float timeRatio, DrawRecord& record)
 {
-	if (m_end1 && m_end2) {
-		glm::vec2 pos1 = glm::mix(m_end1->pastLocalToWorldSpace(m_anchor1),
-									m_end1->localToWorldSpace(m_anchor1), timeRatio);
-
-		glm::vec2 pos2 = glm::mix(m_end2->pastLocalToWorldSpace(m_anchor2),
-									m_end2->localToWorldSpace(m_anchor2), timeRatio);
-
-		aie::Gizmos::add2DLine(pos1, pos2, m_colour);
+	if (!m_end1 || !m_end2) {
+		return false;
 	}
+	record.shape = draw_line;
+	record.position = glm::mix(m_end1->pastLocalToWorldSpace(m_anchor1),
+								m_end1->localToWorldSpace(m_anchor1), timeRatio);
+	record.axisX = glm::mix(m_end2->pastLocalToWorldSpace(m_anchor2),
+								m_end2->localToWorldSpace(m_anchor2), timeRatio);
+	record.colour = m_colour;
+	return true;
 }
 
 float physics::Spring::calculateEnergy(PhysicsScene* scene)
@@ -17,6 +17,7 @@ namespace physics {
 		Spring(const Spring& other);
 
 		virtual PhysicsObject* clone();
+		virtual PhysicsObjectPtr poolClone(ObjectPools& pools);
 
 		float getTightness() {return m_tightness;};
 		void setTightness(float tightness);
@@ -29,7 +30,7 @@ namespace physics {
 
 		virtual void earlyUpdate(PhysicsScene* scene);
 
-		virtual void makeGizmo(float timeRatio);
+		virtual bool extractDrawRecord(float timeRatio, DrawRecord& record);
 
 		virtual ShapeType getShapeID() { return ShapeType::spring; };
 
@@ -0,0 +1,105 @@
+#include "SweepAndPrune.h"
+#include "PhysicsObject.h"
+
+physics::SweepAndPrune::SweepAndPrune() : m_nextID(0), m_needsFullSort(false)
+{
+}
+
+void physics::SweepAndPrune::add(PhysicsObject * object)
+{
+	AABB bounds = object->getAABB();
+	if (!bounds.isEmpty()) {
+		m_proxies.push_back({ object, m_nextID, bounds, object->isStatic(), object->getShapeID() });
+		m_needsFullSort = true;
+	}
+	++m_nextID;
+}
+
+void physics::SweepAndPrune::remove(PhysicsObject * object)
+{
+	// Erasing keeps remaining proxies sorted
+	m_proxies.erase(std::remove_if(m_proxies.begin(), m_proxies.end(), [object](const Proxy& p) {return p.object == object; }), m_proxies.end());
+}
+
+void physics::SweepAndPrune::removeDead()
+{
+	m_proxies.erase(std::remove_if(m_proxies.begin(), m_proxies.end(), [](const Proxy& p) {return !p.object->isAlive(); }), m_proxies.end());
+}
+
+void physics::SweepAndPrune::clear()
+{
+	m_proxies.clear();
+	m_pairs.clear();
+	m_needsFullSort = false;
+}
+
+void physics::SweepAndPrune::queryAABB(const AABB & bounds, std::vector<PhysicsObject*>& results)
+{
+	for (const Proxy& proxy : m_proxies) {
+		if (proxy.bounds.overlaps(bounds)) {
+			results.push_back(proxy.object);
+		}
+	}
+}
+
+void physics::SweepAndPrune::queryPoint(glm::vec2 point, std::vector<PhysicsObject*>& results)
+{
+	for (const Proxy& proxy : m_proxies) {
+		if (proxy.bounds.contains(point) && proxy.object->isPointInside(point)) {
+			results.push_back(proxy.object);
+		}
+	}
+}
+
+void physics::SweepAndPrune::findPairs()
+{
+	for (Proxy& proxy : m_proxies) {
+		proxy.bounds = proxy.object->getAABB();
+		proxy.isStatic = proxy.object->isStatic();
+	}
+	sortProxies();
+
+	m_pairs.clear();
+	size_t count = m_proxies.size();
+	for (size_t i = 0; i < count; ++i) {
+		const Proxy& first = m_proxies[i];
+		// Sweep forward until a proxy starts after this one ends
+		for (size_t j = i + 1; j < count && m_proxies[j].bounds.min.x <= first.bounds.max.x; ++j) {
+			const Proxy& second = m_proxies[j];
+			if ((first.isStatic && second.isStatic)
+				|| first.bounds.min.y > second.bounds.max.y || second.bounds.min.y > first.bounds.max.y) {
+				continue;
+			}
+			if (first.id < second.id) {
+				m_pairs.push_back(BroadphasePair(first.object, second.object, first.id, second.id, first.shape, second.shape));
+			}
+			else {
+				m_pairs.push_back(BroadphasePair(second.object, first.object, second.id, first.id, second.shape, first.shape));
+			}
+		}
+	}
+	// Resolve in the order objects were added, so results don't depend on their positions
+	std::sort(m_pairs.begin(), m_pairs.end());
+}
+
+void physics::SweepAndPrune::sortProxies()
+{
+	if (m_needsFullSort) {
+		std::sort(m_proxies.begin(), m_proxies.end(), [](const Proxy& a, const Proxy& b) {return a.bounds.min.x < b.bounds.min.x; });
+		m_needsFullSort = false;
+	}
+	else {
+		// Order changes little between steps, so insertion sort is close to linear
+		for (size_t i = 1; i < m_proxies.size(); ++i) {
+			if (m_proxies[i - 1].bounds.min.x > m_proxies[i].bounds.min.x) {
+				Proxy moving = m_proxies[i];
+				size_t j = i;
+				do {
+					m_proxies[j] = m_proxies[j - 1];
+					--j;
+				} while (j > 0 && m_proxies[j - 1].bounds.min.x > moving.bounds.min.x);
+				m_proxies[j] = moving;
+			}
+		}
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "AABB.h"
+#include "IBroadphase.h"
+
+namespace physics {
+	class PhysicsObject;
+
+	// Sort and sweep broadphase
+	// Objects are kept sorted by the lower bound of their AABB along the x axis between steps.
+	// Since objects move little each step, the order is restored by an insertion sort in close
+	// to linear time, and a sweep along the sorted list finds every pair with overlapping bounds.
+	class SweepAndPrune : public IBroadphase {
+	public:
+		SweepAndPrune();
+
+		virtual BroadphaseType getType() { return sweep_and_prune; }
+
+		// Starts tracking object's bounds
+		// Objects with empty bounds (such as joints) can't collide and are ignored
+		virtual void add(PhysicsObject* object);
+
+		// Stops tracking object
+		virtual void remove(PhysicsObject* object);
+
+		// Stops tracking all objects which have been killed
+		virtual void removeDead();
+
+		// Stops tracking all objects
+		virtual void clear();
+
+		// Returns pairs found by last update, in the order the objects were added
+		virtual const std::vector<BroadphasePair>& getPairs() { return m_pairs; }
+
+		virtual size_t getProxyCount() { return m_proxies.size(); }
+
+		virtual void queryAABB(const AABB& bounds, std::vector<PhysicsObject*>& results);
+		virtual void queryPoint(glm::vec2 point, std::vector<PhysicsObject*>& results);
+
+	protected:
+		struct Proxy {
+			PhysicsObject* object;
+			size_t id;		// Order in which object was added
+			AABB bounds;
+			bool isStatic;
+			ShapeType shape;
+		};
+
+		std::vector<Proxy> m_proxies;	// Sorted by bounds.min.x as of last update
+		std::vector<BroadphasePair> m_pairs;
+		size_t m_nextID;
+		bool m_needsFullSort;	// Set when objects are added, since insertion sort is slow on unsorted data
+
+		// Updates bounds of all objects and finds overlapping pairs
+		virtual void findPairs();
+
+		void sortProxies();
+	};
+}
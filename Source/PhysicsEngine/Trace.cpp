@@ -0,0 +1,127 @@
+#include "Trace.h"
+
+#include <fstream>
+#include <stdexcept>
+
+// Writes string as JSON string literal
+static void writeJsonString(std::ostream& stream, const char* text)
+{
+	stream << '"';
+	for (const char* c = text; *c != '\0'; ++c) {
+		if (*c == '"' || *c == '\\') {
+			stream << '\\';
+		}
+		stream << *c;
+	}
+	stream << '"';
+}
+
+physics::Tracer::Tracer(size_t capacity) : m_next(0), m_count(0), m_enabled(false), m_epoch(Clock::now())
+{
+	if (capacity == 0) {
+		throw std::invalid_argument("Tracer must hold at least one event");
+	}
+	m_events.resize(capacity);
+}
+
+physics::Tracer & physics::Tracer::getInstance()
+{
+	static Tracer instance;
+	return instance;
+}
+
+void physics::Tracer::record(const char * name, const char * category, Clock::time_point start, Clock::time_point end)
+{
+	if (!m_enabled) {
+		return;
+	}
+	TraceEvent event;
+	event.name = name;
+	event.category = category;
+	event.start = std::chrono::duration<double, std::micro>(start - m_epoch).count();
+	event.duration = std::chrono::duration<double, std::micro>(end - start).count();
+	event.thread = getThreadNumber();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_events[m_next] = event;
+	m_next = (m_next + 1) % m_events.size();
+	m_count = std::min(m_count + 1, m_events.size());
+}
+
+std::vector<physics::TraceEvent> physics::Tracer::getEvents()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::vector<TraceEvent> events;
+	events.reserve(m_count);
+	size_t first = (m_next + m_events.size() - m_count) % m_events.size();
+	for (size_t i = 0; i < m_count; ++i) {
+		events.push_back(m_events[(first + i) % m_events.size()]);
+	}
+	return events;
+}
+
+size_t physics::Tracer::size()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_count;
+}
+
+void physics::Tracer::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_next = 0;
+	m_count = 0;
+}
+
+void physics::Tracer::writeJson(std::ostream & stream)
+{
+	// Copy out first, so recording threads aren't held up by writing
+	std::vector<TraceEvent> events = getEvents();
+	std::ios::fmtflags flags = stream.flags(std::ios::fixed);
+	std::streamsize precision = stream.precision(3);
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (size_t i = 0; i < events.size(); ++i) {
+		const TraceEvent& event = events[i];
+		stream << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+		writeJsonString(stream, event.name);
+		stream << ",\"cat\":";
+		writeJsonString(stream, event.category);
+		stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+			<< ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "}";
+	}
+	stream << "\n]}\n";
+	stream.flags(flags);
+	stream.precision(precision);
+}
+
+bool physics::Tracer::dumpJson(const std::string & path)
+{
+	std::ofstream file(path);
+	if (!file) {
+		return false;
+	}
+	writeJson(file);
+	return (bool)file;
+}
+
+unsigned int physics::Tracer::getThreadNumber()
+{
+	static std::atomic<unsigned int> threadCount(0);
+	thread_local unsigned int number = ++threadCount;
+	return number;
+}
+
+physics::TraceScope::TraceScope(const char * name, const char * category, Tracer & tracer)
+	: m_tracer(tracer.isEnabled() ? &tracer : nullptr), m_name(name), m_category(category)
+{
+	if (m_tracer != nullptr) {
+		m_start = Tracer::Clock::now();
+	}
+}
+
+physics::TraceScope::~TraceScope()
+{
+	if (m_tracer != nullptr) {
+		m_tracer->record(m_name, m_category, m_start, Tracer::Clock::now());
+	}
+}
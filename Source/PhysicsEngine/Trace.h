@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Scoped trace events are recorded unless built with PHYSICS_NO_TRACE, which expands the macros to nothing
+// Kept free of other engine headers so applications can trace their own frames without the rest of the engine
+#ifndef PHYSICS_NO_TRACE
+#define PHYSICS_TRACE
+#endif
+
+#define PHYSICS_TRACE_CONCAT_INNER(a, b) a##b
+#define PHYSICS_TRACE_CONCAT(a, b) PHYSICS_TRACE_CONCAT_INNER(a, b)
+
+#ifdef PHYSICS_TRACE
+// Records event named name, lasting until end of enclosing scope. Name and category must be string literals
+#define PHYSICS_TRACE_SCOPE(name, category) physics::TraceScope PHYSICS_TRACE_CONCAT(traceScope, __LINE__)(name, category)
+#else
+#define PHYSICS_TRACE_SCOPE(name, category) ((void)0)
+#endif
+
+namespace physics {
+
+	// Span of time spent in a named scope on one thread
+	struct TraceEvent {
+		const char* name;
+		const char* category;
+		double start;			// Microseconds since tracer was created
+		double duration;		// Microseconds
+		unsigned int thread;	// Small number for thread, in order threads first recorded events
+	};
+
+	// Keeps the most recent trace events in a ring buffer, to write out as a Chrome trace on demand
+	// Files open in chrome://tracing or Perfetto as a timeline of nested scopes on each thread. The buffer is
+	// allocated up front, so recording never allocates, and oldest events are overwritten once it is full.
+	// Recording is thread safe. Tracers start disabled, as every scope costs a lock once they're enabled.
+	class Tracer {
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		static const size_t k_def_capacity = 64 * 1024;
+
+		Tracer(size_t capacity = k_def_capacity);
+
+		Tracer(const Tracer& other) = delete;
+		Tracer& operator=(const Tracer& other) = delete;
+
+		// Tracer used by trace scopes
+		static Tracer& getInstance();
+
+		// Disabled tracers ignore new events, but keep those already recorded
+		bool isEnabled() { return m_enabled; }
+		void setEnabled(bool value) { m_enabled = value; }
+
+		// Adds event on calling thread. Name and category must outlive tracer, so should be string literals
+		void record(const char* name, const char* category, Clock::time_point start, Clock::time_point end);
+
+		// Events in buffer, oldest first
+		std::vector<TraceEvent> getEvents();
+
+		size_t size();
+		size_t capacity() { return m_events.size(); }
+
+		void clear();
+
+		// Writes events in Chrome trace event format
+		void writeJson(std::ostream& stream);
+
+		// Writes events to file at path, returning false if it couldn't be written
+		bool dumpJson(const std::string& path);
+
+		// Number for calling thread, as shown in traces
+		static unsigned int getThreadNumber();
+
+	protected:
+		std::mutex m_mutex;
+		std::vector<TraceEvent> m_events;	// Ring buffer, oldest event at m_next once full
+		size_t m_next;
+		size_t m_count;
+		std::atomic<bool> m_enabled;
+		Clock::time_point m_epoch;
+	};
+
+	// Records trace event covering its lifetime
+	class TraceScope {
+	public:
+		TraceScope(const char* name, const char* category, Tracer& tracer = Tracer::getInstance());
+		~TraceScope();
+
+		TraceScope(const TraceScope& other) = delete;
+		TraceScope& operator=(const TraceScope& other) = delete;
+
+	protected:
+		Tracer* m_tracer;		// nullptr if tracer was disabled when scope began
+		const char* m_name;
+		const char* m_category;
+		Tracer::Clock::time_point m_start;
+	};
+}
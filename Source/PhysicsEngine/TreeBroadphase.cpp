@@ -0,0 +1,184 @@
+#include "TreeBroadphase.h"
+#include "PhysicsObject.h"
+
+physics::TreeBroadphase::TreeBroadphase(float margin) : m_staticTree(margin), m_dynamicTree(margin), m_nextID(0)
+{
+}
+
+void physics::TreeBroadphase::add(PhysicsObject * object)
+{
+	AABB bounds = object->getAABB();
+	if (!bounds.isEmpty()) {
+		m_proxies.push_back({ object, m_nextID, bounds, object->isStatic(), AABBTree::k_null_node, object->getShapeID() });
+		insertProxy(m_proxies.size() - 1);
+	}
+	++m_nextID;
+}
+
+void physics::TreeBroadphase::remove(PhysicsObject * object)
+{
+	for (size_t i = 0; i < m_proxies.size(); ++i) {
+		if (m_proxies[i].object == object) {
+			eraseProxy(i);
+			return;
+		}
+	}
+}
+
+void physics::TreeBroadphase::removeDead()
+{
+	size_t i = 0;
+	while (i < m_proxies.size()) {
+		if (!m_proxies[i].object->isAlive()) {
+			// Last proxy is swapped into this slot, so check it again
+			eraseProxy(i);
+		}
+		else {
+			++i;
+		}
+	}
+}
+
+void physics::TreeBroadphase::clear()
+{
+	m_proxies.clear();
+	m_pairs.clear();
+	m_staticTree.clear();
+	m_dynamicTree.clear();
+}
+
+void physics::TreeBroadphase::findPairs()
+{
+	// Refit trees
+	for (size_t i = 0; i < m_proxies.size(); ++i) {
+		Proxy& proxy = m_proxies[i];
+		AABB bounds = proxy.object->getAABB();
+		bool isStatic = proxy.object->isStatic();
+		bool isBounded = bounds.isBounded() && !bounds.isEmpty();
+		if (isStatic != proxy.isStatic || isBounded != (proxy.node != AABBTree::k_null_node)) {
+			// Object has to change tree
+			removeProxy(i);
+			proxy.bounds = bounds;
+			proxy.isStatic = isStatic;
+			insertProxy(i);
+		}
+		else {
+			proxy.bounds = bounds;
+			if (isBounded) {
+				treeFor(proxy).move(proxy.node, bounds);
+			}
+		}
+	}
+
+	m_pairs.clear();
+	for (const Proxy& proxy : m_proxies) {
+		if (proxy.node == AABBTree::k_null_node) {
+			// Unbounded objects are tested against everything added after them, or anything bounded
+			for (const Proxy& other : m_proxies) {
+				if (other.node != AABBTree::k_null_node || proxy.id < other.id) {
+					testPair(proxy, other);
+				}
+			}
+		}
+		else if (!proxy.isStatic) {
+			m_found.clear();
+			m_dynamicTree.query(proxy.bounds, m_found);
+			for (size_t index : m_found) {
+				// Dynamic pairs are found from both sides, so keep only one
+				if (proxy.id < m_proxies[index].id) {
+					testPair(proxy, m_proxies[index]);
+				}
+			}
+			m_found.clear();
+			m_staticTree.query(proxy.bounds, m_found);
+			for (size_t index : m_found) {
+				testPair(proxy, m_proxies[index]);
+			}
+		}
+	}
+	// Resolve in the order objects were added, so results don't depend on their positions
+	std::sort(m_pairs.begin(), m_pairs.end());
+}
+
+void physics::TreeBroadphase::queryAABB(const AABB & bounds, std::vector<PhysicsObject*>& results)
+{
+	m_found.clear();
+	m_staticTree.query(bounds, m_found);
+	m_dynamicTree.query(bounds, m_found);
+	for (size_t index : m_found) {
+		if (m_proxies[index].bounds.overlaps(bounds)) {
+			results.push_back(m_proxies[index].object);
+		}
+	}
+	for (const Proxy& proxy : m_proxies) {
+		if (proxy.node == AABBTree::k_null_node && proxy.bounds.overlaps(bounds)) {
+			results.push_back(proxy.object);
+		}
+	}
+}
+
+void physics::TreeBroadphase::queryPoint(glm::vec2 point, std::vector<PhysicsObject*>& results)
+{
+	m_found.clear();
+	AABB bounds(point, point);
+	m_staticTree.query(bounds, m_found);
+	m_dynamicTree.query(bounds, m_found);
+	for (size_t index : m_found) {
+		PhysicsObject* object = m_proxies[index].object;
+		if (m_proxies[index].bounds.contains(point) && object->isPointInside(point)) {
+			results.push_back(object);
+		}
+	}
+	for (const Proxy& proxy : m_proxies) {
+		if (proxy.node == AABBTree::k_null_node && proxy.object->isPointInside(point)) {
+			results.push_back(proxy.object);
+		}
+	}
+}
+
+void physics::TreeBroadphase::insertProxy(size_t index)
+{
+	Proxy& proxy = m_proxies[index];
+	if (proxy.bounds.isBounded() && !proxy.bounds.isEmpty()) {
+		proxy.node = treeFor(proxy).insert(proxy.bounds, index);
+	}
+	else {
+		proxy.node = AABBTree::k_null_node;
+	}
+}
+
+void physics::TreeBroadphase::removeProxy(size_t index)
+{
+	Proxy& proxy = m_proxies[index];
+	if (proxy.node != AABBTree::k_null_node) {
+		treeFor(proxy).remove(proxy.node);
+		proxy.node = AABBTree::k_null_node;
+	}
+}
+
+void physics::TreeBroadphase::eraseProxy(size_t index)
+{
+	removeProxy(index);
+	size_t last = m_proxies.size() - 1;
+	if (index != last) {
+		m_proxies[index] = m_proxies[last];
+		Proxy& moved = m_proxies[index];
+		if (moved.node != AABBTree::k_null_node) {
+			treeFor(moved).setUserData(moved.node, index);
+		}
+	}
+	m_proxies.pop_back();
+}
+
+void physics::TreeBroadphase::testPair(const Proxy & first, const Proxy & second)
+{
+	if ((first.isStatic && second.isStatic) || !first.bounds.overlaps(second.bounds)) {
+		return;
+	}
+	if (first.id < second.id) {
+		m_pairs.push_back(BroadphasePair(first.object, second.object, first.id, second.id, first.shape, second.shape));
+	}
+	else {
+		m_pairs.push_back(BroadphasePair(second.object, first.object, second.id, first.id, second.shape, first.shape));
+	}
+}
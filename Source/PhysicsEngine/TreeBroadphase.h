@@ -0,0 +1,81 @@
+#pragma once
+#include "ExternalLibraries.h"
+#include "AABB.h"
+#include "AABBTree.h"
+#include "IBroadphase.h"
+
+namespace physics {
+	class PhysicsObject;
+
+	// Broadphase using dynamic AABB trees
+	// Static and dynamic objects are kept in separate trees. Each dynamic object queries both trees,
+	// so pairs of static objects are never visited. Handles scenes with objects of very different sizes.
+	// Unbounded objects (such as planes) can't be placed in a tree, and are tested against everything.
+	class TreeBroadphase : public IBroadphase {
+	public:
+		TreeBroadphase(float margin = AABBTree::k_def_margin);
+
+		virtual BroadphaseType getType() { return aabb_tree; }
+
+		// Starts tracking object's bounds
+		// Objects with empty bounds (such as joints) can't collide and are ignored
+		virtual void add(PhysicsObject* object);
+
+		// Stops tracking object
+		virtual void remove(PhysicsObject* object);
+
+		// Stops tracking all objects which have been killed
+		virtual void removeDead();
+
+		// Stops tracking all objects
+		virtual void clear();
+
+		// Returns pairs found by last update, in the order the objects were added
+		virtual const std::vector<BroadphasePair>& getPairs() { return m_pairs; }
+
+		virtual size_t getProxyCount() { return m_proxies.size(); }
+
+		// Appends every object whose bounds overlap bounds, as of last update
+		virtual void queryAABB(const AABB& bounds, std::vector<PhysicsObject*>& results);
+
+		// Appends every object containing point, as of last update
+		virtual void queryPoint(glm::vec2 point, std::vector<PhysicsObject*>& results);
+
+		AABBTree& getStaticTree() { return m_staticTree; }
+		AABBTree& getDynamicTree() { return m_dynamicTree; }
+
+	protected:
+		struct Proxy {
+			PhysicsObject* object;
+			size_t id;		// Order in which object was added
+			AABB bounds;	// Tight bounds, tested after trees' fattened bounds overlap
+			bool isStatic;
+			int node;		// Leaf in tree, or k_null_node if unbounded
+			ShapeType shape;
+		};
+
+		std::vector<Proxy> m_proxies;
+		std::vector<BroadphasePair> m_pairs;
+		std::vector<size_t> m_found;	// Scratch space for query results
+		AABBTree m_staticTree;
+		AABBTree m_dynamicTree;
+		size_t m_nextID;
+
+		// Refits trees to objects' bounds and finds overlapping pairs
+		virtual void findPairs();
+
+		AABBTree& treeFor(const Proxy& proxy) { return proxy.isStatic ? m_staticTree : m_dynamicTree; }
+
+		// Places proxy in tree matching its bounds and staticness
+		void insertProxy(size_t index);
+
+		// Takes proxy out of its tree
+		void removeProxy(size_t index);
+
+		// Removes proxy at index by swapping in the last proxy
+		void eraseProxy(size_t index);
+
+		// Adds pair if objects can collide and their bounds overlap
+		void testPair(const Proxy& first, const Proxy& second);
+	};
+}
@@ -0,0 +1,69 @@
+#include "catch.hpp"
+
+#include "ActorRegistry.h"
+#include "PhysicsScene.h"
+#include "Sphere.h"
+#include "Plane.h"
+
+using namespace physics;
+
+TEST_CASE("Registry handles", "[registry]") {
+	ActorRegistry registry;
+	SpherePtr s1(new Sphere({ 0,0 }, 1, { 0,0 }));
+	SpherePtr s2(new Sphere({ 3,0 }, 1, { 0,0 }));
+	PlanePtr p1(new Plane({ 0,1 }, 0));
+
+	ActorHandle h1 = registry.add(s1);
+	ActorHandle h2 = registry.add(s2);
+	ActorHandle h3 = registry.add(p1);
+	REQUIRE(registry.add(s1) == ActorHandle());
+	REQUIRE(registry.size() == 3);
+	REQUIRE(registry.get(h2) == s2.get());
+	REQUIRE(registry.find(p1.get()) == h3);
+	REQUIRE(s1.use_count() == 2);
+
+	// Last actor moves into removed actor's place
+	REQUIRE(registry.remove(h1));
+	REQUIRE_FALSE(registry.remove(h1));
+	REQUIRE(s1.use_count() == 1);
+	REQUIRE(registry.size() == 2);
+	REQUIRE(registry.getObjects()[0] == p1.get());
+	REQUIRE(registry.getOwners()[0] == p1);
+	REQUIRE(registry.get(h1) == nullptr);
+	REQUIRE(registry.get(h3) == p1.get());
+	REQUIRE_FALSE(registry.contains(s1.get()));
+
+	// Reused slot gets a new generation, so old handle stays out of date
+	ActorHandle h4 = registry.add(s1);
+	REQUIRE(h4.index == h1.index);
+	REQUIRE(h4 != h1);
+	REQUIRE(registry.get(h1) == nullptr);
+	REQUIRE(registry.get(h4) == s1.get());
+
+	registry.clear();
+	REQUIRE(registry.size() == 0);
+	REQUIRE(registry.get(h2) == nullptr);
+	REQUIRE(s2.use_count() == 1);
+}
+
+TEST_CASE("Scene handles", "[registry],[physics scene]") {
+	PhysicsScene scene;
+	SpherePtr s1(new Sphere({ 0,0 }, 1, { 0,0 }));
+	SpherePtr s2(new Sphere({ 5,0 }, 1, { 0,0 }));
+	scene.addActor(s1);
+	scene.addActor(s2);
+	ActorHandle handle = scene.getHandle(s1.get());
+	REQUIRE(scene.getActor(handle) == s1.get());
+	REQUIRE(scene.removeActor(handle));
+	REQUIRE_FALSE(s1->isAlive());
+	REQUIRE(scene.getActor(handle) == nullptr);
+	REQUIRE_FALSE(scene.removeActor(handle));
+	REQUIRE(scene.getActorCount() == 1);
+	REQUIRE(scene.getActors()[0] == s2);
+
+	// Dead actors leave at end of step
+	s2->kill();
+	scene.update(scene.getTimeStep());
+	REQUIRE(scene.getActorCount() == 0);
+	REQUIRE(s2.use_count() == 1);
+}
@@ -0,0 +1,49 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Global operator new is replaced to count allocations, so tests and benchmarks can check code doesn't allocate
+// Shared by both, so the replacement is defined once
+static std::atomic<size_t> s_allocations(0);
+
+size_t getAllocationCount()
+{
+	return s_allocations.load();
+}
+
+void* operator new(size_t size)
+{
+	++s_allocations;
+	void* memory = std::malloc(size > 0 ? size : 1);
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
@@ -0,0 +1,5 @@
+#pragma once
+#include <cstddef>
+
+// Number of times global operator new has been called by any thread since the program started
+size_t getAllocationCount();
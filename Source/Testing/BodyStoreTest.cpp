@@ -0,0 +1,109 @@
+#include "catch.hpp"
+
+#include "BodyStore.h"
+#include "PhysicsScene.h"
+#include "Sphere.h"
+#include "Box.h"
+
+#include "Utility.h"
+
+using namespace physics;
+
+TEST_CASE("Bodies keep state moving between stores", "[store]") {
+	SpherePtr s1(new Sphere({ 1,2 }, 1, { 3,4 }, 0.5f));
+	BoxPtr b1(new Box({ -1,-2 }, 1, 2, 0.25f, { -3,-4 }));
+	SpherePtr s2(new Sphere({ 5,6 }, 1, { 7,8 }));
+	s2->setStatic(true);
+	REQUIRE(s1->getStore() == &BodyStore::detached());
+
+	PhysicsScene scene(0.01f, { 0,0 });
+	scene.addActor(s1);
+	scene.addActor(b1);
+	scene.addActor(s2);
+	BodyStore& store = scene.getBodyStore();
+	REQUIRE(store.size() == 3);
+	REQUIRE(s1->getStore() == &store);
+	REQUIRE(store.bodies[b1->getSlot()] == b1.get());
+
+	// Removing first body moves last into its slot
+	scene.removeActor(s1);
+	REQUIRE(store.size() == 2);
+	REQUIRE(s1->getStore() == &BodyStore::detached());
+	REQUIRE(store.bodies[s2->getSlot()] == s2.get());
+	REQUIRE(s1->getPosition() == glm::vec2(1, 2));
+	REQUIRE(s1->getVelocity() == glm::vec2(3, 4));
+	REQUIRE(s1->getAngularVelocity() == 0.5f);
+	REQUIRE(b1->getPosition() == glm::vec2(-1, -2));
+	REQUIRE(b1->getOrientation() == 0.25f);
+	REQUIRE(s2->getPosition() == glm::vec2(5, 6));
+	REQUIRE(s2->isStatic());
+	REQUIRE(s2->getInvMass() == 0);
+}
+
+TEST_CASE("Scene integration matches single body", "[store]") {
+	PhysicsScene scene(0.01f, { 0,-10 });
+	SpherePtr inScene(new Sphere({ 0,0 }, 1, { 2,5 }, 1, 2, 1, 0, 0.3f, 0.2f));
+	SpherePtr alone(new Sphere(*inScene));
+	scene.addActor(inScene);
+	for (int i = 0; i < 50; ++i) {
+		inScene->applyForce({ 1,0 }, { 0,1 });
+		alone->applyForce({ 1,0 }, { 0,1 });
+		scene.update(0.01f);
+		alone->fixedUpdate(&scene);
+	}
+	REQUIRE(inScene->getPosition() == alone->getPosition());
+	REQUIRE(inScene->getVelocity() == alone->getVelocity());
+	REQUIRE(inScene->getOrientation() == alone->getOrientation());
+	REQUIRE(inScene->getPastPosition() == alone->getPastPosition());
+}
+
+TEST_CASE("Bodies outlive scene", "[store]") {
+	SpherePtr sphere(new Sphere({ 0,0 }, 1, { 1,0 }));
+	size_t detached = BodyStore::detached().size();
+	{
+		PhysicsScene scene(0.01f, { 0,0 });
+		scene.addActor(sphere);
+		scene.addActor(new Sphere({ 5,0 }, 1, { 0,0 }));
+		REQUIRE(BodyStore::detached().size() == detached - 1);
+		scene.update(0.01f);
+	}
+	REQUIRE(sphere->getStore() == &BodyStore::detached());
+	REQUIRE(BodyStore::detached().size() == detached);
+	REQUIRE(sphere->getPosition().x == Approx(0.01f));
+}
+
+TEST_CASE("SIMD integration matches scalar", "[store]") {
+	BodyStore simd;
+	// Count not a multiple of four, so scalar path finishes the end
+	for (size_t i = 0; i < 23; ++i) {
+		simd.add(nullptr);
+		float f = (float)i;
+		simd.position[i] = { f, -f };
+		simd.velocity[i] = { sinf(f) * 5, cosf(f) * 5 };
+		simd.force[i] = { f, 1 };
+		simd.torque[i] = 0.5f;
+		simd.orientation[i] = remainderf(f * 0.9f, glm::two_pi<float>());
+		simd.angularVelocity[i] = (f - 11) * 2;
+		simd.invMass[i] = (i % 5 == 0) ? 0 : 1 / (f + 1);
+		simd.invMoment[i] = (i % 5 == 0) ? 0 : 2 / (f + 1);
+		simd.drag[i] = 0.1f * (i % 3);
+		simd.angularDrag[i] = 0.2f * (i % 4);
+		simd.flags[i] = (i % 7 == 3) ? BodyStore::static_body : (i % 6 == 1) ? 0 : BodyStore::awake;
+		simd.calculateAxes(i);
+	}
+	BodyStore scalar = simd;
+	for (int step = 0; step < 200; ++step) {
+		simd.integrateSimd({ 0,-10 }, 0.01f, 0, simd.size());
+		scalar.integrateScalar({ 0,-10 }, 0.01f, 0, scalar.size());
+	}
+	for (size_t i = 0; i < simd.size(); ++i) {
+		REQUIRE(vectorApprox(simd.position[i], scalar.position[i], 0.0001f));
+		REQUIRE(vectorApprox(simd.velocity[i], scalar.velocity[i], 0.0001f));
+		REQUIRE(simd.angularVelocity[i] == Approx(scalar.angularVelocity[i]));
+		// Orientations may wrap either side of pi
+		REQUIRE(vectorApprox(simd.localX[i], scalar.localX[i], 0.0001f));
+		REQUIRE(vectorApprox(simd.localY[i], scalar.localY[i], 0.0001f));
+		REQUIRE(simd.force[i] == glm::vec2(0));
+		REQUIRE(simd.torque[i] == 0);
+	}
+}
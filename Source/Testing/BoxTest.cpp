@@ -129,6 +129,40 @@ TEST_CASE("Box-Box collision") {
 	delete b2;
 }
 
+TEST_CASE("Box-Box separating axes") {
+	Box b1({ 0,0 }, 2, 2, 0);
+	Box b2({ 1.8f,1.8f }, 2, 2, glm::quarter_pi<float>());
+	// Only second box's axes separate these
+	REQUIRE_FALSE(b1.checkBoxCollision(&b2));
+	REQUIRE_FALSE(b2.checkBoxCollision(&b1));
+
+	// Compare with projecting each box's centre and extents onto each axis
+	for (int i = 0; i < 200; ++i) {
+		b2.setPosition({ sinf(i * 0.37f) * 2.5f, cosf(i * 0.53f) * 2.5f });
+		b2.setOrientation(i * 0.11f);
+		b1.setOrientation(i * -0.07f);
+		glm::vec2 axes[4] = { b1.getLocalX(), b1.getLocalY(), b2.getLocalX(), b2.getLocalY() };
+		float minOverlap = INFINITY;
+		for (glm::vec2 axis : axes) {
+			float r1 = abs(glm::dot(b1.getXExtent(), axis)) + abs(glm::dot(b1.getYExtent(), axis));
+			float r2 = abs(glm::dot(b2.getXExtent(), axis)) + abs(glm::dot(b2.getYExtent(), axis));
+			minOverlap = std::min(minOverlap, r1 + r2 - abs(glm::dot(b2.getPosition() - b1.getPosition(), axis)));
+		}
+		if (abs(minOverlap) < 0.001f) {
+			// Too close to call
+			continue;
+		}
+		Collision col = b1.checkBoxCollision(&b2);
+		REQUIRE(col.success == (minOverlap > 0));
+		REQUIRE(b2.checkBoxCollision(&b1).success == col.success);
+		if (col) {
+			// Preferred axis may not be the least overlapping, but is never far off
+			REQUIRE(col.depth >= minOverlap - 0.001f);
+			REQUIRE(col.depth <= minOverlap / Box::k_axis_preference + 0.001f);
+		}
+	}
+}
+
 TEST_CASE("Box-Sphere collision") {
 	Box* b = new Box({ 0,0 }, 4, 3, 0);
 	Sphere* s = new Sphere({ 3,3 },1, { 0,0 }, 0);
@@ -0,0 +1,287 @@
+#include "catch.hpp"
+
+#include "SweepAndPrune.h"
+#include "SpatialHashGrid.h"
+#include "TreeBroadphase.h"
+#include "PhysicsScene.h"
+#include "Sphere.h"
+#include "Box.h"
+#include "Plane.h"
+#include "Spring.h"
+
+#include "Utility.h"
+
+using namespace physics;
+
+TEST_CASE("Bounding boxes", "[broadphase]") {
+	SECTION("Sphere") {
+		Sphere s({ 3,-2 }, 2, { 0,0 });
+		AABB box = s.getAABB();
+		REQUIRE(vectorApprox(box.min, { 1,-4 }));
+		REQUIRE(vectorApprox(box.max, { 5,0 }));
+	}
+	SECTION("Rotated box") {
+		Box b({ 0,0 }, 2, 2, glm::quarter_pi<float>());
+		AABB box = b.getAABB();
+		REQUIRE(vectorApprox(box.min, { -1.4142f,-1.4142f }, k_margin));
+		REQUIRE(vectorApprox(box.max, { 1.4142f,1.4142f }, k_margin));
+	}
+	SECTION("Plane overlaps everything") {
+		Plane p({ 0,1 }, 5);
+		Sphere s({ 100,100 }, 1, { 0,0 });
+		REQUIRE(p.getAABB().overlaps(s.getAABB()));
+	}
+	SECTION("Spring has empty bounds") {
+		Spring spring(1, 1, 0);
+		REQUIRE(spring.getAABB().isEmpty());
+	}
+}
+
+TEST_CASE("Sweep and prune", "[broadphase]") {
+	SweepAndPrune broadphase;
+	Sphere s1({ 0,0 }, 1, { 0,0 });
+	Sphere s2({ 1.5f,0 }, 1, { 0,0 });
+	Sphere s3({ 10,0 }, 1, { 0,0 });
+	Box b({ 0,20 }, 2, 2, 0);
+	broadphase.add(&s1);
+	broadphase.add(&s2);
+	broadphase.add(&s3);
+	broadphase.add(&b);
+	broadphase.update();
+	SECTION("Only overlapping pairs found") {
+		REQUIRE(broadphase.getPairs().size() == 1);
+		REQUIRE(broadphase.getPairs()[0].first == &s1);
+		REQUIRE(broadphase.getPairs()[0].second == &s2);
+	}
+	SECTION("Pairs found after objects move") {
+		s3.setPosition({ -1,0 });
+		b.setPosition({ 0, 1.5f });
+		broadphase.update();
+		// Every object now overlaps s1, and order matches order of adding
+		auto pairs = broadphase.getPairs();
+		REQUIRE(pairs.size() == 5);
+		REQUIRE(pairs[0].first == &s1);
+		REQUIRE(pairs[0].second == &s2);
+		REQUIRE(pairs[1].second == &s3);
+		REQUIRE(pairs[2].second == &b);
+		REQUIRE(std::is_sorted(pairs.begin(), pairs.end()));
+	}
+	SECTION("Static pairs are skipped") {
+		s1.setStatic(true);
+		s2.setStatic(true);
+		broadphase.update();
+		REQUIRE(broadphase.getPairs().empty());
+	}
+	SECTION("Removed objects are not paired") {
+		broadphase.remove(&s2);
+		broadphase.update();
+		REQUIRE(broadphase.getPairs().empty());
+		s1.kill();
+		broadphase.removeDead();
+		REQUIRE(broadphase.getProxyCount() == 2);
+	}
+	SECTION("Planes pair with all bodies") {
+		Plane p({ 0,1 }, 0);
+		broadphase.add(&p);
+		broadphase.update();
+		REQUIRE(broadphase.getPairs().size() == 5);
+		broadphase.remove(&p);
+	}
+}
+
+
+TEST_CASE("Spatial hash grid", "[broadphase]") {
+	SpatialHashGrid broadphase;
+	Sphere s1({ 0,0 }, 1, { 0,0 });
+	Sphere s2({ 1.5f,0 }, 1, { 0,0 });
+	Sphere s3({ 10,0 }, 1, { 0,0 });
+	Box b({ 0,20 }, 2, 2, 0);
+	broadphase.add(&s1);
+	broadphase.add(&s2);
+	broadphase.add(&s3);
+	broadphase.add(&b);
+	broadphase.update();
+	SECTION("Cell size taken from median diagonal") {
+		REQUIRE(broadphase.isAutoCellSize());
+		REQUIRE(broadphase.getCellSize() == Approx(2));
+		REQUIRE_THROWS(broadphase.setCellSize(-1));
+	}
+	SECTION("Only overlapping pairs found") {
+		REQUIRE(broadphase.getPairs().size() == 1);
+		REQUIRE(broadphase.getPairs()[0].first == &s1);
+		REQUIRE(broadphase.getPairs()[0].second == &s2);
+	}
+	SECTION("Pairs spanning several cells found once") {
+		broadphase.setCellSize(0.25f);
+		broadphase.update();
+		REQUIRE(broadphase.getPairs().size() == 1);
+	}
+	SECTION("Pairs found after objects move") {
+		s3.setPosition({ -1,0 });
+		b.setPosition({ 0, 1.5f });
+		broadphase.update();
+		auto pairs = broadphase.getPairs();
+		REQUIRE(pairs.size() == 5);
+		REQUIRE(std::is_sorted(pairs.begin(), pairs.end()));
+	}
+	SECTION("Static pairs are skipped") {
+		s1.setStatic(true);
+		s2.setStatic(true);
+		broadphase.update();
+		REQUIRE(broadphase.getPairs().empty());
+	}
+	SECTION("Planes pair with all bodies") {
+		Plane p({ 0,1 }, 0);
+		broadphase.add(&p);
+		broadphase.update();
+		REQUIRE(broadphase.getPairs().size() == 5);
+		broadphase.remove(&p);
+	}
+}
+
+TEST_CASE("AABB tree", "[broadphase]") {
+	AABBTree tree(0.5f);
+	for (size_t i = 0; i < 64; ++i) {
+		glm::vec2 position((float)i, 0);
+		tree.insert(AABB(position, position + glm::vec2(0.5f)), i);
+	}
+	SECTION("Tree stays balanced") {
+		// Leaves inserted in order would form a list without rotations
+		REQUIRE(tree.getLeafCount() == 64);
+		REQUIRE(tree.getHeight() <= 12);
+	}
+	SECTION("Query finds overlapping leaves") {
+		std::vector<size_t> found;
+		tree.query(AABB({ 9.8f,0 }, { 9.9f,0 }), found);
+		std::sort(found.begin(), found.end());
+		REQUIRE(found == std::vector<size_t>({ 9,10 }));
+	}
+	SECTION("Small moves stay within fattened bounds") {
+		int leaf = tree.insert(AABB({ 0,10 }, { 1,11 }), 100);
+		REQUIRE_FALSE(tree.move(leaf, AABB({ 0.2f,10 }, { 1.2f,11 })));
+		REQUIRE(tree.move(leaf, AABB({ 5,10 }, { 6,11 })));
+		tree.remove(leaf);
+		REQUIRE(tree.getLeafCount() == 64);
+	}
+}
+
+TEST_CASE("Tree broadphase", "[broadphase]") {
+	TreeBroadphase broadphase;
+	Sphere s1({ 0,0 }, 1, { 0,0 });
+	Sphere s2({ 1.5f,0 }, 1, { 0,0 });
+	Sphere s3({ 10,0 }, 1, { 0,0 });
+	Box b({ 0,20 }, 2, 2, 0);
+	broadphase.add(&s1);
+	broadphase.add(&s2);
+	broadphase.add(&s3);
+	broadphase.add(&b);
+	broadphase.update();
+	SECTION("Only overlapping pairs found") {
+		REQUIRE(broadphase.getPairs().size() == 1);
+		REQUIRE(broadphase.getPairs()[0].first == &s1);
+		REQUIRE(broadphase.getPairs()[0].second == &s2);
+	}
+	SECTION("Pairs found after objects move") {
+		s3.setPosition({ -1,0 });
+		b.setPosition({ 0, 1.5f });
+		broadphase.update();
+		auto pairs = broadphase.getPairs();
+		REQUIRE(pairs.size() == 5);
+		REQUIRE(std::is_sorted(pairs.begin(), pairs.end()));
+	}
+	SECTION("Static objects kept in separate tree") {
+		s1.setStatic(true);
+		s2.setStatic(true);
+		broadphase.update();
+		REQUIRE(broadphase.getPairs().empty());
+		REQUIRE(broadphase.getStaticTree().getLeafCount() == 2);
+		REQUIRE(broadphase.getDynamicTree().getLeafCount() == 2);
+	}
+	SECTION("Removed objects are not paired") {
+		broadphase.remove(&s2);
+		broadphase.update();
+		REQUIRE(broadphase.getPairs().empty());
+		s1.kill();
+		broadphase.removeDead();
+		REQUIRE(broadphase.getProxyCount() == 2);
+	}
+	SECTION("Planes pair with all bodies") {
+		Plane p({ 0,1 }, 0);
+		broadphase.add(&p);
+		broadphase.update();
+		REQUIRE(broadphase.getPairs().size() == 5);
+		broadphase.remove(&p);
+	}
+	SECTION("Scene queries") {
+		std::vector<PhysicsObject*> found;
+		broadphase.queryPoint({ 1.5f,0.5f }, found);
+		REQUIRE(found.size() == 1);
+		REQUIRE(found[0] == &s2);
+		found.clear();
+		broadphase.queryAABB(AABB({ -20,-1 }, { 20,1 }), found);
+		REQUIRE(found.size() == 3);
+	}
+}
+
+TEST_CASE("Broadphases agree", "[broadphase]") {
+	SweepAndPrune sap;
+	SpatialHashGrid grid;
+	TreeBroadphase tree;
+	std::vector<SpherePtr> spheres;
+	// Grid of spheres of varying size, many of which overlap
+	for (int i = 0; i < 200; ++i) {
+		glm::vec2 position((float)(i % 20) * 1.3f, (float)(i / 20) * 1.1f);
+		float radius = 0.5f + (float)(i % 7) * 0.15f;
+		spheres.push_back(std::make_shared<Sphere>(position, radius, glm::vec2(0, 0)));
+		sap.add(spheres.back().get());
+		grid.add(spheres.back().get());
+		tree.add(spheres.back().get());
+	}
+	sap.update();
+	grid.update();
+	tree.update();
+	REQUIRE(!sap.getPairs().empty());
+	REQUIRE(sap.getPairs().size() == grid.getPairs().size());
+	REQUIRE(sap.getPairs().size() == tree.getPairs().size());
+	for (size_t i = 0; i < sap.getPairs().size(); ++i) {
+		REQUIRE(sap.getPairs()[i].first == grid.getPairs()[i].first);
+		REQUIRE(sap.getPairs()[i].second == grid.getPairs()[i].second);
+		REQUIRE(sap.getPairs()[i].first == tree.getPairs()[i].first);
+		REQUIRE(sap.getPairs()[i].second == tree.getPairs()[i].second);
+	}
+}
+
+TEST_CASE("Scene broadphase selection", "[broadphase][physics scene]") {
+	PhysicsScene scene(0.01f, { 0,-10 }, spatial_hash);
+	REQUIRE(scene.getBroadphaseType() == spatial_hash);
+	scene.addActor(new Plane({ 0,1 }, 0));
+	for (int i = 0; i < 10; ++i) {
+		scene.addActor(new Sphere({ (float)i * 3, 1 }, 1, { 0,0 }));
+	}
+	scene.update(0.01f);
+	const BroadphaseStats& stats = scene.getBroadphaseStats();
+	REQUIRE(stats.steps == 1);
+	REQUIRE(stats.candidatePairs == 10);
+	REQUIRE(stats.contacts == 10);
+
+	SECTION("Switching broadphase keeps actors") {
+		BroadphaseType types[] = { brute_force, sweep_and_prune, spatial_hash, aabb_tree };
+		for (BroadphaseType type : types) {
+			scene.setBroadphase(type);
+			REQUIRE(scene.getBroadphaseType() == type);
+			REQUIRE(scene.getBroadphase()->getProxyCount() == 11);
+			scene.update(0.01f);
+			// New broadphase starts with fresh stats
+			REQUIRE(scene.getBroadphaseStats().steps == 1);
+		}
+	}
+	SECTION("Brute force tests every non-static pair") {
+		scene.setBroadphase(brute_force);
+		scene.update(0.01f);
+		REQUIRE(scene.getBroadphaseStats().candidatePairs == 55);
+	}
+	SECTION("Scene queries") {
+		REQUIRE(scene.queryPoint({ 3,1 }).size() == 1);
+		REQUIRE(scene.queryAABB(AABB({ -1,0 }, { 4,2 })).size() == 3);
+	}
+}
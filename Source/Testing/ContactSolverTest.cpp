@@ -0,0 +1,151 @@
+#include "catch.hpp"
+
+#include "PhysicsScene.h"
+#include "ContactSolver.h"
+#include "Sphere.h"
+#include "Box.h"
+#include "Plane.h"
+
+#include "Utility.h"
+
+#include <stdexcept>
+
+using namespace physics;
+
+// Builds stack of boxes resting on ground, returning the boxes from bottom to top
+static std::vector<Box*> makeStack(PhysicsScene& scene, size_t height)
+{
+	std::vector<Box*> boxes;
+	scene.addActor(new Plane({ 0,1 }, 0, 0, 0.5f));
+	for (size_t i = 0; i < height; ++i) {
+		Box* box = new Box({ 0, 0.5f + i }, 1, 1, 0, { 0,0 }, 0, 1, 0, 0.5f);
+		boxes.push_back(box);
+		scene.addActor(box);
+	}
+	return boxes;
+}
+
+// Returns speed of fastest box
+static float maxSpeed(const std::vector<Box*>& boxes)
+{
+	float speed = 0;
+	for (Box* box : boxes) {
+		speed = std::max(speed, glm::length(box->getVelocity()));
+	}
+	return speed;
+}
+
+TEST_CASE("Manifold persists while in contact", "[contact]") {
+	PhysicsScene scene(0.01f, { 0,-10 });
+	Plane* ground = new Plane({ 0,1 }, 0, 0);
+	Sphere* ball = new Sphere({ 0,0.99f }, 1, { 0,0 }, 0, 1, 0);
+	scene.addActor(ground);
+	scene.addActor(ball);
+	for (int i = 0; i < 10; ++i) {
+		scene.update(0.01f);
+	}
+	const ContactManifold* manifold = scene.getContactSolver().findManifold(ball, ground);
+	REQUIRE(manifold != nullptr);
+	// Accumulated impulse should hold ball against gravity for one step
+	REQUIRE(manifold->points[0].normalImpulse == Approx(0.1f).epsilon(0.05f));
+	REQUIRE(glm::length(ball->getVelocity()) < 0.01f);
+
+	// Manifold dropped once objects separate
+	ball->setPosition({ 0,5 });
+	scene.update(0.01f);
+	REQUIRE(scene.getContactSolver().findManifold(ball, ground) == nullptr);
+}
+
+TEST_CASE("Manifolds dropped with removed actors", "[contact]") {
+	PhysicsScene scene(0.01f, { 0,-10 });
+	Plane* ground = new Plane({ 0,1 }, 0, 0);
+	std::shared_ptr<Sphere> ball(new Sphere({ 0,0.99f }, 1, { 0,0 }, 0, 1, 0));
+	scene.addActor(ground);
+	scene.addActor(ball);
+	for (int i = 0; i < 10; ++i) {
+		scene.update(0.01f);
+	}
+	REQUIRE(scene.getContactSolver().findManifold(ball.get(), ground) != nullptr);
+	// Pools hand out removed objects' addresses again, so nothing may be left to warm start from
+	SECTION("Removing one actor") {
+		scene.removeActor(ball);
+	}
+	SECTION("Removing actors in bulk") {
+		scene.removeActors({ ball });
+	}
+	SECTION("Killing actor") {
+		ball->kill();
+		scene.update(0.01f);
+	}
+	REQUIRE(scene.getContactSolver().findManifold(ball.get(), ground) == nullptr);
+}
+
+TEST_CASE("Collisions with triggers aren't solved", "[contact]") {
+	PhysicsScene scene(0.01f, { 0,0 });
+	Sphere* ball = new Sphere({ 0,0 }, 1, { 1,0 });
+	Sphere* trigger = new Sphere({ 1,0 }, 1, { 0,0 });
+	trigger->setTrigger(true);
+	scene.addActor(ball);
+	scene.addActor(trigger);
+	scene.update(0.01f);
+	REQUIRE(scene.getContactSolver().findManifold(ball, trigger) == nullptr);
+	REQUIRE(ball->getVelocity() == glm::vec2(1, 0));
+}
+
+TEST_CASE("Warm starting settles stack", "[contact]") {
+	PhysicsScene warm(0.01f, { 0,-10 });
+	PhysicsScene cold(0.01f, { 0,-10 });
+	std::vector<Box*> warmStack = makeStack(warm, 4);
+	std::vector<Box*> coldStack = makeStack(cold, 4);
+	warm.setSolverIterations(2);
+	cold.setSolverIterations(2);
+	cold.getContactSolver().setWarmStarting(false);
+	for (int i = 0; i < 100; ++i) {
+		warm.update(0.01f);
+		cold.update(0.01f);
+	}
+	REQUIRE(maxSpeed(warmStack) < 0.05f);
+	REQUIRE(maxSpeed(warmStack) < maxSpeed(coldStack));
+	// Stack should stay upright, resting on both corners of each box
+	REQUIRE(warmStack.back()->getPosition().x == Approx(0).margin(0.05f));
+	const ContactManifold* manifold = warm.getContactSolver().findManifold(warmStack[0], warmStack[1]);
+	REQUIRE(manifold != nullptr);
+	REQUIRE(manifold->pointCount == 2);
+}
+
+TEST_CASE("Box manifolds", "[contact]") {
+	Plane ground({ 0,1 }, 0);
+	Box lower({ 0,0.49f }, 1, 1, 0);
+	Box upper({ 0.3f,1.48f }, 1, 1, 0);
+
+	Collision planeCollision = lower.checkPlaneCollision(&ground);
+	REQUIRE(planeCollision.pointCount == 2);
+	for (size_t i = 0; i < planeCollision.pointCount; ++i) {
+		REQUIRE(planeCollision.points[i].depth == Approx(0.01f));
+		REQUIRE(planeCollision.points[i].position.y == Approx(-0.01f));
+	}
+	// Bottom corners are first two
+	REQUIRE(planeCollision.points[0].feature + planeCollision.points[1].feature == 1);
+
+	Collision boxCollision = upper.checkBoxCollision(&lower);
+	REQUIRE(boxCollision.pointCount == 2);
+	float minX = std::min(boxCollision.points[0].position.x, boxCollision.points[1].position.x);
+	float maxX = std::max(boxCollision.points[0].position.x, boxCollision.points[1].position.x);
+	// Manifold spans overlap of boxes' faces
+	REQUIRE(minX == Approx(-0.2f));
+	REQUIRE(maxX == Approx(0.5f));
+	for (size_t i = 0; i < boxCollision.pointCount; ++i) {
+		REQUIRE(boxCollision.points[i].depth == Approx(0.01f));
+		REQUIRE(boxCollision.points[i].position.y == Approx(0.985f));
+	}
+}
+
+TEST_CASE("Solver iterations", "[contact]") {
+	PhysicsScene scene;
+	size_t defaultIterations = ContactSolver::k_def_iterations;
+	REQUIRE(scene.getSolverIterations() == defaultIterations);
+	scene.setSolverIterations(10);
+	REQUIRE(scene.getSolverIterations() == 10);
+	REQUIRE_THROWS_AS(scene.setSolverIterations(0), std::invalid_argument);
+	REQUIRE_THROWS_AS(scene.setPositionIterations(0), std::invalid_argument);
+}
@@ -0,0 +1,89 @@
+#include "catch.hpp"
+
+#include "FrameArena.h"
+#include "PhysicsScene.h"
+#include "Sphere.h"
+#include "Box.h"
+#include "Plane.h"
+#include "Rope.h"
+
+#include "Utility.h"
+#include "AllocationCounter.h"
+
+using namespace physics;
+
+TEST_CASE("Frame arena", "[arena]") {
+	FrameArena arena(64);
+	char* a = (char*)arena.allocate(3, 1);
+	double* b = (double*)arena.allocate(sizeof(double), alignof(double));
+	REQUIRE((uintptr_t)b % alignof(double) == 0);
+	REQUIRE((char*)b - a < 16);
+	REQUIRE(arena.getUsed() == 3 + sizeof(double));
+
+	// Reset starts again from beginning of block
+	arena.reset();
+	REQUIRE(arena.getUsed() == 0);
+	REQUIRE(arena.allocate(3, 1) == a);
+
+	// Running past end of block grows it on next reset
+	for (int i = 0; i < 10; ++i) {
+		arena.allocate(32, 8);
+	}
+	REQUIRE(arena.getCapacity() == 64);
+	arena.reset();
+	REQUIRE(arena.getCapacity() >= 323);
+	REQUIRE_THROWS(FrameArena(0));
+}
+
+TEST_CASE("Arena containers", "[arena]") {
+	FrameArena arena;
+	{
+		ArenaAllocator<int> allocator(&arena);
+		std::vector<int, ArenaAllocator<int>> numbers(allocator);
+		for (int i = 0; i < 100; ++i) {
+			numbers.push_back(i);
+		}
+		REQUIRE(numbers[99] == 99);
+		REQUIRE(arena.getUsed() >= 100 * sizeof(int));
+	}
+	arena.reset();
+
+	// Without an arena, allocator uses the heap
+	CollisionList collisions;
+	collisions.push_back(Collision(true));
+	REQUIRE(collisions.get_allocator().getArena() == nullptr);
+}
+
+TEST_CASE("Steps don't allocate after warm-up", "[arena],[physics scene]") {
+	PhysicsScene scene(0.01f, { 0,-10 });
+	scene.addActor(new Plane({ 0,1 }, 0));
+	scene.addActor(new Plane({ 1,0 }, -15));
+	scene.addActor(new Plane({ -1,0 }, -15));
+	for (int i = 0; i < 10; ++i) {
+		scene.addActor(new Sphere({ i * 2.5f - 12, 1.f + i % 3 }, 1, { 3,0 }));
+	}
+	for (int i = 0; i < 5; ++i) {
+		scene.addActor(new Box({ i * 3.f - 6, 6 }, 2, 2, 0.3f, { -2,0 }));
+	}
+	Sphere particle({ 0,0 }, 0.3f, { 0,0 });
+	Rope rope({ -5,10 }, &particle, 6, 1, 50, 0.1f);
+	rope.addToScene(&scene);
+	// Bodies stay awake and keep making and breaking contacts
+	scene.setSleepingEnabled(false);
+	SECTION("On calling thread") {
+	}
+	SECTION("With worker threads") {
+		scene.setWorkerCount(3);
+	}
+
+	for (int i = 0; i < 300; ++i) {
+		scene.update(scene.getTimeStep());
+	}
+	size_t allocations = getAllocationCount();
+	for (int i = 0; i < 100; ++i) {
+		scene.update(scene.getTimeStep());
+	}
+	// Count before REQUIRE, which allocates itself
+	allocations = getAllocationCount() - allocations;
+	REQUIRE(allocations == 0);
+}
@@ -0,0 +1,133 @@
+#include "catch.hpp"
+
+#include "PhysicsScene.h"
+#include "IslandManager.h"
+#include "Sphere.h"
+#include "Box.h"
+#include "Plane.h"
+#include "Spring.h"
+
+#include "Utility.h"
+
+#include <stdexcept>
+
+using namespace physics;
+
+TEST_CASE("Resting body sleeps", "[island]") {
+	PhysicsScene scene(0.01f, { 0,-10 });
+	scene.addActor(new Plane({ 0,1 }, 0, 0));
+	Box* box = new Box({ 0,0.5f }, 1, 1, 0, { 0,0 }, 0, 1, 0, 0.5f);
+	scene.addActor(box);
+	for (int i = 0; i < 100; ++i) {
+		scene.update(0.01f);
+	}
+	REQUIRE_FALSE(box->isAwake());
+	glm::vec2 position = box->getPosition();
+	scene.update(0.01f);
+	REQUIRE(box->getPosition() == position);
+
+	SECTION("Impulse wakes body") {
+		box->applyImpulse({ 0,5 });
+		REQUIRE(box->isAwake());
+		scene.update(0.01f);
+		REQUIRE(box->getPosition().y > position.y);
+	}
+	SECTION("Disabling sleep wakes body") {
+		scene.setSleepingEnabled(false);
+		REQUIRE(box->isAwake());
+		for (int i = 0; i < 100; ++i) {
+			scene.update(0.01f);
+		}
+		REQUIRE(box->isAwake());
+	}
+}
+
+TEST_CASE("Moving body wakes body it hits", "[island]") {
+	PhysicsScene scene(0.01f, { 0,0 });
+	Sphere* moving = new Sphere({ 0,0 }, 1, { 5,0 });
+	Sphere* resting = new Sphere({ 3,0 }, 1, { 0,0 });
+	scene.addActor(moving);
+	scene.addActor(resting);
+	resting->setAwake(false);
+	for (int i = 0; i < 20; ++i) {
+		scene.update(0.01f);
+	}
+	REQUIRE(resting->isAwake());
+	// Elastic collision passes on velocity
+	REQUIRE(resting->getVelocity().x == Approx(5));
+}
+
+TEST_CASE("Islands", "[island]") {
+	PhysicsScene scene(0.01f, { 0,0 });
+	SpherePtr s1(new Sphere({ 0,0 }, 1, { 0,0 }));
+	SpherePtr s2(new Sphere({ 3,0 }, 1, { 0,0 }));
+	SpherePtr s3(new Sphere({ 10,0 }, 1, { 0,0 }));
+	SpherePtr s4(new Sphere({ 11.5f,0 }, 1, { 0,0 }));
+	SpherePtr s5(new Sphere({ 20,0 }, 1, { 0,0 }));
+	SpringPtr spring(new Spring(1, 3, 0, s1, s2));
+	for (auto sphere : { s1,s2,s3,s4,s5 }) {
+		scene.addActor(sphere);
+	}
+	scene.addActor(spring);
+	scene.update(0.01f);
+
+	// Joined by spring, joined by contact, and alone
+	IslandManager& islands = scene.getIslandManager();
+	REQUIRE(islands.getIslandCount() == 3);
+	REQUIRE(islands.getIsland(s1.get()) == islands.getIsland(s2.get()));
+	REQUIRE(islands.getIsland(s3.get()) == islands.getIsland(s4.get()));
+	REQUIRE(islands.getIsland(s1.get()) != islands.getIsland(s3.get()));
+	REQUIRE(islands.getIsland(s5.get()) != islands.getIsland(s1.get()));
+	REQUIRE(islands.getIsland(s5.get()) != islands.getIsland(s3.get()));
+
+	SECTION("Spring wakes other end") {
+		s1->setAwake(false);
+		s2->setAwake(false);
+		scene.update(0.01f);
+		REQUIRE_FALSE(s2->isAwake());
+		s1->applyImpulse({ -1,0 });
+		scene.update(0.01f);
+		REQUIRE(s2->isAwake());
+	}
+}
+
+TEST_CASE("Removing support wakes body", "[island]") {
+	PhysicsScene scene(0.01f, { 0,-10 });
+	scene.addActor(new Plane({ 0,1 }, 0, 0));
+	BoxPtr lower(new Box({ 0,0.5f }, 1, 1, 0, { 0,0 }, 0, 1, 0, 0.5f));
+	BoxPtr upper(new Box({ 0,1.5f }, 1, 1, 0, { 0,0 }, 0, 1, 0, 0.5f));
+	BoxPtr distant(new Box({ 10,0.5f }, 1, 1, 0, { 0,0 }, 0, 1, 0, 0.5f));
+	scene.addActor(lower);
+	scene.addActor(upper);
+	scene.addActor(distant);
+	for (int i = 0; i < 150; ++i) {
+		scene.update(0.01f);
+	}
+	REQUIRE_FALSE(upper->isAwake());
+	SECTION("Removing one actor") {
+		scene.removeActor(lower);
+	}
+	SECTION("Removing actors in bulk") {
+		BoxPtr other(new Box({ -10,0.5f }, 1, 1, 0, { 0,0 }, 0, 1, 0, 0.5f));
+		scene.addActor(other);
+		scene.removeActors({ other, lower });
+	}
+	SECTION("Killing actor") {
+		lower->kill();
+		scene.update(0.01f);
+	}
+	REQUIRE(upper->isAwake());
+	REQUIRE_FALSE(distant->isAwake());
+	float height = upper->getPosition().y;
+	scene.update(0.01f);
+	REQUIRE(upper->getPosition().y < height);
+}
+
+TEST_CASE("Sleep thresholds", "[island]") {
+	IslandManager islands;
+	REQUIRE_THROWS_AS(islands.setLinearThreshold(-1), std::invalid_argument);
+	REQUIRE_THROWS_AS(islands.setAngularThreshold(NAN), std::invalid_argument);
+	REQUIRE_THROWS_AS(islands.setTimeToSleep(-1), std::invalid_argument);
+	islands.setTimeToSleep(INFINITY);
+	REQUIRE(islands.getTimeToSleep() == INFINITY);
+}
@@ -0,0 +1,101 @@
+#include "catch.hpp"
+
+#include "JobSystem.h"
+#include "PhysicsScene.h"
+#include "Sphere.h"
+#include "Plane.h"
+
+#include "Utility.h"
+
+#include <stdexcept>
+
+using namespace physics;
+
+TEST_CASE("Parallel for visits every item once", "[jobs]") {
+	JobSystem jobs(3);
+	REQUIRE(jobs.getWorkerCount() == 3);
+	std::vector<std::atomic<int>> visits(10000);
+	for (auto& visit : visits) {
+		visit = 0;
+	}
+	// Catch can't be used from other threads
+	std::atomic<bool> oversized(false);
+	for (int repeat = 0; repeat < 10; ++repeat) {
+		jobs.parallelFor(visits.size(), 7, [&visits, &oversized](size_t begin, size_t end) {
+			if (end - begin > 7) {
+				oversized = true;
+			}
+			for (size_t i = begin; i < end; ++i) {
+				++visits[i];
+			}
+		});
+	}
+	REQUIRE_FALSE(oversized);
+	REQUIRE(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& visit) { return visit == 10; }));
+	REQUIRE(JobSystem::rangeCount(10000, 7) == 1429);
+}
+
+TEST_CASE("Single thread mode runs in order", "[jobs]") {
+	JobSystem jobs(2);
+	jobs.setWorkerCount(0);
+	REQUIRE(jobs.getWorkerCount() == 0);
+	std::vector<size_t> order;
+	jobs.parallelFor(100, 10, [&order](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			order.push_back(i);
+		}
+	});
+	REQUIRE(order.size() == 100);
+	for (size_t i = 0; i < order.size(); ++i) {
+		REQUIRE(order[i] == i);
+	}
+	REQUIRE_THROWS_AS(jobs.parallelFor(10, 0, [](size_t, size_t) {}), std::invalid_argument);
+}
+
+TEST_CASE("Exceptions from jobs reach caller", "[jobs]") {
+	JobSystem jobs(2);
+	REQUIRE_THROWS_AS(jobs.parallelFor(100, 1, [](size_t begin, size_t /*end*/) {
+		if (begin == 50) {
+			throw std::runtime_error("Failed job");
+		}
+	}), std::runtime_error);
+	// Still usable afterwards
+	std::atomic<size_t> total(0);
+	jobs.parallelFor(100, 1, [&total](size_t begin, size_t end) { total += end - begin; });
+	REQUIRE(total == 100);
+}
+
+// Fills scene with balls bouncing around inside walls
+static std::vector<Sphere*> makeBallPit(PhysicsScene& scene)
+{
+	scene.addActor(new Plane({ 0,1 }, -10));
+	scene.addActor(new Plane({ 0,-1 }, -10));
+	scene.addActor(new Plane({ 1,0 }, -10));
+	scene.addActor(new Plane({ -1,0 }, -10));
+	std::vector<Sphere*> balls;
+	for (int x = 0; x < 20; ++x) {
+		for (int y = 0; y < 20; ++y) {
+			glm::vec2 velocity(sinf(x * 1.3f + y) * 5, cosf(x * 0.7f - y) * 5);
+			Sphere* ball = new Sphere({ -9.5f + x, -9.5f + y }, 0.4f, velocity);
+			balls.push_back(ball);
+			scene.addActor(ball);
+		}
+	}
+	return balls;
+}
+
+TEST_CASE("Threaded scene matches single threaded", "[jobs]") {
+	PhysicsScene single(0.01f, { 0,-10 });
+	PhysicsScene threaded(0.01f, { 0,-10 });
+	threaded.setWorkerCount(3);
+	std::vector<Sphere*> singleBalls = makeBallPit(single);
+	std::vector<Sphere*> threadedBalls = makeBallPit(threaded);
+	for (int i = 0; i < 100; ++i) {
+		single.update(0.01f);
+		threaded.update(0.01f);
+	}
+	for (size_t i = 0; i < singleBalls.size(); ++i) {
+		REQUIRE(singleBalls[i]->getPosition() == threadedBalls[i]->getPosition());
+		REQUIRE(singleBalls[i]->getVelocity() == threadedBalls[i]->getVelocity());
+	}
+}
@@ -0,0 +1,163 @@
+#include "catch.hpp"
+
+#include "Narrowphase.h"
+#include "Sphere.h"
+#include "Box.h"
+#include "Plane.h"
+#include "Spring.h"
+
+#include "Utility.h"
+
+using namespace physics;
+
+TEST_CASE("Kernel table", "[narrowphase]") {
+	REQUIRE(Narrowphase::getKernel(sphere, obox) != nullptr);
+	REQUIRE(Narrowphase::getKernel(sphere, obox) == Narrowphase::getKernel(obox, sphere));
+	REQUIRE(Narrowphase::getKernel(plane, plane) == nullptr);
+	REQUIRE(Narrowphase::getKernel(spring, sphere) == nullptr);
+}
+
+TEST_CASE("Kernels match virtual collision tests", "[narrowphase]") {
+	Narrowphase narrowphase;
+	Sphere s1({ 0,0 }, 1, { 0,0 });
+	Sphere s2({ 1.5f,0.5f }, 1, { 0,0 });
+	Box b1({ 0,1.5f }, 2, 2, 0.3f);
+	Box b2({ -1,2.5f }, 2, 2, 0.1f);
+	Plane p({ 0,1 }, 0.5f);
+	Spring spring(1, 1, 0);
+	std::vector<PhysicsObject*> objects = { &s1, &s2, &b1, &b2, &p, &spring };
+
+	std::vector<BroadphasePair> pairs;
+	for (size_t i = 0; i < objects.size(); ++i) {
+		for (size_t j = i + 1; j < objects.size(); ++j) {
+			pairs.push_back(BroadphasePair(objects[i], objects[j], i, j, objects[i]->getShapeID(), objects[j]->getShapeID()));
+		}
+	}
+	CollisionList collisions;
+	narrowphase.findCollisions(pairs, collisions);
+
+	size_t expected = 0;
+	for (const BroadphasePair& pair : pairs) {
+		Collision col = pair.first->checkCollision(pair.second);
+		if (col) {
+			++expected;
+			// Find same collision from kernels
+			auto found = std::find_if(collisions.begin(), collisions.end(), [&col](const Collision& c) {
+				return c.first == col.first && c.second == col.second;
+			});
+			REQUIRE(found != collisions.end());
+			REQUIRE(vectorApprox(found->normal, col.normal, k_margin));
+			REQUIRE(vectorApprox(found->contact, col.contact, k_margin));
+			REQUIRE(found->depth == Approx(col.depth));
+		}
+	}
+	REQUIRE(expected > 0);
+	REQUIRE(collisions.size() == expected);
+}
+
+TEST_CASE("Batched sphere kernels match virtual collision tests", "[narrowphase]") {
+	// Enough spheres to fill several batches of lanes, with some left over
+	std::vector<SpherePtr> spheres;
+	for (int i = 0; i < 21; ++i) {
+		spheres.push_back(SpherePtr(new Sphere({ sinf(i * 1.7f) * 3, cosf(i * 2.3f) * 3 }, 0.5f + 0.1f * (i % 4), { 0,0 })));
+	}
+	std::vector<PlanePtr> planes = { PlanePtr(new Plane({ 0,1 }, 2.5f)), PlanePtr(new Plane({ -1,-1 }, 2)) };
+
+	std::vector<BroadphasePair> pairs;
+	for (size_t i = 0; i < spheres.size(); ++i) {
+		for (size_t j = i + 1; j < spheres.size(); ++j) {
+			pairs.push_back(BroadphasePair(spheres[i].get(), spheres[j].get(), i, j, sphere, sphere));
+		}
+		for (size_t j = 0; j < planes.size(); ++j) {
+			pairs.push_back(BroadphasePair(planes[j].get(), spheres[i].get(), 100 + j, i, plane, sphere));
+		}
+	}
+	Narrowphase narrowphase;
+	CollisionList collisions;
+	narrowphase.findCollisions(pairs, collisions);
+
+	size_t expected = 0;
+	for (const BroadphasePair& pair : pairs) {
+		Collision col = pair.first->checkCollision(pair.second);
+		if (col) {
+			++expected;
+			auto found = std::find_if(collisions.begin(), collisions.end(), [&col](const Collision& c) {
+				return (c.first == col.first && c.second == col.second) || (c.first == col.second && c.second == col.first);
+			});
+			REQUIRE(found != collisions.end());
+			REQUIRE(found->depth == Approx(col.depth));
+		}
+	}
+	REQUIRE(expected > 10);
+	REQUIRE(collisions.size() == expected);
+}
+
+TEST_CASE("Lane rejection", "[narrowphase]") {
+	Narrowphase::SphereLanes spheres = {};
+	Narrowphase::PlaneLanes planes = {};
+	for (size_t i = 0; i < Narrowphase::k_lanes; ++i) {
+		// Every other lane just out of reach
+		float gap = (i % 2 == 0) ? -0.01f : 0.01f;
+		spheres.dx[i] = 3 + gap;
+		spheres.dy[i] = 4;
+		spheres.radii[i] = 5;
+		planes.x[i] = 1;
+		planes.y[i] = 3 + gap;
+		planes.radius[i] = 1;
+		planes.normalY[i] = 1;
+		planes.distance[i] = -2;
+	}
+	REQUIRE(Narrowphase::overlapping(spheres) == 0x55);
+	REQUIRE(Narrowphase::overlapping(planes) == 0x55);
+}
+
+TEST_CASE("Overlap tests", "[narrowphase]") {
+	Sphere sphere({ 0,0 }, 1, { 0,0 });
+	Sphere near({ 1.9f,0 }, 1, { 0,0 });
+	Sphere far({ 2.1f,0 }, 1, { 0,0 });
+	Box box({ 2.4f,0 }, 1, 1, 0, { 0,0 });
+	Box rotated({ 0,2.3f }, 2, 2, glm::quarter_pi<float>(), { 0,0 });
+	Box distant({ 0,2.5f }, 2, 2, glm::quarter_pi<float>(), { 0,0 });
+	Plane plane({ 0,1 }, 0.5f);
+
+	REQUIRE(Narrowphase::overlaps(&sphere, &near));
+	REQUIRE_FALSE(Narrowphase::overlaps(&sphere, &far));
+	// Order of objects doesn't matter
+	REQUIRE(Narrowphase::overlaps(&box, &far));
+	REQUIRE(Narrowphase::overlaps(&far, &box));
+	REQUIRE_FALSE(Narrowphase::overlaps(&sphere, &box));
+	// Corner of rotated box reaches within sqrt(2) of its centre
+	REQUIRE(Narrowphase::overlaps(&rotated, &box) == Narrowphase::overlaps(&box, &rotated));
+	REQUIRE(Narrowphase::overlaps(&sphere, &rotated));
+	REQUIRE_FALSE(Narrowphase::overlaps(&sphere, &distant));
+	REQUIRE(Narrowphase::overlaps(&plane, &sphere));
+	REQUIRE_FALSE(Narrowphase::overlaps(&rotated, &plane));
+	// Overlap tests agree with full tests
+	REQUIRE(Narrowphase::overlaps(&sphere, &near) == (bool)sphere.checkCollision(&near));
+	REQUIRE(Narrowphase::overlaps(&sphere, &distant) == (bool)sphere.checkCollision(&distant));
+}
+
+TEST_CASE("Trigger pairs only tested for overlap", "[narrowphase]") {
+	SpherePtr ball(new Sphere({ 0,0 }, 1, { 0,0 }));
+	BoxPtr pocket(new Box({ 1.5f,0 }, 2, 2, 0, { 0,0 }));
+	SpherePtr other(new Sphere({ -1.5f,0 }, 1, { 0,0 }));
+	pocket->setTrigger(true);
+	std::vector<BroadphasePair> pairs = {
+		BroadphasePair(ball.get(), pocket.get(), 0, 1, sphere, obox),
+		BroadphasePair(ball.get(), other.get(), 0, 2, sphere, sphere)
+	};
+	Narrowphase narrowphase;
+	CollisionList collisions;
+	CollisionList overlaps;
+	narrowphase.findCollisions(pairs, collisions, nullptr, &overlaps);
+	REQUIRE(collisions.size() == 1);
+	REQUIRE(overlaps.size() == 1);
+	REQUIRE(overlaps[0].first == ball.get());
+	REQUIRE(overlaps[0].second == pocket.get());
+	REQUIRE(overlaps[0].depth == 0);
+
+	// Without an overlap list, trigger pairs are tested fully
+	collisions.clear();
+	narrowphase.findCollisions(pairs, collisions);
+	REQUIRE(collisions.size() == 2);
+}
@@ -0,0 +1,97 @@
+#include "catch.hpp"
+
+#include "ObjectPool.h"
+#include "PhysicsScene.h"
+#include "SoftBody.h"
+#include "Sphere.h"
+#include "Box.h"
+#include "Plane.h"
+#include "Spring.h"
+
+using namespace physics;
+
+TEST_CASE("Pool storage reuses blocks", "[pool]") {
+	PoolStorage storage(4);
+	void* a = storage.allocate(24, 8);
+	void* b = storage.allocate(20, 4);
+	REQUIRE(storage.getBlockSize() == 24);
+	REQUIRE((char*)b - (char*)a == 24);
+	REQUIRE(storage.allocate(32, 8) == nullptr);
+	REQUIRE_FALSE(storage.fits(32, 8));
+	REQUIRE(storage.size() == 2);
+	REQUIRE(storage.capacity() == 4);
+
+	// Last freed block is reused first
+	storage.deallocate(a);
+	REQUIRE(storage.size() == 1);
+	REQUIRE(storage.allocate(24, 8) == a);
+
+	// Reserving adds a single chunk big enough for the rest
+	storage.reserve(10);
+	REQUIRE(storage.capacity() == 12);
+	for (int i = 0; i < 10; ++i) {
+		storage.allocate(24, 8);
+	}
+	REQUIRE(storage.capacity() == 12);
+	REQUIRE_THROWS(PoolStorage(0));
+}
+
+TEST_CASE("Pooled objects", "[pool]") {
+	ObjectPools pools;
+	SpherePtr s1 = pools.spheres.create(glm::vec2(0, 0), 1.f, glm::vec2(1, 0));
+	SpherePtr s2 = pools.spheres.create(glm::vec2(3, 0), 1.f, glm::vec2(0, 0));
+	REQUIRE(pools.spheres.size() == 2);
+	REQUIRE(s1->shared_from_this() == s1);
+
+	// Objects of one type are packed together, each sharing its block with its control block
+	size_t blockSize = pools.spheres.getStorage().getBlockSize();
+	REQUIRE(std::abs((char*)s2.get() - (char*)s1.get()) == (ptrdiff_t)blockSize);
+
+	PhysicsObjectPtr copy = s1->poolClone(pools);
+	REQUIRE(pools.spheres.size() == 3);
+	REQUIRE(copy->getShapeID() == ShapeType::sphere);
+	REQUIRE(((Sphere*)copy.get())->getVelocity() == glm::vec2(1, 0));
+	PhysicsObjectPtr plane = Plane({ 0,1 }, 0).poolClone(pools);
+	REQUIRE(pools.planes.size() == 1);
+
+	copy.reset();
+	s2.reset();
+	REQUIRE(pools.spheres.size() == 1);
+	size_t chunkBlocks = PoolStorage::k_def_chunk_blocks;
+	REQUIRE(pools.spheres.capacity() == chunkBlocks);
+}
+
+TEST_CASE("Pooled objects outlive scene", "[pool],[physics scene]") {
+	SpherePtr sphere;
+	{
+		PhysicsScene scene(0.01f, { 0,0 });
+		sphere = scene.getPools().spheres.create(glm::vec2(0, 0), 1.f, glm::vec2(1, 0));
+		scene.addActor(sphere);
+		scene.addActor(scene.getPools().boxes.create(glm::vec2(5, 0), 1.f, 1.f, 0.f, glm::vec2(0, 0)));
+		scene.update(0.01f);
+	}
+	REQUIRE(sphere->getPosition().x == Approx(0.01f));
+	sphere.reset();
+}
+
+TEST_CASE("Soft body from pools", "[pool],[physics scene]") {
+	PhysicsScene scene(0.01f, { 0,-10 });
+	ObjectPools& pools = scene.getPools();
+	Sphere particle({ 0,0 }, 0.4f, { 0,0 });
+	{
+		SoftBody cloth({ 0,0 }, &particle, 10, 8, 1, 10, 5, 2, 0.1f, { 1,1,1,1 }, &pools);
+		// Pools reserved exactly enough, so everything fits in a chunk each
+		REQUIRE(pools.spheres.size() == 80);
+		REQUIRE(pools.spheres.capacity() == 80);
+		REQUIRE(pools.springs.capacity() == pools.springs.size());
+		cloth.addToScene(&scene);
+		scene.update(0.01f);
+		REQUIRE(scene.getActorCount() == 80 + pools.springs.size());
+		cloth.removeFromScene(&scene);
+	}
+	// Everything returns to pools, ready to be reused without allocating
+	REQUIRE(pools.spheres.size() == 0);
+	REQUIRE(pools.springs.size() == 0);
+	SoftBody again({ 0,0 }, &particle, 10, 8, 1, 10, 5, 2, 0.1f, { 1,1,1,1 }, &pools);
+	REQUIRE(pools.spheres.capacity() == 80);
+}
@@ -3,6 +3,10 @@
 #include "PhysicsScene.h"
 #include "Sphere.h"
 #include "Plane.h"
+#include "Box.h"
+#include "Spring.h"
+#include "SoftBody.h"
+#include "ICollisionObserver.h"
 
 using namespace physics;
 //TODO physics scene tests
@@ -64,4 +68,291 @@ TEST_CASE("Removing actors from scene", "[physics scene]") {
 		scene.update(1);
 		REQUIRE_FALSE(scene.inScene(s));
 	}
-}
\ No newline at end of file
+}
+TEST_CASE("Collision filtering", "[physics scene],[collision]") {
+	SpherePtr s1(new Sphere({ 0,0 }, 1, { 0,0 }));
+	SpherePtr s2(new Sphere({ 1,0 }, 1, { 0,0 }));
+	SECTION("Default objects collide") {
+		REQUIRE(PhysicsObject::canCollide(s1.get(), s2.get()));
+	}
+	SECTION("Layers and masks") {
+		s1->setLayers(Layer::fromIndex(3));
+		REQUIRE(PhysicsObject::canCollide(s1.get(), s2.get()));
+		s2->setCollisionMask(Layer::k_all & ~Layer::fromIndex(3));
+		REQUIRE_FALSE(PhysicsObject::canCollide(s1.get(), s2.get()));
+		REQUIRE_FALSE(PhysicsObject::canCollide(s2.get(), s1.get()));
+		REQUIRE_THROWS(Layer::fromIndex(32));
+	}
+	SECTION("Collision groups") {
+		unsigned int group = PhysicsObject::createCollisionGroup();
+		s1->setCollisionGroup(group);
+		REQUIRE(PhysicsObject::canCollide(s1.get(), s2.get()));
+		s2->setCollisionGroup(group);
+		REQUIRE_FALSE(PhysicsObject::canCollide(s1.get(), s2.get()));
+		REQUIRE(group != PhysicsObject::createCollisionGroup());
+	}
+	SECTION("Joined bodies") {
+		SpringPtr spring(new Spring(1, 1, 0, s1, s2));
+		REQUIRE(PhysicsObject::canCollide(s1.get(), s2.get()));
+		spring->setCollideConnected(false);
+		REQUIRE_FALSE(PhysicsObject::canCollide(s1.get(), s2.get()));
+		REQUIRE_FALSE(PhysicsObject::canCollide(s2.get(), s1.get()));
+		spring.reset();
+		REQUIRE(PhysicsObject::canCollide(s1.get(), s2.get()));
+	}
+	SECTION("Filtered pairs aren't resolved") {
+		PhysicsScene scene(0.01f, { 0,0 });
+		s2->setCollisionMask(Layer::k_none);
+		scene.addActor(s1);
+		scene.addActor(s2);
+		scene.update(0.01f);
+		REQUIRE(s1->getVelocity() == glm::vec2(0, 0));
+		REQUIRE(s2->getVelocity() == glm::vec2(0, 0));
+		REQUIRE(scene.getBroadphaseStats().contacts == 0);
+	}
+}
+
+TEST_CASE("Soft body self collision", "[physics scene],[collision]") {
+	Sphere particle({ 0,0 }, 1, { 0,0 });
+	SoftBody body({ 0,0 }, &particle, 2, 2, 1.5f, 1, 1, 1, 0);
+	RigidBody* p1 = body.getParticles()[0][0].get();
+	RigidBody* p2 = body.getParticles()[1][0].get();
+	REQUIRE(PhysicsObject::canCollide(p1, p2));
+	body.setSelfCollision(false);
+	REQUIRE_FALSE(PhysicsObject::canCollide(p1, p2));
+	body.setSelfCollision(true);
+	REQUIRE(PhysicsObject::canCollide(p1, p2));
+
+	// Groups given to particles afterwards are left alone
+	unsigned int group = PhysicsObject::createCollisionGroup();
+	body.setSelfCollision(false);
+	p1->setCollisionGroup(group);
+	body.setSelfCollision(true);
+	REQUIRE(p1->getCollisionGroup() == group);
+	REQUIRE(p2->getCollisionGroup() == 0);
+}
+
+TEST_CASE("Adding and removing actors in bulk", "[physics scene]") {
+	PhysicsScene scene;
+	SpherePtr s1(new Sphere({ 0,0 }, 1, { 0,0 }));
+	SpherePtr s2(new Sphere({ 3,0 }, 1, { 0,0 }));
+	scene.addActor(s1);
+	// Actors already in scene, and repeats, are only added once
+	REQUIRE(scene.addActors({ s1, s2, s2 }) == 1);
+	REQUIRE(scene.getActorCount() == 2);
+	REQUIRE(scene.removeActors({ s2, s2 }) == 1);
+	REQUIRE_FALSE(scene.inScene(s2));
+	REQUIRE_FALSE(s2->isAlive());
+	REQUIRE(scene.queryPoint({ 3,0 }).empty());
+
+	SECTION("Large soft body") {
+		Sphere particle({ 0,0 }, 0.1f, { 0,0 });
+		SoftBody cloth({ 0,0 }, &particle, 100, 100, 0.5f, 10, 10, 10, 0);
+		cloth.addToScene(&scene);
+		std::vector<PhysicsObjectPtr> actors;
+		cloth.getActors(actors);
+		REQUIRE(scene.getActorCount() == actors.size() + 1);
+		REQUIRE(scene.getBodyStore().size() == 100 * 100 + 1);
+		cloth.removeFromScene(&scene);
+		REQUIRE(scene.getActorCount() == 1);
+		REQUIRE(scene.getBodyStore().size() == 1);
+	}
+}
+
+// Records each contact event it's told about
+class EventRecorder : public ICollisionObserver {
+public:
+	struct Record {
+		ContactEvent event;
+		PhysicsObject* publisher;
+		PhysicsObject* other;
+	};
+
+	std::vector<Record> records;
+
+	virtual void OnCollisionBegin(PhysicsObject* publisher, const Collision& collision) { add(contact_begin, publisher, collision); }
+	virtual void OnCollisionStay(PhysicsObject* publisher, const Collision& collision) { add(contact_stay, publisher, collision); }
+	virtual void OnCollisionEnd(PhysicsObject* publisher, const Collision& collision) { add(contact_end, publisher, collision); }
+
+	size_t count(ContactEvent event) {
+		return std::count_if(records.begin(), records.end(), [event](const Record& r) { return r.event == event; });
+	}
+
+protected:
+	void add(ContactEvent event, PhysicsObject* publisher, const Collision& collision) {
+		REQUIRE(collision.first == publisher);
+		records.push_back({ event, publisher, collision.second });
+	}
+};
+
+// Sphere which pushes itself along in its own fixedUpdate
+class ThrusterSphere : public Sphere {
+public:
+	ThrusterSphere(glm::vec2 position) : Sphere(position, 0.5f, { 0,0 }), updates(0) {}
+
+	size_t updates;
+
+	virtual void fixedUpdate(PhysicsScene* scene) {
+		++updates;
+		applyForce({ 10,0 });
+		Sphere::fixedUpdate(scene);
+	}
+
+	virtual bool hasCustomUpdate() { return true; }
+};
+
+TEST_CASE("Rigidbodies with their own fixed update", "[physics scene]") {
+	PhysicsScene scene(0.01f, { 0,0 });
+	// Enough plain spheres to share a block of SIMD lanes with the custom one
+	std::vector<Sphere*> plain;
+	for (int i = 0; i < 6; ++i) {
+		plain.push_back(new Sphere({ 2.f * i, 10 }, 0.5f, { 1,0 }));
+		scene.addActor(plain.back());
+	}
+	ThrusterSphere* thruster = new ThrusterSphere({ 0,-10 });
+	scene.addActor(thruster);
+	for (int i = 0; i < 10; ++i) {
+		scene.update(0.01f);
+	}
+	REQUIRE(thruster->updates == 10);
+	// Integrated once per step, and no more
+	REQUIRE(thruster->getVelocity().x == Approx(1.f));
+	REQUIRE(thruster->getPosition().x - thruster->getPastPosition().x == Approx(0.01f));
+	for (Sphere* sphere : plain) {
+		REQUIRE(sphere->getVelocity().x == Approx(1.f));
+		REQUIRE(sphere->getPastPosition().x == Approx(sphere->getPosition().x - 0.01f));
+	}
+}
+
+TEST_CASE("Collision events", "[physics scene],[collision]") {
+	PhysicsScene scene(0.01f, { 0,0 });
+	std::shared_ptr<EventRecorder> recorder(new EventRecorder());
+
+	SECTION("Contact begins, stays and ends") {
+		SpherePtr moving(new Sphere({ 0,0 }, 1, { 2,0 }));
+		SpherePtr still(new Sphere({ 2.5f,0 }, 1, { 0,0 }));
+		still->setStatic(true);
+		moving->addObserver(recorder);
+		still->addObserver(recorder);
+		scene.addActor(moving);
+		scene.addActor(still);
+		for (int i = 0; i < 100; ++i) {
+			scene.update(scene.getTimeStep());
+		}
+		// Both objects hear of each stage once, with the other as collision's second object
+		REQUIRE(recorder->count(contact_begin) == 2);
+		REQUIRE(recorder->count(contact_end) == 2);
+		REQUIRE(recorder->records.front().event == contact_begin);
+		REQUIRE(recorder->records.back().event == contact_end);
+		for (const EventRecorder::Record& record : recorder->records) {
+			REQUIRE(record.other == ((record.publisher == moving.get()) ? still.get() : moving.get()));
+		}
+		// Collision was solved before observers were told
+		REQUIRE(moving->getVelocity().x < 0);
+	}
+
+	SECTION("Sleeping contacts don't end") {
+		scene.setGravity({ 0,-10 });
+		SpherePtr sphere(new Sphere({ 0,1 }, 1, { 0,0 }));
+		sphere->addObserver(recorder);
+		scene.addActor(sphere);
+		scene.addActor(new Plane({ 0,1 }, 0));
+		for (int i = 0; i < 200; ++i) {
+			scene.update(scene.getTimeStep());
+		}
+		REQUIRE_FALSE(sphere->isAwake());
+		REQUIRE(recorder->count(contact_begin) == 1);
+		REQUIRE(recorder->count(contact_stay) > 0);
+		REQUIRE(recorder->count(contact_end) == 0);
+
+		// Waking doesn't start contact again
+		sphere->setAwake(true);
+		scene.update(scene.getTimeStep());
+		REQUIRE(recorder->count(contact_begin) == 1);
+		REQUIRE(recorder->count(contact_end) == 0);
+	}
+
+	SECTION("Dead objects don't end contacts") {
+		SpherePtr s1(new Sphere({ 0,0 }, 1, { 0,0 }));
+		SpherePtr s2(new Sphere({ 1.5f,0 }, 1, { 0,0 }));
+		s1->addObserver(recorder);
+		scene.addActor(s1);
+		scene.addActor(s2);
+		scene.update(scene.getTimeStep());
+		REQUIRE(recorder->count(contact_begin) == 1);
+		scene.removeActor(s2);
+		s2.reset();
+		for (int i = 0; i < 10; ++i) {
+			scene.update(scene.getTimeStep());
+		}
+		REQUIRE(recorder->records.size() == 1);
+	}
+
+	SECTION("Balls enter and leave triggers") {
+		SpherePtr ball(new Sphere({ -3,0 }, 0.5f, { 5,0 }));
+		SpherePtr sensor(new Sphere({ 0,0 }, 1, { 0,0 }));
+		sensor->setStatic(true);
+		sensor->setTrigger(true);
+		sensor->addObserver(recorder);
+		scene.addActor(ball);
+		scene.addActor(sensor);
+		for (int i = 0; i < 40; ++i) {
+			scene.update(scene.getTimeStep());
+			REQUIRE(scene.getContactSolver().findManifold(ball.get(), sensor.get()) == nullptr);
+		}
+		REQUIRE(recorder->count(contact_begin) == 1);
+		REQUIRE(recorder->count(contact_stay) > 0);
+		REQUIRE(recorder->count(contact_end) == 0);
+		for (int i = 0; i < 60; ++i) {
+			scene.update(scene.getTimeStep());
+		}
+		REQUIRE(recorder->count(contact_end) == 1);
+		// Passes straight through
+		REQUIRE(ball->getVelocity() == glm::vec2(5, 0));
+	}
+
+	SECTION("Removed observers aren't told") {
+		SpherePtr s1(new Sphere({ 0,0 }, 1, { 0,0 }));
+		s1->addObserver(recorder);
+		scene.addActor(s1);
+		scene.addActor(new Sphere({ 1.5f,0 }, 1, { 0,0 }));
+		s1->removeObserver(recorder);
+		REQUIRE_FALSE(s1->isSubscribed(recorder));
+		scene.update(scene.getTimeStep());
+		REQUIRE(recorder->records.empty());
+		REQUIRE(s1->getObservers().empty());
+	}
+}
+
+TEST_CASE("Extracting draw records", "[physics scene]") {
+	PhysicsScene scene(0.01f, { 0,0 });
+	scene.addActor(new Sphere({ 0,0 }, 1, { 1,0 }));
+	scene.addActor(new Box({ 5,0 }, 2, 4, 0));
+	scene.addActor(new Spring(1, 1, 0));
+	Sphere* hidden = new Sphere({ -5,0 }, 1, { 0,0 });
+	hidden->setDraw(false);
+	scene.addActor(hidden);
+
+	// Halfway between steps
+	scene.update(0.015f);
+	std::vector<DrawRecord> records;
+	scene.extractDrawRecords(records);
+	// Spring has no ends, so isn't drawn
+	REQUIRE(records.size() == 2);
+	for (const DrawRecord& record : records) {
+		if (record.shape == draw_circle) {
+			REQUIRE(record.position.x == Approx(0.005f));
+			REQUIRE(record.radius == 1);
+		}
+		else {
+			REQUIRE(record.shape == draw_box);
+			REQUIRE(record.position == glm::vec2(5, 0));
+			REQUIRE(record.axisX.x == Approx(1));
+			REQUIRE(record.axisY.y == Approx(2));
+		}
+	}
+
+	// Records are replaced, not added to
+	scene.extractDrawRecords(records);
+	REQUIRE(records.size() == 2);
+}
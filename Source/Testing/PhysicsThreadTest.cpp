@@ -0,0 +1,160 @@
+#include "catch.hpp"
+
+#include "PhysicsThread.h"
+#include "PhysicsScene.h"
+#include "Sphere.h"
+
+#include <stdexcept>
+
+using namespace physics;
+
+TEST_CASE("Interpolating draw snapshots", "[physics thread]") {
+	DrawSnapshot snapshot;
+	DrawRecord record = {};
+	record.shape = draw_box;
+	record.position = { 0,0 };
+	record.axisX = { 1,0 };
+	record.axisY = { 0,1 };
+	snapshot.past.push_back(record);
+	record.position = { 2,0 };
+	record.axisX = { 0,1 };
+	record.axisY = { -1,0 };
+	record.colour = { 1,0,0,1 };
+	snapshot.current.push_back(record);
+
+	std::vector<DrawRecord> records;
+	snapshot.interpolate(0.5f, records);
+	REQUIRE(records.size() == 1);
+	REQUIRE(records[0].shape == draw_box);
+	REQUIRE(records[0].position == glm::vec2(1, 0));
+	REQUIRE(records[0].axisX == glm::vec2(0.5f, 0.5f));
+	REQUIRE(records[0].axisY == glm::vec2(-0.5f, 0.5f));
+	REQUIRE(records[0].colour == glm::vec4(1, 0, 0, 1));
+
+	// Ratio carries on from when snapshot was taken, but never passes current records
+	snapshot.timeRatio = 0.25f;
+	snapshot.timeStep = 0.01f;
+	snapshot.time = DrawSnapshot::Clock::now();
+	REQUIRE(snapshot.timeRatioAt(snapshot.time) == 0.25f);
+	REQUIRE(snapshot.timeRatioAt(snapshot.time + std::chrono::milliseconds(5)) == Approx(0.75f));
+	REQUIRE(snapshot.timeRatioAt(snapshot.time + std::chrono::seconds(1)) == 1);
+}
+
+TEST_CASE("Stepping without a thread", "[physics thread]") {
+	PhysicsScene scene(0.01f, { 0,0 });
+	PhysicsThread thread(&scene);
+	REQUIRE_FALSE(thread.isRunning());
+	REQUIRE(thread.getSnapshot().current.empty());
+
+	// Commands run in order before step
+	std::vector<int> order;
+	thread.post([&order](PhysicsScene* scene) {
+		scene->addActor(new Sphere({ 0,0 }, 1, { 1,0 }));
+		order.push_back(1);
+	});
+	thread.post([&order](PhysicsScene*) { order.push_back(2); });
+	REQUIRE(scene.getActorCount() == 0);
+	thread.step(0.015f);
+	REQUIRE((order == std::vector<int>{ 1, 2 }));
+	REQUIRE(scene.getActorCount() == 1);
+
+	const DrawSnapshot& snapshot = thread.getSnapshot();
+	REQUIRE(snapshot.step == 0);
+	REQUIRE(snapshot.timeRatio == Approx(0.5f));
+	REQUIRE(snapshot.past.size() == 1);
+	REQUIRE(snapshot.past[0].position.x == Approx(0));
+	REQUIRE(snapshot.current[0].position.x == Approx(0.01f));
+
+	// Reading again without a new step gives the same snapshot
+	REQUIRE(&thread.getSnapshot() == &snapshot);
+	thread.step(0.01f);
+	REQUIRE(thread.getSnapshot().step == 1);
+	REQUIRE(thread.getSnapshot().current[0].position.x == Approx(0.02f));
+
+	REQUIRE_THROWS(PhysicsThread(nullptr));
+}
+
+TEST_CASE("Stepping on a thread", "[physics thread]") {
+	PhysicsScene scene(0.01f, { 0,0 });
+	SpherePtr sphere(new Sphere({ 0,0 }, 1, { 0,0 }));
+	scene.addActor(sphere);
+	PhysicsThread thread(&scene);
+	thread.start();
+	REQUIRE(thread.isRunning());
+
+	std::atomic<bool> applied(false);
+	thread.post([&applied, sphere](PhysicsScene*) {
+		sphere->setVelocity({ 1,0 });
+		applied = true;
+	});
+	// Wait for a few snapshots after the command has run
+	size_t firstStep = 0;
+	bool moved = false;
+	for (int i = 0; i < 2000 && !moved; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		const DrawSnapshot& snapshot = thread.getSnapshot();
+		if (!applied || snapshot.current.empty()) {
+			firstStep = snapshot.step + 1;
+			continue;
+		}
+		moved = snapshot.step > firstStep + 2 && snapshot.current[0].position.x > 0;
+	}
+	thread.stop();
+	REQUIRE_FALSE(thread.isRunning());
+	REQUIRE(moved);
+	REQUIRE(sphere->getPosition().x > 0);
+
+	SECTION("Errors stop thread and are rethrown") {
+		std::atomic<bool> thrown(false);
+		thread.post([&thrown](PhysicsScene*) {
+			thrown = true;
+			throw std::runtime_error("Bad command");
+		});
+		// Catch assertions aren't thread safe, so the command only records that it ran
+		std::atomic<bool> ranAfterError(false);
+		thread.post([&ranAfterError](PhysicsScene*) { ranAfterError = true; });
+		thread.start();
+		while (!thrown) {
+			std::this_thread::yield();
+		}
+		REQUIRE_THROWS_AS(thread.stop(), std::runtime_error);
+		REQUIRE_FALSE(thread.isRunning());
+		REQUIRE_FALSE(ranAfterError);
+		// Thread can start again
+		thread.start();
+		thread.stop();
+	}
+}
+
+TEST_CASE("Creating and destroying bodies on both threads", "[physics thread]") {
+	PhysicsScene scene(0.01f, { 0,0 });
+	PhysicsThread thread(&scene);
+	thread.start();
+
+	std::atomic<int> posted(0);
+	for (int i = 0; i < 500; ++i) {
+		// Created here, added and removed there, and destroyed by whichever thread lets go last
+		SpherePtr sphere(new Sphere({ (float)i,0 }, 0.1f, { 0,0 }));
+		thread.post([sphere, &posted](PhysicsScene* scene) {
+			scene->addActor(sphere);
+			scene->addActor(new Sphere({ 0,(float)posted }, 0.1f, { 0,0 }));
+			if (posted % 3 == 0) {
+				scene->removeActor(sphere);
+			}
+			++posted;
+		});
+		if (i % 50 == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+	while (posted < 500) {
+		std::this_thread::yield();
+	}
+	thread.stop();
+
+	REQUIRE(scene.getActorCount() == 1000 - 167);
+	REQUIRE(scene.getBodyStore().size() == 1000 - 167);
+	for (size_t i = 0; i < scene.getBodyStore().size(); ++i) {
+		REQUIRE(scene.getBodyStore().bodies[i]->getSlot() == i);
+	}
+}
@@ -0,0 +1,111 @@
+#include "catch.hpp"
+
+#include "Profiler.h"
+#include "PhysicsScene.h"
+#include "Sphere.h"
+#include "Plane.h"
+
+#include <thread>
+
+using namespace physics;
+
+TEST_CASE("Rolling stats", "[profiler]") {
+	RollingStats stats(4);
+	REQUIRE(stats.count() == 0);
+	REQUIRE(stats.average() == 0);
+	REQUIRE(stats.percentile(50) == 0);
+
+	stats.add(3);
+	stats.add(1);
+	stats.add(2);
+	REQUIRE(stats.count() == 3);
+	REQUIRE(stats.last() == 2);
+	REQUIRE(stats.min() == 1);
+	REQUIRE(stats.max() == 3);
+	REQUIRE(stats.average() == Approx(2));
+	REQUIRE(stats.percentile(0) == 1);
+	REQUIRE(stats.percentile(50) == 2);
+	REQUIRE(stats.percentile(100) == 3);
+
+	// Oldest samples drop out of window
+	stats.add(10);
+	stats.add(20);
+	REQUIRE(stats.count() == 4);
+	REQUIRE(stats.last() == 20);
+	REQUIRE(stats.min() == 1);
+	REQUIRE(stats.max() == 20);
+	REQUIRE(stats.average() == Approx(8.25));
+	REQUIRE(stats.percentile(75) == 10);
+
+	stats.clear();
+	REQUIRE(stats.count() == 0);
+	REQUIRE(stats.max() == 0);
+
+	REQUIRE_THROWS(stats.percentile(101));
+	REQUIRE_THROWS(RollingStats(0));
+}
+
+TEST_CASE("Profiling phases", "[profiler]") {
+	Profiler profiler(8);
+
+	// Frames without steps aren't recorded
+	profiler.beginFrame();
+	profiler.endFrame();
+	REQUIRE(profiler.getFrameCount() == 0);
+
+	profiler.beginFrame();
+	profiler.addCount(counter_sub_steps, 1);
+	profiler.beginPhase(phase_narrowphase);
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	// Starting a phase ends the last one
+	profiler.beginPhase(phase_resolve);
+	profiler.endPhase();
+	profiler.addCount(counter_contacts, 3);
+	profiler.addCount(counter_contacts, 2);
+	profiler.endFrame();
+
+	REQUIRE(profiler.getFrameCount() == 1);
+	REQUIRE(profiler.getPhaseStats(phase_narrowphase).last() >= 0.002);
+	REQUIRE(profiler.getPhaseStats(phase_resolve).last() < profiler.getPhaseStats(phase_narrowphase).last());
+	REQUIRE(profiler.getPhaseStats(phase_updaters).last() == 0);
+	REQUIRE(profiler.getCounterStats(counter_contacts).last() == 5);
+	REQUIRE(profiler.getFrameStats().last() >= profiler.getPhaseStats(phase_narrowphase).last());
+
+	profiler.reset();
+	REQUIRE(profiler.getFrameCount() == 0);
+	REQUIRE(profiler.getCounterStats(counter_contacts).count() == 0);
+
+	REQUIRE(std::string(Profiler::getPhaseName(phase_remove_dead)) == "Remove dead");
+	REQUIRE(std::string(Profiler::getCounterName(counter_sub_steps)) == "Sub-steps");
+}
+
+#ifdef PHYSICS_PROFILE
+TEST_CASE("Profiling scene updates", "[profiler],[physics scene]") {
+	PhysicsScene scene(0.01f, { 0,-10 });
+	scene.addActor(new Plane({ 0,1 }, 0));
+	scene.addActor(new Sphere({ 0,1 }, 1, { 0,0 }));
+	scene.addActor(new Sphere({ 5,5 }, 1, { 0,0 }));
+	Profiler& profiler = scene.getProfiler();
+
+	// Three steps in one frame
+	scene.update(0.035f);
+	REQUIRE(profiler.getFrameCount() == 1);
+	REQUIRE(profiler.getCounterStats(counter_sub_steps).last() == 3);
+	REQUIRE(profiler.getCounterStats(counter_bodies_integrated).last() == 6);
+	REQUIRE(profiler.getCounterStats(counter_pairs_tested).last() > 0);
+	REQUIRE(profiler.getCounterStats(counter_contacts).last() >= 3);
+	double phaseTotal = 0;
+	for (int phase = 0; phase < phase_count; ++phase) {
+		phaseTotal += profiler.getPhaseStats((ProfilePhase)phase).last();
+	}
+	REQUIRE(phaseTotal > 0);
+	REQUIRE(phaseTotal <= profiler.getFrameStats().last());
+
+	// Frame too short to step isn't recorded
+	scene.update(0.001f);
+	REQUIRE(profiler.getFrameCount() == 1);
+	scene.update(0.01f);
+	REQUIRE(profiler.getFrameCount() == 2);
+	REQUIRE(profiler.getCounterStats(counter_sub_steps).percentile(50) == 1);
+}
+#endif
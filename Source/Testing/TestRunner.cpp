@@ -7,6 +7,8 @@ TEST_CASE("Unit Test Works") {
 
 int main(int argc, char* argv[]) {
 	int result = Catch::Session().run(argc, argv);
+#ifdef _WIN32
 	system("pause");
+#endif
 	return result;
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "catch.hpp"
+
+#include "Trace.h"
+#include "PhysicsScene.h"
+#include "Sphere.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace physics;
+
+TEST_CASE("Trace ring buffer", "[trace]") {
+	Tracer tracer(3);
+	// Tracers start disabled, so scopes cost nothing until a trace is wanted
+	REQUIRE_FALSE(tracer.isEnabled());
+	tracer.record("ignored", "test", Tracer::Clock::now(), Tracer::Clock::now());
+	REQUIRE(tracer.size() == 0);
+	tracer.setEnabled(true);
+	Tracer::Clock::time_point start = Tracer::Clock::now();
+	const char* names[] = { "a", "b", "c", "d" };
+	for (int i = 0; i < 4; ++i) {
+		tracer.record(names[i], "test", start + std::chrono::microseconds(i * 10), start + std::chrono::microseconds(i * 10 + 5));
+	}
+
+	// Oldest event is overwritten
+	std::vector<TraceEvent> events = tracer.getEvents();
+	REQUIRE(tracer.size() == 3);
+	REQUIRE(tracer.capacity() == 3);
+	REQUIRE(events.size() == 3);
+	REQUIRE(std::string(events[0].name) == "b");
+	REQUIRE(std::string(events[2].name) == "d");
+	REQUIRE(events[2].start - events[0].start == Approx(20));
+	REQUIRE(events[0].duration == Approx(5));
+	REQUIRE(events[0].thread == Tracer::getThreadNumber());
+
+	// Disabled tracer keeps what it has
+	tracer.setEnabled(false);
+	{
+		TraceScope scope("ignored", "test", tracer);
+	}
+	REQUIRE(tracer.size() == 3);
+
+	tracer.clear();
+	REQUIRE(tracer.getEvents().empty());
+	REQUIRE_THROWS(Tracer(0));
+}
+
+TEST_CASE("Trace scopes", "[trace]") {
+	Tracer tracer(16);
+	tracer.setEnabled(true);
+	unsigned int otherThread = 0;
+	{
+		TraceScope outer("outer", "test", tracer);
+		{
+			TraceScope inner("inner", "test", tracer);
+		}
+		std::thread thread([&tracer, &otherThread]() {
+			TraceScope scope("thread", "test", tracer);
+			otherThread = Tracer::getThreadNumber();
+		});
+		thread.join();
+	}
+
+	// Events are recorded as scopes end, so inner comes first
+	std::vector<TraceEvent> events = tracer.getEvents();
+	REQUIRE(events.size() == 3);
+	REQUIRE(std::string(events[0].name) == "inner");
+	REQUIRE(std::string(events[2].name) == "outer");
+	REQUIRE(events[2].start <= events[0].start);
+	REQUIRE(events[2].start + events[2].duration >= events[0].start + events[0].duration);
+	REQUIRE(events[1].thread == otherThread);
+	REQUIRE(otherThread != Tracer::getThreadNumber());
+}
+
+TEST_CASE("Writing Chrome traces", "[trace]") {
+	Tracer tracer(4);
+	tracer.setEnabled(true);
+	Tracer::Clock::time_point start = Tracer::Clock::now();
+	tracer.record("say \"hi\"", "test", start, start + std::chrono::microseconds(1500));
+	std::ostringstream stream;
+	tracer.writeJson(stream);
+	std::string json = stream.str();
+	REQUIRE(json.find("\"traceEvents\":[") != std::string::npos);
+	REQUIRE(json.find("\"name\":\"say \\\"hi\\\"\"") != std::string::npos);
+	REQUIRE(json.find("\"ph\":\"X\"") != std::string::npos);
+	REQUIRE(json.find("\"dur\":1500.000") != std::string::npos);
+	// Stream's formatting is left as it was
+	stream << 0.5;
+	REQUIRE(stream.str().substr(json.size()) == "0.5");
+}
+
+#if defined(PHYSICS_TRACE) && defined(PHYSICS_PROFILE)
+TEST_CASE("Tracing scene updates", "[trace],[physics scene]") {
+	PhysicsScene scene(0.01f, { 0,-10 });
+	scene.addActor(new Sphere({ 0,0 }, 1, { 0,0 }));
+	Tracer& tracer = Tracer::getInstance();
+	tracer.clear();
+	tracer.setEnabled(true);
+	scene.update(0.025f);
+	tracer.setEnabled(false);
+
+	size_t updates = 0;
+	size_t steps = 0;
+	size_t narrowphases = 0;
+	for (const TraceEvent& event : tracer.getEvents()) {
+		std::string name = event.name;
+		updates += name == "PhysicsScene::update";
+		steps += name == "Step";
+		narrowphases += name == "Narrowphase";
+	}
+	REQUIRE(updates == 1);
+	REQUIRE(steps == 2);
+	REQUIRE(narrowphases == 2);
+}
+#endif
@@ -1,6 +1,6 @@
 #include "Utility.h"
 
-#include "Catch.hpp"
+#include "catch.hpp"
 
 
 bool vectorApprox(glm::vec2 v1, glm::vec2 v2, float margin) {
@@ -5,6 +5,7 @@
 #include <iostream>
 #include "Input.h"
 #include "imgui_glfw3.h"
+#include "FrameScope.h"
 
 namespace aie {
 
@@ -79,6 +80,7 @@ void Application::run(const char* title, int width, int height, bool fullscreen)
 
 		// loop while game is running
 		while (!m_gameOver) {
+			FrameScope frameScope("Frame");
 
 			// update delta time
 			currTime = glfwGetTime();
@@ -107,15 +109,27 @@ void Application::run(const char* title, int width, int height, bool fullscreen)
 			// clear imgui
 			ImGui_NewFrame();
 
-			update(float(deltaTime));
+			{
+				FrameScope scope("Application::update");
+				update(float(deltaTime));
+			}
 
-			draw();
+			{
+				FrameScope scope("Application::draw");
+				draw();
+			}
 
 			// draw IMGUI last
-			ImGui::Render();
+			{
+				FrameScope scope("ImGui::Render");
+				ImGui::Render();
+			}
 
 			//present backbuffer to the monitor
-			glfwSwapBuffers(m_window);
+			{
+				FrameScope scope("glfwSwapBuffers");
+				glfwSwapBuffers(m_window);
+			}
 
 			// should the game exit?
 			m_gameOver = m_gameOver || glfwWindowShouldClose(m_window) == GLFW_TRUE;
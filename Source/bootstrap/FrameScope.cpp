@@ -0,0 +1,25 @@
+#include "FrameScope.h"
+
+namespace aie {
+
+FrameScope::Callback FrameScope::sm_begin = nullptr;
+FrameScope::Callback FrameScope::sm_end = nullptr;
+
+void FrameScope::setCallbacks(Callback begin, Callback end) {
+	sm_begin = begin;
+	sm_end = end;
+}
+
+FrameScope::FrameScope(const char* name)
+	: m_name(name),
+	m_end(sm_begin != nullptr ? sm_end : nullptr) {
+	if (sm_begin != nullptr)
+		sm_begin(m_name);
+}
+
+FrameScope::~FrameScope() {
+	if (m_end != nullptr)
+		m_end(m_name);
+}
+
+} // namespace aie
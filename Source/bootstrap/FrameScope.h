@@ -0,0 +1,34 @@
+#pragma once
+
+namespace aie {
+
+// marks a named part of a frame, such as update or buffer swap, for as long as it is in scope
+// bootstrap doesn't time anything itself: an application installs callbacks to hand scopes to its own profiler
+class FrameScope {
+public:
+
+	// called as a scope begins and ends, with the scope's name, which is a string literal
+	// scopes nest, so each end matches the most recent unended begin on its thread
+	typedef void(*Callback)(const char* name);
+
+	// installs callbacks for all later scopes, or removes them if null
+	static void setCallbacks(Callback begin, Callback end);
+
+	FrameScope(const char* name);
+	~FrameScope();
+
+	FrameScope(const FrameScope& other) = delete;
+	FrameScope& operator=(const FrameScope& other) = delete;
+
+protected:
+
+	const char*		m_name;
+
+	// end callback from when the scope began, so a scope never ends without beginning
+	Callback		m_end;
+
+	static Callback	sm_begin;
+	static Callback	sm_end;
+};
+
+} // namespace aie
@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 #include <iostream>
+#include "FrameScope.h"
 
 namespace aie {
 
@@ -999,6 +1000,7 @@ void Gizmos::draw2D(float screenWidth, float screenHeight) {
 }
 
 void Gizmos::draw2D(const glm::mat4& projection) {
+	FrameScope scope("Gizmos::draw2D");
 	if ( sm_singleton != nullptr && 
 		(sm_singleton->m_2DlineCount > 0 || 
 		 sm_singleton->m_2DtriCount > 0)) {
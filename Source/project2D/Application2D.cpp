@@ -3,6 +3,10 @@
 #include "Font.h"
 #include "Input.h"
 #include "Gizmos.h"
+#include "FrameScope.h"
+#include "Trace.h"
+
+#include <iostream>
 
 #include "Sphere.h"
 #include "Plane.h"
@@ -19,6 +23,29 @@
 
 using namespace physics;
 
+const char* const Application2D::k_trace_path = "trace.json";
+
+#ifdef PHYSICS_TRACE
+// Frame scopes from bootstrap are recorded as trace events. They only nest on the main thread, and never deeply
+static const int k_max_frame_scope_depth = 16;
+static Tracer::Clock::time_point s_frameScopeStarts[k_max_frame_scope_depth];
+static int s_frameScopeDepth = 0;
+
+static void beginFrameScope(const char* /*name*/) {
+	if (s_frameScopeDepth < k_max_frame_scope_depth) {
+		s_frameScopeStarts[s_frameScopeDepth] = Tracer::Clock::now();
+	}
+	++s_frameScopeDepth;
+}
+
+static void endFrameScope(const char* name) {
+	--s_frameScopeDepth;
+	if (s_frameScopeDepth < k_max_frame_scope_depth) {
+		Tracer::getInstance().record(name, "app", s_frameScopeStarts[s_frameScopeDepth], Tracer::Clock::now());
+	}
+}
+#endif
+
 Application2D::Application2D() {
 
 }
@@ -48,11 +75,17 @@ bool Application2D::startup() {
 
 	m_currentDemo = m_titleScreen;
 
+#ifdef PHYSICS_TRACE
+	aie::FrameScope::setCallbacks(beginFrameScope, endFrameScope);
+#endif
+
 	return true;
 }
 
 void Application2D::shutdown() {
 	
+	aie::FrameScope::setCallbacks(nullptr, nullptr);
+
 	delete m_ropeDemo;
 	delete m_ballDemo;
 	delete m_slugDemo;
@@ -105,6 +138,25 @@ void Application2D::update(float deltaTime) {
 		m_currentDemo = m_ropeDemo;
 	}
 
+	// F9 starts tracing, and pressing it again writes recent frames to a trace, to open in chrome://tracing or Perfetto
+	if (input->wasKeyPressed(aie::INPUT_KEY_F9)) {
+		physics::Tracer& tracer = physics::Tracer::getInstance();
+		if (!tracer.isEnabled()) {
+			tracer.clear();
+			tracer.setEnabled(true);
+			std::cout << "Tracing, press F9 again to write trace" << std::endl;
+		}
+		else {
+			tracer.setEnabled(false);
+			if (tracer.dumpJson(k_trace_path)) {
+				std::cout << "Trace written to " << k_trace_path << std::endl;
+			}
+			else {
+				std::cout << "Couldn't write trace to " << k_trace_path << std::endl;
+			}
+		}
+	}
+
 	aie::Gizmos::clear();
 
 	//glm::vec2 mousePos = screenToWorldSpace({(float)input->getMouseX(), (float)input->getMouseY()});
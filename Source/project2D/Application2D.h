@@ -4,6 +4,7 @@
 #include "Renderer2D.h"
 
 #include "PhysicsScene.h"
+#include "GizmoRenderer.h"
 
 class Demo;
 class TitleScreen;
@@ -14,6 +15,7 @@ class RopeBridgeDemo;
 
 class Application2D : public aie::Application {
 public:
+	static const char* const k_trace_path;	// File recent frames are traced to on pressing F9 a second time
 
 	Application2D();
 	virtual ~Application2D();
@@ -39,10 +41,13 @@ public:
 
 	aie::Font* getFont() { return m_font; }
 
+	GizmoRenderer& getGizmoRenderer() { return m_gizmoRenderer; }
+
 protected:
 
 	aie::Renderer2D*	m_2dRenderer;
 	aie::Font*			m_font;
+	GizmoRenderer		m_gizmoRenderer;
 
 	Demo* m_currentDemo;
 
@@ -15,13 +15,19 @@ using namespace physics;
 const float BouncingBallsDemo::k_stick_force_multiplier = 5.f;
 const float BouncingBallsDemo::k_stick_max_force = 200.f;
 
-BouncingBallsDemo::BouncingBallsDemo() : m_scene(new PhysicsScene()), m_cueActive(false), m_gravityOn(true)
+BouncingBallsDemo::BouncingBallsDemo() : m_scene(new PhysicsScene()), m_physicsThread(m_scene), m_cueActive(false), m_gravityOn(true)
 {
 	setup();
 }
 
 BouncingBallsDemo::~BouncingBallsDemo()
 {
+	// Thread must stop stepping scene before it is deleted, and any error it had no longer matters
+	try {
+		m_physicsThread.stop();
+	}
+	catch (...) {
+	}
 	delete m_scene;
 }
 
@@ -40,22 +46,30 @@ void BouncingBallsDemo::update(float deltaTime, Application2D * app)
 		app->setCameraPos({ 0,0 });
 		m_cueActive = false;
 		m_gravityOn = true;
-		m_scene->setGravity({ 0,-10 });
 		// Reset
-		m_scene->clear();
-		setup();
+		m_physicsThread.post([this](PhysicsScene* scene) {
+			scene->setGravity({ 0,-10 });
+			scene->clear();
+			setup();
+		});
 	}
 
 	// G turns gravity on and off
 	if (input->wasKeyPressed(aie::INPUT_KEY_G))
 	{
-		if (m_gravityOn) {
-			m_gravityOn = false;
-			m_scene->setGravity({ 0,0 });
+		m_gravityOn = !m_gravityOn;
+		glm::vec2 gravity = m_gravityOn ? glm::vec2(0, -10) : glm::vec2(0, 0);
+		m_physicsThread.post([gravity](PhysicsScene* scene) { scene->setGravity(gravity); });
+	}
+
+	// T moves physics onto its own thread, and back again
+	if (input->wasKeyPressed(aie::INPUT_KEY_T))
+	{
+		if (m_physicsThread.isRunning()) {
+			m_physicsThread.stop();
 		}
 		else {
-			m_gravityOn = true;
-			m_scene->setGravity({ 0,-10 });
+			m_physicsThread.start();
 		}
 	}
 
@@ -80,7 +94,10 @@ void BouncingBallsDemo::update(float deltaTime, Application2D * app)
 		}
 	}
 
-	m_scene->update(deltaTime);
+	if (!m_physicsThread.isRunning()) {
+		m_physicsThread.step(deltaTime);
+	}
+	app->getGizmoRenderer().drawSnapshot(m_physicsThread.getSnapshot());
 }
 
 void BouncingBallsDemo::draw(Application2D * app)
@@ -128,22 +145,24 @@ void BouncingBallsDemo::shootCue(Application2D * app)
 	glm::vec2 mousePos = { input->getMouseX(), input->getMouseY() };
 
 	glm::vec2 worldCueContact = app->screenToWorldSpace(m_cueContact);
-
-	// Check cue contact against actors
-	for (auto object : m_scene->getActors()) {
-		if (object->isPointInside(worldCueContact)) {
-			RigidBody* body = dynamic_cast<RigidBody*>(object.get());
-			if (body != nullptr) {
-				// Apply force to object
-				glm::vec2 worldCueEnd = app->screenToWorldSpace(mousePos);
-				glm::vec2 displacement = worldCueContact - worldCueEnd;
-				glm::vec2 direction = glm::normalize(displacement);
-				float length = glm::length(displacement);
-				// Determine force to apply from cue
-				float cueForce = std::min(length * k_stick_force_multiplier, k_stick_max_force);
-				body->applyImpulse(direction * cueForce, worldCueContact);
+	glm::vec2 worldCueEnd = app->screenToWorldSpace(mousePos);
+	glm::vec2 displacement = worldCueContact - worldCueEnd;
+	glm::vec2 direction = glm::normalize(displacement);
+	float length = glm::length(displacement);
+	// Determine force to apply from cue
+	float cueForce = std::min(length * k_stick_force_multiplier, k_stick_max_force);
+
+	// Check cue contact against actors where physics runs, as scene may be on another thread
+	m_physicsThread.post([worldCueContact, direction, cueForce](PhysicsScene* scene) {
+		for (auto object : scene->getActors()) {
+			if (object->isPointInside(worldCueContact)) {
+				RigidBody* body = dynamic_cast<RigidBody*>(object.get());
+				if (body != nullptr) {
+					// Apply force to object
+					body->applyImpulse(direction * cueForce, worldCueContact);
+				}
+				break;
 			}
-			break;
 		}
-	}
+	});
 }
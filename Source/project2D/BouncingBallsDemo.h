@@ -1,6 +1,7 @@
 #pragma once
 #include "Demo.h"
 #include "ExternalLibraries.h"
+#include "PhysicsThread.h"
 
 class Application2D;
 
@@ -21,6 +22,7 @@ public:
 
 protected:
 	physics::PhysicsScene* m_scene;
+	physics::PhysicsThread m_physicsThread;		// Steps scene, on its own thread once started
 
 	glm::vec2 m_cueContact;		// Point where cue will strike
 	bool m_cueActive;
@@ -0,0 +1,51 @@
+#include "GizmoRenderer.h"
+
+#include "Gizmos.h"
+
+#include "Sphere.h"
+
+using namespace physics;
+
+const glm::vec4 GizmoRenderer::k_orientation_colour = { 0,0,0,1 };
+
+void GizmoRenderer::drawScene(physics::PhysicsScene * scene)
+{
+	scene->extractDrawRecords(m_records);
+	for (const DrawRecord& record : m_records) {
+		drawRecord(record);
+	}
+}
+
+void GizmoRenderer::drawSnapshot(const physics::DrawSnapshot & snapshot)
+{
+	snapshot.interpolate(snapshot.timeRatioAt(DrawSnapshot::Clock::now()), m_records);
+	for (const DrawRecord& record : m_records) {
+		drawRecord(record);
+	}
+}
+
+void GizmoRenderer::drawRecord(const physics::DrawRecord & record)
+{
+	switch (record.shape) {
+	case draw_circle:
+		aie::Gizmos::add2DCircle(record.position, record.radius, Sphere::k_segments, record.colour);
+		if (record.showLine) {
+			aie::Gizmos::add2DLine(record.position, record.position + record.axisX, k_orientation_colour);
+		}
+		break;
+	case draw_box:
+	{
+		glm::vec2 p1 = record.position - record.axisX - record.axisY;
+		glm::vec2 p2 = record.position + record.axisX - record.axisY;
+		glm::vec2 p3 = record.position + record.axisX + record.axisY;
+		glm::vec2 p4 = record.position - record.axisX + record.axisY;
+
+		aie::Gizmos::add2DTri(p1, p2, p3, record.colour);
+		aie::Gizmos::add2DTri(p1, p3, p4, record.colour);
+		break;
+	}
+	case draw_line:
+		aie::Gizmos::add2DLine(record.position, record.axisX, record.colour);
+		break;
+	}
+}
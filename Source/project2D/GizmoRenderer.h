@@ -0,0 +1,19 @@
+#pragma once
+#include "PhysicsScene.h"
+
+// Draws physics scenes with gizmos, using the draw records they extract
+class GizmoRenderer {
+public:
+	static const glm::vec4 k_orientation_colour;	// Colour of lines showing circles' orientation
+
+	// Adds gizmos for every drawn actor in scene
+	void drawScene(physics::PhysicsScene* scene);
+
+	// Adds gizmos for every record in snapshot, interpolated to the current time
+	void drawSnapshot(const physics::DrawSnapshot& snapshot);
+
+	static void drawRecord(const physics::DrawRecord& record);
+
+private:
+	std::vector<physics::DrawRecord> m_records;		// Kept between frames so extracting doesn't allocate
+};
@@ -103,7 +103,7 @@ void PoolBall::fixedUpdate(physics::PhysicsScene * scene)
 	}
 }
 
-void PoolBall::OnCollision(physics::PhysicsObject * publisher, const physics::Collision & collision)
+void PoolBall::OnCollisionBegin(physics::PhysicsObject * publisher, const physics::Collision & collision)
 {
 	PhysicsObject* other = collision.second;
 	
@@ -51,7 +51,7 @@ public:
 
 	virtual void fixedUpdate(physics::PhysicsScene* scene);
 
-	virtual void OnCollision(physics::PhysicsObject* publisher, const physics::Collision& collision);
+	virtual void OnCollisionBegin(physics::PhysicsObject* publisher, const physics::Collision& collision);
 
 private:
 	int m_number;					// Number of ball, zero being cue
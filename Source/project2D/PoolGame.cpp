@@ -3,6 +3,7 @@
 #include <iostream>
 
 #include "Input.h"
+#include "Gizmos.h"
 
 #include "Plane.h"
 #include "Sphere.h"
@@ -368,6 +369,7 @@ void PoolGame::update(float deltaTime, Application2D* app)
 
 	// Run physics simulation
 	m_scene->update(deltaTime);
+	app->getGizmoRenderer().drawScene(m_scene);
 }
 
 void PoolGame::draw(Application2D * app)
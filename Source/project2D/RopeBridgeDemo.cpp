@@ -101,6 +101,7 @@ void RopeBridgeDemo::update(float deltaTime, Application2D * app)
 	}
 
 	m_scene->update(deltaTime);
+	app->getGizmoRenderer().drawScene(m_scene);
 }
 
 void RopeBridgeDemo::draw(Application2D * app)
@@ -127,7 +128,7 @@ void RopeBridgeDemo::setup()
 
 	m_ropeTightness = k_def_tightness;
 
-	m_suspensionRope = Rope({ -74,20 }, &particle, 20, 6.f, m_ropeTightness, 1.f);
+	m_suspensionRope = Rope({ -74,20 }, &particle, 20, 6.f, m_ropeTightness, 1.f, &m_scene->getPools());
 
 	// Attach rope ends to anchor
 	m_anchorSpring1 = SpringPtr(new Spring(m_ropeTightness, 4.f,1.f));
@@ -1,6 +1,7 @@
 #include "Slug.h"
 
 #include "Input.h"
+#include "Gizmos.h"
 
 #include "Spring.h"
 
@@ -32,10 +33,12 @@ const glm::vec4 Slug::k_head_colour = {0.8f,0,0.8f,1};
 const glm::vec4 Slug::k_eye_colour = { 1,1,1,1 };
 const glm::vec4 Slug::k_pupil_colour = { 0,0,0,1 };
 
-Slug::Slug(glm::vec2 pos) : m_headSprings(), m_relaxed(false), m_won(false)
+Slug::Slug(glm::vec2 pos, physics::ObjectPools* pools) : m_headSprings(), m_relaxed(false), m_won(false)
 {
 	Sphere particle({ 0,0 }, k_particle_radius, { 0,0 },0,k_body_mass,k_elasticity,k_friction,k_body_drag,0.f,k_body_colour, false);
-	m_body = SoftBody(pos, &particle, k_body_cols, k_body_rows, k_particle_distance, k_high_tightness, k_high_tightness * k_shear_multiple, k_high_tightness * k_bend_multiple, k_damping);
+	m_body = SoftBody(pos, &particle, k_body_cols, k_body_rows, k_particle_distance, k_high_tightness, k_high_tightness * k_shear_multiple, k_high_tightness * k_bend_multiple, k_damping, { 1,1,1,1 }, pools);
+	// Springs keep particles apart, so don't test them against each other
+	m_body.setSelfCollision(false);
 	glm::vec2 headPos = { k_particle_distance * (k_body_cols - 1) + k_head_distance,(k_particle_distance * 0.5f * k_body_rows) - k_particle_radius};
 	m_head = SpherePtr(new Sphere(headPos + pos, k_head_radius, { 0,0 }, 0, k_head_mass, k_elasticity, k_friction, k_head_drag, 0.f, k_head_colour, false));
 
@@ -46,17 +49,18 @@ Slug::Slug(glm::vec2 pos) : m_headSprings(), m_relaxed(false), m_won(false)
 		float distance = glm::length(displacement);
 		//TODO
 		SpringPtr spring(new Spring(k_high_tightness, std::max(0.f,distance - k_head_radius - k_particle_radius), k_damping, m_head, bodyPart,direction * k_head_radius, -direction * k_particle_radius));
+		spring->setCollideConnected(false);
 		m_headSprings.push_back(spring);
 	}
 }
 
 void Slug::addToScene(physics::PhysicsScene * scene)
 {
-	m_body.addToScene(scene);
-	scene->addActor(m_head);
-	for (auto s : m_headSprings) {
-		scene->addActor(s);
-	}
+	std::vector<physics::PhysicsObjectPtr> actors;
+	m_body.getActors(actors);
+	actors.push_back(m_head);
+	actors.insert(actors.end(), m_headSprings.begin(), m_headSprings.end());
+	scene->addActors(actors);
 }
 
 void Slug::update(float deltaTime)
@@ -110,7 +114,7 @@ void Slug::fixedUpdate(physics::PhysicsScene * scene)
 
 }
 
-void Slug::OnCollision(PhysicsObject * publisher, const Collision & collision)
+void Slug::OnCollisionBegin(PhysicsObject * publisher, const Collision & collision)
 {
 	if (collision.second->hasTags(SlugDemo::k_goal_tag)) {
 		m_won = true;
@@ -33,7 +33,8 @@ public:
 	static const glm::vec4 k_eye_colour;
 	static const glm::vec4 k_pupil_colour;
 
-	Slug(glm::vec2 pos);
+	// Body particles and springs are made from pools if given
+	Slug(glm::vec2 pos, physics::ObjectPools* pools = nullptr);
 
 	physics::SoftBody& getBody() { return m_body; }
 	physics::SpherePtr getHead() { return m_head; }
@@ -45,7 +46,7 @@ public:
 
 	virtual void fixedUpdate(physics::PhysicsScene* scene);
 
-	virtual void OnCollision(physics::PhysicsObject * publisher, const physics::Collision & collision) override;
+	virtual void OnCollisionBegin(physics::PhysicsObject * publisher, const physics::Collision & collision) override;
 
 	void drawEyes();
 
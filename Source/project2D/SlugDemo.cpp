@@ -41,6 +41,7 @@ void SlugDemo::update(float deltaTime, Application2D * app)
 	m_slug->update(deltaTime);
 
 	m_scene->update(deltaTime);
+	app->getGizmoRenderer().drawScene(m_scene);
 
 	// Draw slug's eyes over its head
 	m_slug->drawEyes();
@@ -58,7 +59,7 @@ void SlugDemo::setup()
 {
 	m_scene->addActor(new Plane({ 0,1 }, 25));
 
-	m_slug = std::make_shared<Slug>(k_slug_start);
+	m_slug = std::make_shared<Slug>(k_slug_start, &m_scene->getPools());
 	m_scene->addUpdater(m_slug);
 	m_slug->addToScene(m_scene);
 	m_slug->getHead()->addObserver(m_slug);